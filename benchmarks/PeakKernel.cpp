@@ -0,0 +1,167 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Times the waveform analysis kernels on a long stereo buffer against the
+// loop the waveform viewer used before them, run through `meson benchmark`.
+// An optional argument sets the length in minutes. Exits with 1 if a kernel
+// disagrees with the scalar one.
+
+#include "Utility/PeakKernel.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+
+    const int s_Channels = 2;
+    const unsigned int s_SampleRate = 44100;
+    const size_t s_BlockSize = 512;
+    const uint32_t s_FramesPerPeak = 256;
+    const int s_Runs = 5;
+
+    // Best of a few runs in milliseconds, the first run also warms the caches
+    double time_best(const std::function<void()>& run)
+    {
+        double best = 0.0;
+
+        for (int i = 0; i < s_Runs; i++)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            run();
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+            if (i == 0 || elapsed.count() < best)
+                best = elapsed.count();
+        }
+
+        return best;
+    }
+
+    // RMS of the down-mix over one bin per pixel of a 1920 pixel wide view,
+    // as cWaveformViewer::UpdateWaveformBitmap computed it
+    std::vector<float> old_viewer_loop(const std::vector<float>& sample, size_t frames)
+    {
+        const float display_width = 1920.0f;
+        const float chunk_size = static_cast<float>(frames) / display_width;
+        const int bins = static_cast<int>(static_cast<float>(frames) / chunk_size);
+
+        std::vector<float> waveform;
+
+        for (int i = 0; i < bins; i++)
+        {
+            double sum = 0.0;
+            const int start = static_cast<int>(i * chunk_size * s_Channels);
+
+            for (int j = 0; j < chunk_size; j++)
+            {
+                const double mono = 0.5f * (sample[start + 2 * j] + sample[start + 2 * j + 1]);
+                sum += mono * mono;
+            }
+
+            waveform.push_back(static_cast<float>(std::pow(sum / chunk_size, 0.5)));
+        }
+
+        return waveform;
+    }
+
+    // Block by block like cAudioAnalyser
+    size_t run_kernel(const SampleHive::cPeakKernel::Implementation& kernel, const std::vector<float>& sample,
+                      size_t frames, std::vector<SampleHive::Peak>& peaks)
+    {
+        std::vector<float> mono(s_BlockSize);
+        size_t count = 0;
+
+        for (size_t frame = 0; frame < frames; frame += s_BlockSize)
+        {
+            const size_t block = std::min(s_BlockSize, frames - frame);
+
+            kernel.Downmix(sample.data() + frame * s_Channels, block, s_Channels, mono.data());
+
+            for (size_t i = 0; i < block; i += s_FramesPerPeak)
+                peaks[count++] = kernel.Reduce(mono.data() + i, std::min<size_t>(s_FramesPerPeak, block - i));
+        }
+
+        return count;
+    }
+
+}
+
+int main(int argc, char* argv[])
+{
+    const int minutes = argc > 1 ? std::max(1, std::atoi(argv[1])) : 10;
+    const size_t frames = static_cast<size_t>(minutes) * 60 * s_SampleRate;
+
+    std::vector<float> sample(frames * s_Channels);
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+
+    for (auto& value : sample)
+        value = noise(generator);
+
+    std::printf("%d minutes of stereo noise, best of %d runs\n", minutes, s_Runs);
+
+    std::vector<float> waveform;
+    const double old_ms = time_best([&]() { waveform = old_viewer_loop(sample, frames); });
+
+    std::printf("%-10s %8.1f ms  %zu RMS bins\n", "old loop", old_ms, waveform.size());
+
+    const std::vector<SampleHive::cPeakKernel::Implementation> kernels = SampleHive::cPeakKernel::GetImplementations();
+    const size_t peak_count = (frames + s_FramesPerPeak - 1) / s_FramesPerPeak;
+
+    std::vector<SampleHive::Peak> reference(peak_count);
+    run_kernel(kernels.back(), sample, frames, reference);
+
+    int result = EXIT_SUCCESS;
+
+    for (const auto& kernel : kernels)
+    {
+        std::vector<SampleHive::Peak> peaks(peak_count);
+        size_t count = 0;
+
+        const double ms = time_best([&]() { count = run_kernel(kernel, sample, frames, peaks); });
+
+        // Min and max have to match exactly, the sums only differ in the
+        // order they are added up in
+        float rms_error = 0.0f;
+        bool matches = count == peak_count;
+
+        for (size_t i = 0; matches && i < count; i++)
+        {
+            matches = peaks[i].Min == reference[i].Min && peaks[i].Max == reference[i].Max;
+            rms_error = std::max(rms_error, std::fabs(peaks[i].RMS - reference[i].RMS));
+        }
+
+        matches = matches && rms_error < 1e-5f;
+
+        std::printf("%-10s %8.1f ms  %zu min/max/RMS peaks, %.1fx the old loop%s\n", kernel.Name, ms, count,
+                    old_ms / ms, matches ? "" : "  MISMATCH");
+
+        if (!matches)
+            result = EXIT_FAILURE;
+    }
+
+    return result;
+}
@@ -19,8 +19,10 @@
  */
 
 #include "App.hpp"
+#include "Database/QueryProfiler.hpp"
 #include "Utility/Paths.hpp"
 #include "Utility/Log.hpp"
+#include "Utility/Trace.hpp"
 
 #include <wx/bitmap.h>
 #include <wx/defs.h>
@@ -40,6 +42,10 @@ cApp::cApp()
 
 cApp::~cApp()
 {
+    SampleHive::cTracer::Get().Stop();
+
+    // Drain the async log queue before the thread pool goes away
+    spdlog::shutdown();
 }
 
 bool cApp::OnInit()
@@ -84,6 +90,8 @@ void cApp::OnInitCmdLine(wxCmdLineParser& parser)
 
     parser.AddSwitch("v", "version", "Shows the application version", 0);
     parser.AddSwitch("r", "reset", "Reset app data", 0);
+    parser.AddSwitch("t", "trace", "Record a Chrome trace of this session", 0);
+    parser.AddSwitch("p", "profile-sql", "Log a profile of every SQL statement run on exit", 0);
     parser.Parse(true);
 }
 
@@ -167,6 +175,12 @@ bool cApp::OnCmdLineParsed(wxCmdLineParser& parser)
         }
     }
 
+    if (parser.Found("trace"))
+        SampleHive::cTracer::Get().Start(static_cast<std::string>(TRACE_FILEPATH));
+
+    if (parser.Found("profile-sql"))
+        cQueryProfiler::Get().Enable();
+
     return true;
 }
 
@@ -0,0 +1,103 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Audio
+
+#include "Audio/AlsaBackend.hpp"
+#include "Utility/Log.hpp"
+
+namespace SampleHive {
+
+    bool cAlsaBackend::Open(unsigned int sampleRate, unsigned int channels)
+    {
+        Close();
+
+        int err = snd_pcm_open(&m_pDevice, "default", SND_PCM_STREAM_PLAYBACK, 0);
+
+        if (err < 0)
+        {
+            SH_LOG_ERROR("Error! Cannot open ALSA device: {}", snd_strerror(err));
+            m_pDevice = nullptr;
+            return false;
+        }
+
+        // Soft resampling lets the device follow the rate of each sample
+        err = snd_pcm_set_params(m_pDevice, SND_PCM_FORMAT_FLOAT, SND_PCM_ACCESS_RW_INTERLEAVED,
+                                 channels, sampleRate, 1, s_LatencyUs);
+
+        if (err < 0)
+        {
+            SH_LOG_ERROR("Error! Cannot configure ALSA device for {} Hz: {}", sampleRate, snd_strerror(err));
+            Close();
+            return false;
+        }
+
+        m_Channels = channels;
+
+        return true;
+    }
+
+    void cAlsaBackend::Close()
+    {
+        if (!m_pDevice)
+            return;
+
+        snd_pcm_drop(m_pDevice);
+        snd_pcm_close(m_pDevice);
+        m_pDevice = nullptr;
+    }
+
+    bool cAlsaBackend::Write(const float* interleaved, size_t frames)
+    {
+        if (!m_pDevice)
+            return false;
+
+        while (frames > 0)
+        {
+            snd_pcm_sframes_t written = snd_pcm_writei(m_pDevice, interleaved, frames);
+
+            if (written < 0)
+            {
+                // Underruns and suspends are recovered from, anything else is
+                // reported and the device reopened by the engine
+                written = snd_pcm_recover(m_pDevice, static_cast<int>(written), 1);
+
+                if (written < 0)
+                {
+                    SH_LOG_ERROR("Error! ALSA write failed: {}", snd_strerror(static_cast<int>(written)));
+                    return false;
+                }
+
+                continue;
+            }
+
+            interleaved += written * m_Channels;
+            frames -= static_cast<size_t>(written);
+        }
+
+        return true;
+    }
+
+    cAlsaBackend::~cAlsaBackend()
+    {
+        Close();
+    }
+
+}
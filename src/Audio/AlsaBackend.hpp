@@ -0,0 +1,53 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Audio/AudioBackend.hpp"
+
+#include <alsa/asoundlib.h>
+
+namespace SampleHive {
+
+    // Plays through the ALSA "default" device, which also covers PulseAudio
+    // and PipeWire through their ALSA plugins
+    class cAlsaBackend : public cAudioBackend
+    {
+        public:
+            ~cAlsaBackend();
+
+        public:
+            // -------------------------------------------------------------------
+            bool Open(unsigned int sampleRate, unsigned int channels) override;
+            void Close() override;
+            bool Write(const float* interleaved, size_t frames) override;
+
+            const char* GetName() const override { return "alsa"; }
+
+        private:
+            // -------------------------------------------------------------------
+            // Requested device buffer, short enough that clicks sound instant
+            static const unsigned int s_LatencyUs = 20000;
+
+            snd_pcm_t* m_pDevice = nullptr;
+            unsigned int m_Channels = 0;
+    };
+
+}
@@ -0,0 +1,108 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Audio
+
+#include "Audio/AudioBackend.hpp"
+#include "Utility/Log.hpp"
+
+#include "SampleHiveConfig.hpp"
+
+#ifdef USE_ALSA
+    #include "Audio/AlsaBackend.hpp"
+#endif
+
+#include <thread>
+
+namespace SampleHive {
+
+    std::unique_ptr<cAudioBackend> cAudioBackend::Create(const std::string& spec)
+    {
+        if (spec == "null")
+            return std::unique_ptr<cAudioBackend>(new cNullBackend());
+
+        if (spec.compare(0, 4, "wav:") == 0)
+            return std::unique_ptr<cAudioBackend>(new cWavFileBackend(spec.substr(4)));
+
+    #ifdef USE_ALSA
+        if (spec.empty() || spec == "alsa")
+            return std::unique_ptr<cAudioBackend>(new cAlsaBackend());
+    #endif
+
+        if (!spec.empty())
+            SH_LOG_WARN("Audio backend {} is not available, using null", spec);
+
+        return std::unique_ptr<cAudioBackend>(new cNullBackend());
+    }
+
+    // -------------------------------------------------------------------
+    bool cNullBackend::Open(unsigned int sampleRate, unsigned int channels)
+    {
+        m_SampleRate = sampleRate;
+        m_Deadline = std::chrono::steady_clock::now();
+
+        return true;
+    }
+
+    bool cNullBackend::Write(const float* interleaved, size_t frames)
+    {
+        m_Deadline += std::chrono::microseconds(frames * 1000000 / m_SampleRate);
+
+        // Do not try to catch up after the thread was held up for a while
+        const auto now = std::chrono::steady_clock::now();
+
+        if (m_Deadline < now)
+            m_Deadline = now;
+
+        std::this_thread::sleep_until(m_Deadline);
+
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+    bool cWavFileBackend::Open(unsigned int sampleRate, unsigned int channels)
+    {
+        m_File = SndfileHandle(m_Path.c_str(), SFM_WRITE, SF_FORMAT_WAV | SF_FORMAT_FLOAT,
+                               static_cast<int>(channels), static_cast<int>(sampleRate));
+
+        if (!m_File || m_File.error() != SF_ERR_NO_ERROR)
+        {
+            SH_LOG_ERROR("Error! Cannot open {} for writing audio: {}", m_Path, m_File.strError());
+            return false;
+        }
+
+        return cNullBackend::Open(sampleRate, channels);
+    }
+
+    void cWavFileBackend::Close()
+    {
+        // Finishes the header
+        m_File = SndfileHandle();
+    }
+
+    bool cWavFileBackend::Write(const float* interleaved, size_t frames)
+    {
+        if (m_File.writef(interleaved, static_cast<sf_count_t>(frames)) != static_cast<sf_count_t>(frames))
+            return false;
+
+        return cNullBackend::Write(interleaved, frames);
+    }
+
+}
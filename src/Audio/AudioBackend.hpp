@@ -0,0 +1,94 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <sndfile.hh>
+
+namespace SampleHive {
+
+    // Where the audio thread sends its output. Every call is made from the
+    // audio thread, Write blocks until the device has taken the frames,
+    // which is what paces the thread.
+    class cAudioBackend
+    {
+        public:
+            virtual ~cAudioBackend() = default;
+
+        public:
+            // -------------------------------------------------------------------
+            virtual bool Open(unsigned int sampleRate, unsigned int channels) = 0;
+            virtual void Close() = 0;
+            virtual bool Write(const float* interleaved, size_t frames) = 0;
+
+            virtual const char* GetName() const = 0;
+
+        public:
+            // -------------------------------------------------------------------
+            // "alsa", "null" or "wav:<path>", an empty spec picks the first
+            // device backend built in and falls back to null
+            static std::unique_ptr<cAudioBackend> Create(const std::string& spec);
+    };
+
+    // Throws the audio away at the speed it would have been played at, for
+    // machines without a sound card
+    class cNullBackend : public cAudioBackend
+    {
+        public:
+            // -------------------------------------------------------------------
+            bool Open(unsigned int sampleRate, unsigned int channels) override;
+            void Close() override {}
+            bool Write(const float* interleaved, size_t frames) override;
+
+            const char* GetName() const override { return "null"; }
+
+        private:
+            // -------------------------------------------------------------------
+            unsigned int m_SampleRate = 0;
+            std::chrono::steady_clock::time_point m_Deadline;
+    };
+
+    // Records the output to a WAV file in real time, for headless runs. The
+    // file is started over when the output format changes.
+    class cWavFileBackend : public cNullBackend
+    {
+        public:
+            cWavFileBackend(const std::string& path) : m_Path(path) {}
+
+        public:
+            // -------------------------------------------------------------------
+            bool Open(unsigned int sampleRate, unsigned int channels) override;
+            void Close() override;
+            bool Write(const float* interleaved, size_t frames) override;
+
+            const char* GetName() const override { return "wav"; }
+
+        private:
+            // -------------------------------------------------------------------
+            const std::string m_Path;
+            SndfileHandle m_File;
+    };
+
+}
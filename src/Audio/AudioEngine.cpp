@@ -0,0 +1,466 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Audio
+
+#include "Audio/AudioEngine.hpp"
+#include "Utility/Log.hpp"
+
+#include <algorithm>
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace SampleHive {
+
+    cAudioEngine::cAudioEngine(std::unique_ptr<cAudioBackend> backend)
+        : m_pBackend(std::move(backend)), m_Commands(64),
+          m_CommandsDone(0), m_Volume(1.0f), m_bLooping(false), m_bQuit(false),
+          m_StateSequence(0), m_StatePosition(0), m_StateLength(0), m_bStatePlaying(false)
+    {
+        SH_LOG_INFO("Using {} audio backend", m_pBackend->GetName());
+
+        m_Buffer.resize(s_PeriodFrames * s_OutputChannels);
+        m_Thread = std::thread(&cAudioEngine::Run, this);
+
+        // Without the privilege this stays a normal thread, which is still
+        // fine for previews
+        sched_param param;
+        param.sched_priority = std::max(1, sched_get_priority_min(SCHED_FIFO));
+
+        if (pthread_setschedparam(m_Thread.native_handle(), SCHED_FIFO, &param) != 0)
+            SH_LOG_DEBUG("Audio thread runs without realtime priority");
+    }
+
+    bool cAudioEngine::Load(const std::string& path)
+    {
+        m_PendingPath.clear();
+
+        std::shared_ptr<const DecodedSample> sample;
+
+        switch (m_SampleCache.Get(path, sample))
+        {
+            case cSampleCache::eStatus::Ready:
+                return SetSample(std::move(sample));
+            case cSampleCache::eStatus::Failed:
+                return false;
+            case cSampleCache::eStatus::Loading:
+                break;
+        }
+
+        // Whatever plays stops now rather than when the new one is ready
+        Stop();
+
+        m_PendingPath = path;
+        m_bPendingPlay = false;
+        m_PendingSeek = -1;
+        m_PendingLoopStart = 0.0;
+        m_PendingLoopEnd = 0.0;
+
+        return true;
+    }
+
+    void cAudioEngine::Update()
+    {
+        ReleaseRetired();
+
+        if (m_PendingPath.empty())
+            return;
+
+        std::shared_ptr<const DecodedSample> sample;
+
+        switch (m_SampleCache.Get(m_PendingPath, sample))
+        {
+            case cSampleCache::eStatus::Loading:
+                return;
+            case cSampleCache::eStatus::Failed:
+                SH_LOG_ERROR("Error! Cannot decode {}", m_PendingPath);
+                m_PendingPath.clear();
+                m_bPendingPlay = false;
+                return;
+            case cSampleCache::eStatus::Ready:
+                break;
+        }
+
+        m_PendingPath.clear();
+
+        if (!SetSample(std::move(sample)))
+            return;
+
+        if (m_PendingLoopEnd > m_PendingLoopStart)
+            SetLoopRegion(m_PendingLoopStart, m_PendingLoopEnd);
+
+        if (m_PendingSeek >= 0)
+            Seek(m_PendingSeek);
+
+        if (m_bPendingPlay)
+            Play();
+    }
+
+    bool cAudioEngine::SetSample(std::shared_ptr<const DecodedSample> sample)
+    {
+        ReleaseRetired();
+
+        if (!Send({ Command::SetSample, sample.get(), 0, 0 }))
+            return false;
+
+        if (m_pSample)
+            m_Retired.emplace_back(m_CommandsSent, std::move(m_pSample));
+
+        m_pSample = std::move(sample);
+        m_bPlayRequested = false;
+
+        return true;
+    }
+
+    bool cAudioEngine::Play()
+    {
+        if (!m_PendingPath.empty())
+        {
+            m_bPendingPlay = true;
+            return true;
+        }
+
+        if (!m_pSample || !Send({ Command::Play, nullptr, 0, 0 }))
+            return false;
+
+        m_bPlayRequested = true;
+
+        return true;
+    }
+
+    bool cAudioEngine::Stop()
+    {
+        m_bPendingPlay = false;
+
+        if (!Send({ Command::Stop, nullptr, 0, 0 }))
+            return false;
+
+        m_bPlayRequested = false;
+
+        return true;
+    }
+
+    bool cAudioEngine::Seek(int64_t position)
+    {
+        if (!m_PendingPath.empty())
+        {
+            m_PendingSeek = position;
+            return true;
+        }
+
+        if (!m_pSample)
+            return false;
+
+        const uint64_t frame = static_cast<uint64_t>(std::max<int64_t>(position, 0)) * m_pSample->SampleRate / 1000;
+
+        return Send({ Command::Seek, nullptr, std::min(frame, m_pSample->Frames), 0 });
+    }
+
+    bool cAudioEngine::SetLoopRegion(double start, double end)
+    {
+        if (!m_PendingPath.empty())
+        {
+            m_PendingLoopStart = start;
+            m_PendingLoopEnd = end;
+            return true;
+        }
+
+        if (!m_pSample)
+            return false;
+
+        const double rate = m_pSample->SampleRate / 1000.0;
+        const uint64_t start_frame = std::min(static_cast<uint64_t>(std::max(start, 0.0) * rate), m_pSample->Frames);
+        const uint64_t end_frame = std::min(static_cast<uint64_t>(std::max(end, 0.0) * rate), m_pSample->Frames);
+
+        if (end_frame <= start_frame)
+            return ClearLoopRegion();
+
+        return Send({ Command::LoopRegion, nullptr, start_frame, end_frame });
+    }
+
+    bool cAudioEngine::ClearLoopRegion()
+    {
+        if (!m_PendingPath.empty())
+        {
+            m_PendingLoopStart = 0.0;
+            m_PendingLoopEnd = 0.0;
+            return true;
+        }
+
+        return Send({ Command::LoopRegion, nullptr, 0, 0 });
+    }
+
+    bool cAudioEngine::IsPlaying() const
+    {
+        if (!m_PendingPath.empty())
+            return m_bPendingPlay;
+
+        if (m_CommandsDone.load() < m_CommandsSent)
+            return m_bPlayRequested;
+
+        return GetPlaybackState().bPlaying;
+    }
+
+    cAudioEngine::PlaybackState cAudioEngine::GetPlaybackState() const
+    {
+        PlaybackState state;
+        uint32_t sequence;
+
+        do
+        {
+            sequence = m_StateSequence.load(std::memory_order_acquire);
+
+            state.Position = m_StatePosition.load(std::memory_order_relaxed);
+            state.Length = m_StateLength.load(std::memory_order_relaxed);
+            state.bPlaying = m_bStatePlaying.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        while ((sequence & 1) != 0 || sequence != m_StateSequence.load(std::memory_order_relaxed));
+
+        return state;
+    }
+
+    bool cAudioEngine::Send(const Command& command)
+    {
+        if (!m_Commands.Push(command))
+        {
+            SH_LOG_WARN("Audio command queue is full, dropping command");
+            return false;
+        }
+
+        m_CommandsSent++;
+
+        {
+            std::lock_guard<std::mutex> lock(m_WakeMutex);
+        }
+
+        m_Wake.notify_one();
+
+        return true;
+    }
+
+    void cAudioEngine::ReleaseRetired()
+    {
+        const uint64_t done = m_CommandsDone.load();
+
+        // A sample is retired with the count of commands sent up to the one
+        // that replaced it, once that many are done nothing points at it
+        while (!m_Retired.empty() && m_Retired.front().first <= done)
+            m_Retired.pop_front();
+    }
+
+    // -------------------------------------------------------------------
+    void cAudioEngine::Run()
+    {
+        uint64_t idle_frames = 0;
+
+        while (!m_bQuit.load())
+        {
+            ProcessCommands();
+
+            if (!m_bVoicePlaying)
+            {
+                // Silence for a second lets the tail of the sample play out and
+                // spares a reopen when clicking through samples, after that
+                // the device is let go until something plays again
+                if (m_DeviceRate == 0 || idle_frames >= m_DeviceRate)
+                {
+                    if (m_DeviceRate != 0)
+                    {
+                        m_pBackend->Close();
+                        m_DeviceRate = 0;
+                    }
+
+                    WaitForCommand();
+                    continue;
+                }
+
+                idle_frames += s_PeriodFrames;
+            }
+            else
+            {
+                idle_frames = 0;
+
+                // The device follows the rate of the sample, reopening only
+                // happens when a sample of another rate is started
+                unsigned int rate = static_cast<unsigned int>(m_pVoice->SampleRate);
+
+                if (rate == 0)
+                    rate = s_DefaultSampleRate;
+
+                if (rate != m_DeviceRate)
+                {
+                    m_pBackend->Close();
+                    m_DeviceRate = m_pBackend->Open(rate, s_OutputChannels) ? rate : 0;
+
+                    // The backend has said why, the next play tries again
+                    if (m_DeviceRate == 0)
+                    {
+                        m_bVoicePlaying = false;
+                        PublishState();
+                        continue;
+                    }
+                }
+            }
+
+            Render(m_Buffer.data(), s_PeriodFrames);
+
+            if (!m_pBackend->Write(m_Buffer.data(), s_PeriodFrames))
+            {
+                m_pBackend->Close();
+                m_DeviceRate = 0;
+            }
+        }
+
+        m_pBackend->Close();
+    }
+
+    void cAudioEngine::WaitForCommand()
+    {
+        std::unique_lock<std::mutex> lock(m_WakeMutex);
+
+        m_Wake.wait(lock, [this]() { return !m_Commands.IsEmpty() || m_bQuit.load(); });
+    }
+
+    void cAudioEngine::ProcessCommands()
+    {
+        Command command;
+        uint64_t count = 0;
+
+        while (m_Commands.Pop(command))
+        {
+            switch (command.Type)
+            {
+                case Command::SetSample:
+                    m_pVoice = command.Sample;
+                    m_VoicePosition = 0;
+                    m_bVoicePlaying = false;
+                    m_LoopStart = 0;
+                    m_LoopEnd = 0;
+                    break;
+                case Command::Play:
+                    m_bVoicePlaying = m_pVoice != nullptr;
+                    break;
+                case Command::Stop:
+                    m_bVoicePlaying = false;
+                    m_VoicePosition = 0;
+                    break;
+                case Command::Seek:
+                    m_VoicePosition = command.Frame;
+                    break;
+                case Command::LoopRegion:
+                    m_LoopStart = command.Frame;
+                    m_LoopEnd = command.EndFrame;
+                    break;
+            }
+
+            count++;
+        }
+
+        if (count == 0)
+            return;
+
+        PublishState();
+        m_CommandsDone.fetch_add(count);
+    }
+
+    void cAudioEngine::Render(float* out, size_t frames)
+    {
+        size_t i = 0;
+
+        if (m_pVoice && m_bVoicePlaying)
+        {
+            const float gain = m_Volume.load(std::memory_order_relaxed);
+            const bool looping = m_bLooping.load(std::memory_order_relaxed);
+
+            const float* data = m_pVoice->Data.data();
+            const int channels = m_pVoice->Channels;
+            const uint64_t total = m_pVoice->Frames;
+
+            // An A-B region wraps on its own, whatever the loop button says
+            const bool region = m_LoopEnd > m_LoopStart;
+            const uint64_t end = region ? m_LoopEnd : total;
+
+            for (; i < frames; i++)
+            {
+                if (m_VoicePosition >= end)
+                {
+                    if (region)
+                        m_VoicePosition = m_LoopStart;
+                    else if (looping && total > 0)
+                        m_VoicePosition = 0;
+                    else
+                    {
+                        m_bVoicePlaying = false;
+                        break;
+                    }
+                }
+
+                // Mono goes to both sides, anything past stereo is dropped
+                const float* frame = data + m_VoicePosition * channels;
+
+                out[i * 2] = frame[0] * gain;
+                out[i * 2 + 1] = (channels > 1 ? frame[1] : frame[0]) * gain;
+
+                m_VoicePosition++;
+            }
+        }
+
+        std::fill(out + i * s_OutputChannels, out + frames * s_OutputChannels, 0.0f);
+
+        PublishState();
+    }
+
+    void cAudioEngine::PublishState()
+    {
+        int64_t position = 0, length = 0;
+
+        if (m_pVoice && m_pVoice->SampleRate > 0)
+        {
+            position = static_cast<int64_t>(m_VoicePosition * 1000 / m_pVoice->SampleRate);
+            length = static_cast<int64_t>(m_pVoice->Frames * 1000 / m_pVoice->SampleRate);
+        }
+
+        const uint32_t sequence = m_StateSequence.load(std::memory_order_relaxed);
+
+        m_StateSequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        m_StatePosition.store(position, std::memory_order_relaxed);
+        m_StateLength.store(length, std::memory_order_relaxed);
+        m_bStatePlaying.store(m_bVoicePlaying, std::memory_order_relaxed);
+
+        m_StateSequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    cAudioEngine::~cAudioEngine()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_WakeMutex);
+            m_bQuit.store(true);
+        }
+
+        m_Wake.notify_one();
+        m_Thread.join();
+    }
+
+}
@@ -0,0 +1,196 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Audio/AudioBackend.hpp"
+#include "Audio/DecodedSample.hpp"
+#include "Audio/RingBuffer.hpp"
+#include "Audio/SampleCache.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace SampleHive {
+
+    // Plays previews from samples decoded into memory. The UI thread sends
+    // transport commands through a lock free ring, a dedicated audio thread
+    // renders from the decoded frames into the backend and publishes its
+    // position through atomics, so neither side ever waits for the other.
+    // While nothing plays the audio thread lets go of the device and sleeps
+    // until the next command.
+    class cAudioEngine
+    {
+        public:
+            cAudioEngine(std::unique_ptr<cAudioBackend> backend);
+            ~cAudioEngine();
+
+        public:
+            // -------------------------------------------------------------------
+            cAudioEngine(const cAudioEngine&) = delete;
+            cAudioEngine& operator=(const cAudioEngine&) = delete;
+
+        public:
+            // -------------------------------------------------------------------
+            // Make the sample current, stopped at the start. Never waits on
+            // the decode: until the cache has it, the old sample is stopped
+            // and Play, Seek and the loop region are kept for it. False if
+            // the file cannot be decoded.
+            bool Load(const std::string& path);
+
+            // Call now and then on the UI thread while IsPlaying, starts a
+            // sample Load had to leave to the cache once it is decoded
+            void Update();
+
+            bool Play();
+            bool Stop();
+
+            // Positions and lengths are in milliseconds like wxMediaCtrl
+            bool Seek(int64_t position);
+            int64_t Tell() const { return GetPlaybackState().Position; }
+            int64_t Length() const { return GetPlaybackState().Length; }
+
+            // Loop between two positions in milliseconds, converted to frames
+            // so the audio thread jumps back on the exact sample. Loading
+            // another sample clears it.
+            bool SetLoopRegion(double start, double end);
+            bool ClearLoopRegion();
+
+            void SetVolume(double volume) { m_Volume.store(static_cast<float>(volume)); }
+            void SetLooping(bool loop) { m_bLooping.store(loop); }
+
+            // Also true for a play command the audio thread has not taken yet,
+            // or one waiting for its sample to be decoded
+            bool IsPlaying() const;
+
+            // -------------------------------------------------------------------
+            // What the audio thread last played, position and length always
+            // belong to the same sample. Costs a few loads, never waits on the
+            // audio thread, so it is fine to call on every paint.
+            struct PlaybackState
+            {
+                int64_t Position = 0;
+                int64_t Length = 0;
+                bool bPlaying = false;
+            };
+
+            PlaybackState GetPlaybackState() const;
+
+            // Decoded samples behind Load, prefetch through it to make the next Load instant
+            cSampleCache& GetSampleCache() { return m_SampleCache; }
+
+        private:
+            // -------------------------------------------------------------------
+            struct Command
+            {
+                enum eType
+                {
+                    SetSample,
+                    Play,
+                    Stop,
+                    Seek,
+                    LoopRegion
+                };
+
+                eType Type;
+                const DecodedSample* Sample;
+                uint64_t Frame;
+                uint64_t EndFrame;
+            };
+
+            bool Send(const Command& command);
+            void ReleaseRetired();
+            bool SetSample(std::shared_ptr<const DecodedSample> sample);
+
+            // -------------------------------------------------------------------
+            // Audio thread
+            void Run();
+            void WaitForCommand();
+            void ProcessCommands();
+            void Render(float* out, size_t frames);
+            void PublishState();
+
+        private:
+            // -------------------------------------------------------------------
+            static const unsigned int s_OutputChannels = 2;
+            static const size_t s_PeriodFrames = 256;
+            static const unsigned int s_DefaultSampleRate = 44100;
+
+            std::unique_ptr<cAudioBackend> m_pBackend;
+            cRingBuffer<Command> m_Commands;
+            std::thread m_Thread;
+
+            cSampleCache m_SampleCache;
+
+            // -------------------------------------------------------------------
+            // UI thread only. Samples replaced by Load stay alive until the
+            // audio thread has moved past the command that replaced them.
+            std::shared_ptr<const DecodedSample> m_pSample;
+            std::deque<std::pair<uint64_t, std::shared_ptr<const DecodedSample>>> m_Retired;
+            uint64_t m_CommandsSent = 0;
+            bool m_bPlayRequested = false;
+
+            // A Load still being decoded and what was asked of it meanwhile,
+            // a negative seek means none
+            std::string m_PendingPath;
+            bool m_bPendingPlay = false;
+            int64_t m_PendingSeek = -1;
+            double m_PendingLoopStart = 0.0;
+            double m_PendingLoopEnd = 0.0;
+
+            // -------------------------------------------------------------------
+            // Audio thread only
+            const DecodedSample* m_pVoice = nullptr;
+            uint64_t m_VoicePosition = 0;
+            bool m_bVoicePlaying = false;
+            uint64_t m_LoopStart = 0;
+            uint64_t m_LoopEnd = 0;
+            unsigned int m_DeviceRate = 0;
+            std::vector<float> m_Buffer;
+
+            // -------------------------------------------------------------------
+            // Shared
+            std::atomic<uint64_t> m_CommandsDone;
+            std::atomic<float> m_Volume;
+            std::atomic<bool> m_bLooping;
+            std::atomic<bool> m_bQuit;
+
+            // Only taken to wake the audio thread when it sleeps while stopped
+            std::mutex m_WakeMutex;
+            std::condition_variable m_Wake;
+
+            // -------------------------------------------------------------------
+            // Playback state behind a sequence lock, the audio thread makes the
+            // count odd while it writes and readers retry if it moved
+            std::atomic<uint32_t> m_StateSequence;
+            std::atomic<int64_t> m_StatePosition;
+            std::atomic<int64_t> m_StateLength;
+            std::atomic<bool> m_bStatePlaying;
+    };
+
+}
@@ -0,0 +1,62 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Audio
+
+#include "Audio/DecodedSample.hpp"
+#include "Utility/Log.hpp"
+
+#include <algorithm>
+
+#include <sndfile.hh>
+
+namespace SampleHive {
+
+    std::shared_ptr<const DecodedSample> DecodedSample::Load(const std::string& path)
+    {
+        SndfileHandle file(path.c_str());
+
+        if (!file || file.error() != SF_ERR_NO_ERROR || file.channels() <= 0 || file.samplerate() <= 0)
+        {
+            SH_LOG_ERROR("Error! Cannot open {} for playback", path);
+            return nullptr;
+        }
+
+        auto sample = std::make_shared<DecodedSample>();
+        sample->Channels = file.channels();
+        sample->SampleRate = file.samplerate();
+        sample->Data.resize(static_cast<size_t>(std::max<sf_count_t>(file.frames(), 0)) * sample->Channels);
+
+        const sf_count_t read = file.readf(sample->Data.data(), file.frames());
+
+        if (read < 0 || file.error() != SF_ERR_NO_ERROR)
+        {
+            SH_LOG_ERROR("Error! SNDFILE {}: {}", path, file.strError());
+            return nullptr;
+        }
+
+        // Some formats only know an estimate of their length up front
+        sample->Frames = static_cast<uint64_t>(read);
+        sample->Data.resize(sample->Frames * sample->Channels);
+
+        return sample;
+    }
+
+}
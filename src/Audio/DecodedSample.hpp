@@ -0,0 +1,43 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SampleHive {
+
+    // A whole sample decoded to interleaved floats, ready to be played
+    // without touching the file again
+    struct DecodedSample
+    {
+        int Channels = 0;
+        int SampleRate = 0;
+        uint64_t Frames = 0;
+        std::vector<float> Data;
+
+        // Returns nullptr if libsndfile cannot decode the file
+        static std::shared_ptr<const DecodedSample> Load(const std::string& path);
+    };
+
+}
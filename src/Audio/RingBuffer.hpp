@@ -0,0 +1,102 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace SampleHive {
+
+    // Lock free queue for exactly one producer and one consumer thread. Push
+    // and Pop never block or allocate, so the consumer can be the audio
+    // thread. The capacity is rounded up to a power of two.
+    template<typename T>
+    class cRingBuffer
+    {
+        public:
+            cRingBuffer(size_t capacity)
+                : m_Items(round_up(capacity)), m_Mask(m_Items.size() - 1), m_Head(0), m_Tail(0) {}
+
+        public:
+            // -------------------------------------------------------------------
+            cRingBuffer(const cRingBuffer&) = delete;
+            cRingBuffer& operator=(const cRingBuffer&) = delete;
+
+        public:
+            // -------------------------------------------------------------------
+            // Producer side, returns false if the buffer is full
+            bool Push(const T& item)
+            {
+                const size_t tail = m_Tail.load(std::memory_order_relaxed);
+
+                if (tail - m_Head.load(std::memory_order_acquire) == m_Items.size())
+                    return false;
+
+                m_Items[tail & m_Mask] = item;
+                m_Tail.store(tail + 1, std::memory_order_release);
+
+                return true;
+            }
+
+            // Consumer side
+            bool IsEmpty() const
+            {
+                return m_Head.load(std::memory_order_relaxed) == m_Tail.load(std::memory_order_acquire);
+            }
+
+            // Consumer side, returns false if the buffer is empty
+            bool Pop(T& item)
+            {
+                const size_t head = m_Head.load(std::memory_order_relaxed);
+
+                if (head == m_Tail.load(std::memory_order_acquire))
+                    return false;
+
+                item = m_Items[head & m_Mask];
+                m_Head.store(head + 1, std::memory_order_release);
+
+                return true;
+            }
+
+        private:
+            // -------------------------------------------------------------------
+            static size_t round_up(size_t capacity)
+            {
+                size_t size = 1;
+
+                while (size < capacity)
+                    size <<= 1;
+
+                return size;
+            }
+
+        private:
+            // -------------------------------------------------------------------
+            std::vector<T> m_Items;
+            const size_t m_Mask;
+
+            // Written by one side each, kept on separate cache lines
+            alignas(64) std::atomic<size_t> m_Head;
+            alignas(64) std::atomic<size_t> m_Tail;
+    };
+
+}
@@ -0,0 +1,276 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Audio
+
+#include "Audio/SampleCache.hpp"
+#include "Utility/Log.hpp"
+
+#include <sys/stat.h>
+
+namespace {
+
+    bool stat_file(const std::string& path, uint64_t& size, int64_t& mtime)
+    {
+        struct stat info;
+
+        if (stat(path.c_str(), &info) != 0)
+            return false;
+
+        size = static_cast<uint64_t>(info.st_size);
+        mtime = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+
+        return true;
+    }
+
+}
+
+namespace SampleHive {
+
+    cSampleCache::cSampleCache(size_t capacity)
+        : m_Capacity(capacity), m_Hits(0), m_Misses(0)
+    {
+        m_Thread = std::thread(&cSampleCache::Run, this);
+    }
+
+    cSampleCache::eStatus cSampleCache::Get(const std::string& path, std::shared_ptr<const DecodedSample>& sample)
+    {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+
+        if (!stat_file(path, size, mtime))
+        {
+            m_Misses++;
+            return eStatus::Failed;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            // Only a sample that plays without waiting counts as a hit
+            const bool waited = m_Waiting == path;
+
+            if (m_Decoded.first == path)
+            {
+                sample = std::move(m_Decoded.second);
+                m_Decoded.first.clear();
+                m_Waiting.clear();
+
+                return eStatus::Ready;
+            }
+
+            if ((sample = Find(path, size, mtime)))
+            {
+                if (waited)
+                    m_Waiting.clear();
+                else
+                    m_Hits++;
+
+                return eStatus::Ready;
+            }
+
+            auto failed = m_Failed.find(path);
+
+            if (failed != m_Failed.end() && failed->second == std::make_pair(size, mtime))
+            {
+                if (waited)
+                    m_Waiting.clear();
+                else
+                    m_Misses++;
+
+                return eStatus::Failed;
+            }
+
+            if (!waited)
+            {
+                m_Misses++;
+                m_Waiting = path;
+                m_Decoded = {};
+            }
+
+            // The prefetcher may be on it already
+            if (m_Loading.count(path) > 0 || m_Requested == path)
+                return eStatus::Loading;
+
+            m_Requested = path;
+        }
+
+        m_Condition.notify_all();
+
+        return eStatus::Loading;
+    }
+
+    void cSampleCache::Prefetch(const std::vector<std::string>& paths)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            m_Pending.assign(paths.begin(), paths.end());
+        }
+
+        m_Condition.notify_all();
+    }
+
+    double cSampleCache::GetHitRate() const
+    {
+        const uint64_t hits = m_Hits.load();
+        const uint64_t total = hits + m_Misses.load();
+
+        return total > 0 ? static_cast<double>(hits) / total : 0.0;
+    }
+
+    size_t cSampleCache::GetSize() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        return m_Bytes;
+    }
+
+    std::shared_ptr<const DecodedSample> cSampleCache::Find(const std::string& path, uint64_t size, int64_t mtime)
+    {
+        auto it = m_Entries.find(path);
+
+        if (it == m_Entries.end())
+            return nullptr;
+
+        // The file changed on disk since it was decoded
+        if (it->second.FileSize != size || it->second.FileTime != mtime)
+        {
+            m_Bytes -= it->second.Bytes;
+            m_Uses.erase(it->second.Use);
+            m_Entries.erase(it);
+
+            return nullptr;
+        }
+
+        m_Uses.splice(m_Uses.begin(), m_Uses, it->second.Use);
+
+        return it->second.Sample;
+    }
+
+    void cSampleCache::Insert(const std::string& path, std::shared_ptr<const DecodedSample> sample,
+                              uint64_t size, int64_t mtime)
+    {
+        const size_t bytes = sizeof(DecodedSample) + sample->Data.capacity() * sizeof(float);
+
+        // Never let one long recording push out everything else
+        if (bytes > m_Capacity)
+            return;
+
+        auto it = m_Entries.find(path);
+
+        if (it != m_Entries.end())
+        {
+            m_Bytes -= it->second.Bytes;
+            m_Uses.erase(it->second.Use);
+            m_Entries.erase(it);
+        }
+
+        m_Uses.push_front(path);
+        m_Entries[path] = { std::move(sample), size, mtime, bytes, m_Uses.begin() };
+        m_Bytes += bytes;
+
+        // Whatever is playing holds its own reference, evicting it is safe
+        while (m_Bytes > m_Capacity)
+        {
+            auto oldest = m_Entries.find(m_Uses.back());
+
+            m_Bytes -= oldest->second.Bytes;
+            m_Entries.erase(oldest);
+            m_Uses.pop_back();
+        }
+    }
+
+    void cSampleCache::Run()
+    {
+        while (true)
+        {
+            std::string path;
+
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+
+                m_Condition.wait(lock, [this] { return m_bStop || !m_Requested.empty() || !m_Pending.empty(); });
+
+                if (m_bStop)
+                    return;
+
+                if (!m_Requested.empty())
+                {
+                    path.swap(m_Requested);
+                }
+                else
+                {
+                    path = std::move(m_Pending.front());
+                    m_Pending.pop_front();
+                }
+            }
+
+            uint64_t size = 0;
+            int64_t mtime = 0;
+
+            if (!stat_file(path, size, mtime))
+                continue;
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+
+                if (Find(path, size, mtime))
+                    continue;
+
+                m_Loading.insert(path);
+            }
+
+            std::shared_ptr<const DecodedSample> sample = DecodedSample::Load(path);
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            m_Loading.erase(path);
+
+            if (!sample)
+            {
+                m_Failed[path] = { size, mtime };
+                continue;
+            }
+
+            m_Failed.erase(path);
+
+            if (m_Waiting == path)
+                m_Decoded = { path, sample };
+
+            Insert(path, std::move(sample), size, mtime);
+        }
+    }
+
+    cSampleCache::~cSampleCache()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_bStop = true;
+        }
+
+        m_Condition.notify_all();
+        m_Thread.join();
+
+        SH_LOG_DEBUG("Sample cache: {} hits, {} misses, {:.1f}% hit rate",
+                     m_Hits.load(), m_Misses.load(), GetHitRate() * 100.0);
+    }
+
+}
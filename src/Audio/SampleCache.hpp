@@ -0,0 +1,137 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Audio/DecodedSample.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace SampleHive {
+
+    // Decoded samples kept in memory up to a byte budget, least recently
+    // played first out. A background thread decodes the samples the UI
+    // expects to be played next, so stepping through a list only waits on
+    // the disk when it outruns the prefetcher. The UI thread never waits on
+    // a decode, a sample it asks for is decoded ahead of the prefetches.
+    class cSampleCache
+    {
+        public:
+            cSampleCache(size_t capacity = s_DefaultCapacity);
+            ~cSampleCache();
+
+        public:
+            // -------------------------------------------------------------------
+            cSampleCache(const cSampleCache&) = delete;
+            cSampleCache& operator=(const cSampleCache&) = delete;
+
+        public:
+            // -------------------------------------------------------------------
+            enum class eStatus
+            {
+                Ready,
+                Loading,
+                Failed
+            };
+
+            // Never waits. A sample not decoded yet is put first in line and
+            // Loading returned, ask again until it is Ready. Failed if the
+            // file cannot be decoded as it is now.
+            eStatus Get(const std::string& path, std::shared_ptr<const DecodedSample>& sample);
+
+            // Replace the pending prefetches, the first path is decoded first
+            void Prefetch(const std::vector<std::string>& paths);
+
+            // -------------------------------------------------------------------
+            uint64_t GetHits() const { return m_Hits.load(); }
+            uint64_t GetMisses() const { return m_Misses.load(); }
+            double GetHitRate() const;
+
+            size_t GetSize() const;
+            size_t GetCapacity() const { return m_Capacity; }
+
+        private:
+            // -------------------------------------------------------------------
+            struct Entry
+            {
+                std::shared_ptr<const DecodedSample> Sample;
+                uint64_t FileSize;
+                int64_t FileTime;
+                size_t Bytes;
+                std::list<std::string>::iterator Use;
+            };
+
+            // Both expect m_Mutex to be held
+            std::shared_ptr<const DecodedSample> Find(const std::string& path, uint64_t size, int64_t mtime);
+            void Insert(const std::string& path, std::shared_ptr<const DecodedSample> sample,
+                        uint64_t size, int64_t mtime);
+
+            void Run();
+
+        private:
+            // -------------------------------------------------------------------
+            static const size_t s_DefaultCapacity = 256 * 1024 * 1024;
+
+            const size_t m_Capacity;
+
+            // -------------------------------------------------------------------
+            mutable std::mutex m_Mutex;
+            std::condition_variable m_Condition;
+
+            // Most recently used at the front
+            std::list<std::string> m_Uses;
+            std::unordered_map<std::string, Entry> m_Entries;
+            size_t m_Bytes = 0;
+
+            std::deque<std::string> m_Pending;
+            std::set<std::string> m_Loading;
+            bool m_bStop = false;
+
+            // Asked for by Get, decoded before any prefetch
+            std::string m_Requested;
+
+            // What Get is waiting on, and that sample once decoded even if it
+            // is too big to be cached
+            std::string m_Waiting;
+            std::pair<std::string, std::shared_ptr<const DecodedSample>> m_Decoded;
+
+            // Size and time of files that could not be decoded
+            std::unordered_map<std::string, std::pair<uint64_t, int64_t>> m_Failed;
+
+            // -------------------------------------------------------------------
+            std::atomic<uint64_t> m_Hits;
+            std::atomic<uint64_t> m_Misses;
+
+            std::thread m_Thread;
+    };
+
+}
@@ -18,12 +18,18 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#define SH_LOG_SUBSYSTEM Database
+
 #include "Database/Database.hpp"
+#include "Database/QueryProfiler.hpp"
+#include "Utility/HiveData.hpp"
 #include "Utility/Log.hpp"
 #include "Utility/Paths.hpp"
 #include "Utility/Serialize.hpp"
+#include "Utility/Trace.hpp"
 #include "Utility/Utils.hpp"
 
+#include <algorithm>
 #include <deque>
 #include <exception>
 #include <sstream>
@@ -66,16 +72,27 @@ void show_modal_dialog_and_log(const std::string &message, const std::string &ti
     msgDialog.ShowModal();
 }
 
+// Text of a column, empty for NULL
+std::string column_string(sqlite3_stmt *stmt, int column)
+{
+    const unsigned char *text = sqlite3_column_text(stmt, column);
+
+    return text ? reinterpret_cast<const char*>(text) : std::string();
+}
+
+// Borrows a prepared statement from the database statement cache and hands
+// it back reset and with its bindings cleared once it goes out of scope.
 class Sqlite3Statement
 {
     public:
-        Sqlite3Statement(sqlite3 *database, const std::string &query)
+        Sqlite3Statement(cDatabase &database, const std::string &query)
+            : stmt(database.GetCachedStatement(query))
         {
-            throw_on_sqlite3_error(sqlite3_prepare_v2(database, query.c_str(), query.size(), &stmt, NULL));
         }
         ~Sqlite3Statement()
         {
-            throw_on_sqlite3_error(sqlite3_finalize(stmt));
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
         }
 
         sqlite3_stmt* stmt = nullptr;
@@ -96,27 +113,60 @@ cDatabase::~cDatabase()
     CloseDatabase();
 }
 
+sqlite3_stmt* cDatabase::GetCachedStatement(const std::string &query)
+{
+    auto it = m_StatementCache.find(query);
+
+    if (it != m_StatementCache.end())
+    {
+        m_StatementCacheHits++;
+        return it->second;
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+
+    throw_on_sqlite3_error(sqlite3_prepare_v3(m_pDatabase, query.c_str(), query.size(),
+                                              SQLITE_PREPARE_PERSISTENT, &stmt, NULL));
+
+    m_StatementCacheMisses++;
+    m_StatementCache[query] = stmt;
+
+    return stmt;
+}
+
+void cDatabase::FinalizeCachedStatements()
+{
+    for (auto& statement : m_StatementCache)
+        sqlite3_finalize(statement.second);
+
+    m_StatementCache.clear();
+}
+
+// Shared by table creation and the migration of pre-id databases
+static const char* s_SamplesTable = "CREATE TABLE IF NOT EXISTS SAMPLES("
+                                    "ID             INTEGER PRIMARY KEY,"
+                                    "FAVORITE       INT     NOT NULL,"
+                                    "FILENAME       TEXT    NOT NULL,"
+                                    "EXTENSION      TEXT    NOT NULL,"
+                                    "SAMPLEPACK     TEXT    NOT NULL,"
+                                    "TYPE           TEXT    NOT NULL,"
+                                    "CHANNELS       INT     NOT NULL,"
+                                    "BPM            INT     NOT NULL,"
+                                    "LENGTH         INT     NOT NULL,"
+                                    "SAMPLERATE     INT     NOT NULL,"
+                                    "BITRATE        INT     NOT NULL,"
+                                    "PATH           TEXT    NOT NULL,"
+                                    "TRASHED        INT     NOT NULL,"
+                                    "HIVE           TEXT    NOT NULL,"
+                                    "FINGERPRINT    INT     NOT NULL DEFAULT 0);";
+
 void cDatabase::CreateTableSamples()
 {
-    /* Create SQL statement */
-    const auto samples = "CREATE TABLE IF NOT EXISTS SAMPLES("
-                         "FAVORITE       INT     NOT NULL,"
-                         "FILENAME       TEXT    NOT NULL,"
-                         "EXTENSION      TEXT    NOT NULL,"
-                         "SAMPLEPACK     TEXT    NOT NULL,"
-                         "TYPE           TEXT    NOT NULL,"
-                         "CHANNELS       INT     NOT NULL,"
-                         "BPM            INT     NOT NULL,"
-                         "LENGTH         INT     NOT NULL,"
-                         "SAMPLERATE     INT     NOT NULL,"
-                         "BITRATE        INT     NOT NULL,"
-                         "PATH           TEXT    NOT NULL,"
-                         "TRASHED        INT     NOT NULL,"
-                         "HIVE           TEXT    NOT NULL);";
+    MigrateTableSamples();
 
     try
     {
-        throw_on_sqlite3_error(sqlite3_exec(m_pDatabase, samples, NULL, 0, &m_pErrMsg));
+        throw_on_sqlite3_error(sqlite3_exec(m_pDatabase, s_SamplesTable, NULL, 0, &m_pErrMsg));
         SH_LOG_INFO("SAMPLES table created successfully.");
     }
     catch (const std::exception& e)
@@ -124,16 +174,159 @@ void cDatabase::CreateTableSamples()
         show_modal_dialog_and_log("Error! Cannot create SAMPLES table", "Error", e.what());
     }
 
-    const auto indices = "CREATE INDEX IF NOT EXISTS idx_filename_path ON SAMPLES(FILENAME, PATH);";
+    // PATH identifies a sample on disk, rows are never looked up by their
+    // FILENAME, names repeat across packs. FINGERPRINT groups identical
+    // audio, rows not fingerprinted yet are left out of it.
+    const auto indices = "CREATE UNIQUE INDEX IF NOT EXISTS idx_samples_path ON SAMPLES(PATH);"
+                         "DROP INDEX IF EXISTS idx_samples_filename;"
+                         "CREATE INDEX IF NOT EXISTS idx_samples_fingerprint ON SAMPLES(FINGERPRINT) "
+                         "WHERE FINGERPRINT != 0;";
 
     try
     {
         throw_on_sqlite3_error(sqlite3_exec(m_pDatabase, indices, NULL, 0, &m_pErrMsg));
-        SH_LOG_INFO("FILENAME PATH index created successfully.");
+        SH_LOG_INFO("PATH and FINGERPRINT indices created successfully.");
+    }
+    catch (const std::exception& e)
+    {
+        show_modal_dialog_and_log("Error! Cannot create SAMPLES indices", "Error", e.what());
+    }
+
+    CreateTableSamplesSearch();
+}
+
+void cDatabase::CreateTableSamplesSearch()
+{
+    bool has_search_table = false;
+
+    try
+    {
+        Sqlite3Statement statement(*this, "SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = 'SAMPLES_FTS';");
+
+        if (sqlite3_step(statement.stmt) == SQLITE_ROW)
+            has_search_table = sqlite3_column_int(statement.stmt, 0) > 0;
+    }
+    catch (const std::exception& e)
+    {
+        show_modal_dialog_and_log("Error! Cannot look up SAMPLES_FTS table", "Error", e.what());
+        return;
+    }
+
+    // External content table, the text lives in SAMPLES only and the
+    // triggers keep the index in step with it. Favorite, trash and hive
+    // updates don't touch any indexed column so they skip the index.
+    const auto search = "CREATE VIRTUAL TABLE IF NOT EXISTS SAMPLES_FTS USING fts5("
+                        "FILENAME, SAMPLEPACK, TYPE, PATH, "
+                        "content = 'SAMPLES', content_rowid = 'ID', tokenize = 'trigram');"
+                        "CREATE TRIGGER IF NOT EXISTS samples_fts_insert AFTER INSERT ON SAMPLES BEGIN "
+                        "INSERT INTO SAMPLES_FTS (rowid, FILENAME, SAMPLEPACK, TYPE, PATH) "
+                        "VALUES (new.ID, new.FILENAME, new.SAMPLEPACK, new.TYPE, new.PATH); "
+                        "END;"
+                        "CREATE TRIGGER IF NOT EXISTS samples_fts_delete AFTER DELETE ON SAMPLES BEGIN "
+                        "INSERT INTO SAMPLES_FTS (SAMPLES_FTS, rowid, FILENAME, SAMPLEPACK, TYPE, PATH) "
+                        "VALUES ('delete', old.ID, old.FILENAME, old.SAMPLEPACK, old.TYPE, old.PATH); "
+                        "END;"
+                        "CREATE TRIGGER IF NOT EXISTS samples_fts_update "
+                        "AFTER UPDATE OF FILENAME, SAMPLEPACK, TYPE, PATH ON SAMPLES BEGIN "
+                        "INSERT INTO SAMPLES_FTS (SAMPLES_FTS, rowid, FILENAME, SAMPLEPACK, TYPE, PATH) "
+                        "VALUES ('delete', old.ID, old.FILENAME, old.SAMPLEPACK, old.TYPE, old.PATH); "
+                        "INSERT INTO SAMPLES_FTS (rowid, FILENAME, SAMPLEPACK, TYPE, PATH) "
+                        "VALUES (new.ID, new.FILENAME, new.SAMPLEPACK, new.TYPE, new.PATH); "
+                        "END;";
+
+    try
+    {
+        throw_on_sqlite3_error(sqlite3_exec(m_pDatabase, search, NULL, 0, &m_pErrMsg));
+
+        // Index the samples that were added before the search table existed
+        if (!has_search_table)
+            throw_on_sqlite3_error(sqlite3_exec(m_pDatabase, "INSERT INTO SAMPLES_FTS (SAMPLES_FTS) VALUES ('rebuild');",
+                                                NULL, 0, &m_pErrMsg));
+
+        SH_LOG_INFO("SAMPLES_FTS table created successfully.");
     }
     catch (const std::exception& e)
     {
-        show_modal_dialog_and_log("Error! Cannot create INDEX Filename Path", "Error", e.what());
+        show_modal_dialog_and_log("Error! Cannot create SAMPLES_FTS table", "Error", e.what());
+    }
+}
+
+void cDatabase::MigrateTableSamples()
+{
+    bool has_table = false;
+    bool has_id = false;
+    bool has_fingerprint = false;
+
+    try
+    {
+        Sqlite3Statement statement(*this, "PRAGMA table_info(SAMPLES);");
+
+        while (SQLITE_ROW == sqlite3_step(statement.stmt))
+        {
+            has_table = true;
+
+            const std::string column = column_string(statement.stmt, 1);
+
+            if (column == "ID")
+                has_id = true;
+            else if (column == "FINGERPRINT")
+                has_fingerprint = true;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        show_modal_dialog_and_log("Error! Cannot read SAMPLES table info", "Error", e.what());
+        return;
+    }
+
+    if (!has_table || (has_id && has_fingerprint))
+        return;
+
+    // The existing rows get fingerprinted by the find duplicates job
+    if (has_id)
+    {
+        try
+        {
+            throw_on_sqlite3_error(sqlite3_exec(m_pDatabase, "ALTER TABLE SAMPLES ADD COLUMN "
+                                                "FINGERPRINT INT NOT NULL DEFAULT 0;", NULL, 0, &m_pErrMsg));
+            SH_LOG_INFO("FINGERPRINT column added to SAMPLES table.");
+        }
+        catch (const std::exception& e)
+        {
+            show_modal_dialog_and_log("Error! Cannot add FINGERPRINT column", "Error", e.what());
+        }
+
+        return;
+    }
+
+    SH_LOG_INFO("SAMPLES table has no ID column, migrating..");
+
+    // Rows sharing a path were duplicates to begin with. The unique index is
+    // there before the copy, so INSERT OR IGNORE keeps the first one.
+    const auto columns = "FAVORITE, FILENAME, EXTENSION, SAMPLEPACK, TYPE, CHANNELS, BPM, LENGTH, "
+                         "SAMPLERATE, BITRATE, PATH, TRASHED, HIVE";
+
+    std::stringstream sql;
+    sql << "BEGIN TRANSACTION;"
+        << "ALTER TABLE SAMPLES RENAME TO SAMPLES_OLD;"
+        << s_SamplesTable
+        << "CREATE UNIQUE INDEX idx_samples_path ON SAMPLES(PATH);"
+        << "INSERT OR IGNORE INTO SAMPLES (" << columns << ") "
+        << "SELECT " << columns << " FROM SAMPLES_OLD ORDER BY rowid;"
+        << "DROP TABLE SAMPLES_OLD;"
+        << "COMMIT;";
+
+    try
+    {
+        throw_on_sqlite3_error(sqlite3_exec(m_pDatabase, sql.str().c_str(), NULL, 0, &m_pErrMsg));
+        SH_LOG_INFO("SAMPLES table migrated successfully.");
+    }
+    catch (const std::exception& e)
+    {
+        if (!sqlite3_get_autocommit(m_pDatabase))
+            sqlite3_exec(m_pDatabase, "ROLLBACK", NULL, NULL, NULL);
+
+        show_modal_dialog_and_log("Error! Cannot migrate SAMPLES table", "Error", e.what());
     }
 }
 
@@ -153,61 +346,134 @@ void cDatabase::CreateTableHives()
     }
 }
 
-//Loops through a Sample array and adds them to the database
-void cDatabase::InsertIntoSamples(const std::vector<Sample> &samples)
+void cDatabase::CreateTableMetadata()
 {
+    // Tags and properties as TagLib last read them, valid while the file
+    // still has the same SIZE and MTIME. Used by cMetadataCache.
+    const auto metadata = "CREATE TABLE IF NOT EXISTS METADATA("
+                          "PATH           TEXT    PRIMARY KEY,"
+                          "SIZE           INT     NOT NULL,"
+                          "MTIME          INT     NOT NULL,"
+                          "VALID          INT     NOT NULL,"
+                          "TITLE          TEXT    NOT NULL,"
+                          "ARTIST         TEXT    NOT NULL,"
+                          "ALBUM          TEXT    NOT NULL,"
+                          "GENRE          TEXT    NOT NULL,"
+                          "COMMENT        TEXT    NOT NULL,"
+                          "CHANNELS       INT     NOT NULL,"
+                          "LENGTH         INT     NOT NULL,"
+                          "SAMPLERATE     INT     NOT NULL,"
+                          "BITRATE        INT     NOT NULL) WITHOUT ROWID;";
+
     try
     {
-        const auto sql = "INSERT INTO SAMPLES (FAVORITE, FILENAME, \
-                          EXTENSION, SAMPLEPACK, TYPE, CHANNELS, BPM, LENGTH, \
-                          SAMPLERATE, BITRATE, PATH, TRASHED, HIVE) \
-                          VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
+        throw_on_sqlite3_error(sqlite3_exec(m_pDatabase, metadata, NULL, 0, &m_pErrMsg));
+        SH_LOG_INFO("METADATA table created successfully.");
+    }
+    catch (const std::exception &e)
+    {
+        show_modal_dialog_and_log("Error! Cannot create METADATA table", "Error", e.what());
+    }
+}
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+void cDatabase::CreateTableScanState()
+{
+    // What the last library scan saw, used by cLibraryScanner to report
+    // only the files that were added, modified or removed since
+    const auto scan = "CREATE TABLE IF NOT EXISTS SCAN_FILES("
+                      "PATH           TEXT    PRIMARY KEY,"
+                      "DIRECTORY      TEXT    NOT NULL,"
+                      "SIZE           INT     NOT NULL,"
+                      "MTIME          INT     NOT NULL,"
+                      "INODE          INT     NOT NULL) WITHOUT ROWID;"
+                      "CREATE TABLE IF NOT EXISTS SCAN_DIRECTORIES("
+                      "PATH           TEXT    PRIMARY KEY,"
+                      "PARENT         TEXT    NOT NULL,"
+                      "MTIME          INT     NOT NULL) WITHOUT ROWID;";
 
-        throw_on_sqlite3_error(sqlite3_exec(m_pDatabase, "BEGIN TRANSACTION", NULL, NULL, &m_pErrMsg));
+    try
+    {
+        throw_on_sqlite3_error(sqlite3_exec(m_pDatabase, scan, NULL, 0, &m_pErrMsg));
+        SH_LOG_INFO("SCAN_FILES and SCAN_DIRECTORIES tables created successfully.");
+    }
+    catch (const std::exception &e)
+    {
+        show_modal_dialog_and_log("Error! Cannot create SCAN tables", "Error", e.what());
+    }
+}
 
-        Sample sample;
+//Loops through a Sample array and adds them to the database
+static const char* s_InsertSample = "INSERT OR IGNORE INTO SAMPLES (FAVORITE, FILENAME, \
+                                     EXTENSION, SAMPLEPACK, TYPE, CHANNELS, BPM, LENGTH, \
+                                     SAMPLERATE, BITRATE, PATH, TRASHED, HIVE, FINGERPRINT) \
+                                     VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
+
+const char* cDatabase::GetInsertSampleQuery()
+{
+    return s_InsertSample;
+}
+
+void cDatabase::InsertSamples(sqlite3 *connection, sqlite3_stmt *statement, std::vector<Sample> &samples)
+{
+    try
+    {
+        throw_on_sqlite3_error(sqlite3_exec(connection, "BEGIN TRANSACTION", NULL, NULL, NULL));
 
-        std::string filename;
-        std::string file_extension;
-        std::string sample_pack;
-        std::string type;
-        std::string path;
+        const std::string hive = "Favorites";
 
-        for (unsigned int i = 0; i < samples.size(); i++)
+        for (auto& sample : samples)
         {
-            sample = samples[i];
-
-            filename = sample.GetFilename();
-            file_extension = sample.GetFileExtension();
-            sample_pack = sample.GetSamplePack();
-            type = sample.GetType();
-            path = sample.GetPath();
-
-            std::string hive = "Favorites";
-
-            throw_on_sqlite3_error(sqlite3_bind_int(statement.stmt, 1, sample.GetFavorite()));
-            throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 2, filename.c_str(), filename.size(), SQLITE_STATIC));
-            throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 3, file_extension.c_str(), file_extension.size(), SQLITE_STATIC));
-            throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 4, sample_pack.c_str(), sample_pack.size(), SQLITE_STATIC));
-            throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 5, type.c_str(), type.size(), SQLITE_STATIC));
-            throw_on_sqlite3_error(sqlite3_bind_int(statement.stmt, 6, sample.GetChannels()));
-            throw_on_sqlite3_error(sqlite3_bind_int(statement.stmt, 7, sample.GetBPM()));
-            throw_on_sqlite3_error(sqlite3_bind_int(statement.stmt, 8, sample.GetLength()));
-            throw_on_sqlite3_error(sqlite3_bind_int(statement.stmt, 9, sample.GetSampleRate()));
-            throw_on_sqlite3_error(sqlite3_bind_int(statement.stmt, 10, sample.GetBitrate()));
-            throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 11, path.c_str(), path.size(), SQLITE_STATIC));
-            throw_on_sqlite3_error(sqlite3_bind_int(statement.stmt, 12, sample.GetTrashed()));
-            throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 13, hive.c_str(), hive.size(), SQLITE_STATIC));
-
-            sqlite3_step(statement.stmt);
-
-            throw_on_sqlite3_error(sqlite3_clear_bindings(statement.stmt));
-            throw_on_sqlite3_error(sqlite3_reset(statement.stmt));
+            const std::string filename = sample.GetFilename();
+            const std::string file_extension = sample.GetFileExtension();
+            const std::string sample_pack = sample.GetSamplePack();
+            const std::string type = sample.GetType();
+            const std::string path = sample.GetPath();
+
+            throw_on_sqlite3_error(sqlite3_bind_int(statement, 1, sample.GetFavorite()));
+            throw_on_sqlite3_error(sqlite3_bind_text(statement, 2, filename.c_str(), filename.size(), SQLITE_STATIC));
+            throw_on_sqlite3_error(sqlite3_bind_text(statement, 3, file_extension.c_str(), file_extension.size(), SQLITE_STATIC));
+            throw_on_sqlite3_error(sqlite3_bind_text(statement, 4, sample_pack.c_str(), sample_pack.size(), SQLITE_STATIC));
+            throw_on_sqlite3_error(sqlite3_bind_text(statement, 5, type.c_str(), type.size(), SQLITE_STATIC));
+            throw_on_sqlite3_error(sqlite3_bind_int(statement, 6, sample.GetChannels()));
+            throw_on_sqlite3_error(sqlite3_bind_int(statement, 7, sample.GetBPM()));
+            throw_on_sqlite3_error(sqlite3_bind_int(statement, 8, sample.GetLength()));
+            throw_on_sqlite3_error(sqlite3_bind_int(statement, 9, sample.GetSampleRate()));
+            throw_on_sqlite3_error(sqlite3_bind_int(statement, 10, sample.GetBitrate()));
+            throw_on_sqlite3_error(sqlite3_bind_text(statement, 11, path.c_str(), path.size(), SQLITE_STATIC));
+            throw_on_sqlite3_error(sqlite3_bind_int(statement, 12, sample.GetTrashed()));
+            throw_on_sqlite3_error(sqlite3_bind_text(statement, 13, hive.c_str(), hive.size(), SQLITE_STATIC));
+            throw_on_sqlite3_error(sqlite3_bind_int64(statement, 14, static_cast<sqlite3_int64>(sample.GetFingerprint())));
+
+            // Ignored rows are already in the library and keep an id of -1
+            if (sqlite3_step(statement) == SQLITE_DONE && sqlite3_changes(connection) > 0)
+                sample.SetID(sqlite3_last_insert_rowid(connection));
+
+            throw_on_sqlite3_error(sqlite3_clear_bindings(statement));
+            throw_on_sqlite3_error(sqlite3_reset(statement));
         }
 
-        throw_on_sqlite3_error(sqlite3_exec(m_pDatabase, "END TRANSACTION", NULL, NULL, &m_pErrMsg));
+        throw_on_sqlite3_error(sqlite3_exec(connection, "END TRANSACTION", NULL, NULL, NULL));
+    }
+    catch (const std::exception &e)
+    {
+        // Connections outlive this call, don't leave the transaction open
+        sqlite3_reset(statement);
+        sqlite3_clear_bindings(statement);
+
+        if (!sqlite3_get_autocommit(connection))
+            sqlite3_exec(connection, "ROLLBACK", NULL, NULL, NULL);
+
+        throw;
+    }
+}
+
+void cDatabase::InsertIntoSamples(std::vector<Sample> &samples)
+{
+    try
+    {
+        Sqlite3Statement statement(*this, s_InsertSample);
+
+        InsertSamples(m_pDatabase, statement.stmt, samples);
 
         SH_LOG_INFO("Data inserted successfully into SAMPLES.");
     }
@@ -223,7 +489,7 @@ void cDatabase::InsertIntoHives(const std::string &hiveName)
     {
         const auto sql = "INSERT INTO HIVES(HIVE) VALUES(?);";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
 
         throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, hiveName.c_str(), hiveName.size(), SQLITE_STATIC));
 
@@ -243,18 +509,18 @@ void cDatabase::UpdateHive(const std::string &hiveOldName, const std::string &hi
     {
         const auto sql = "UPDATE HIVES SET HIVE = ? WHERE HIVE = ?;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
 
         throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, hiveNewName.c_str(), hiveNewName.size(), SQLITE_STATIC));
         throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 2, hiveOldName.c_str(), hiveOldName.size(), SQLITE_STATIC));
 
         if (sqlite3_step(statement.stmt) != SQLITE_DONE)
         {
-            SH_LOG_INFO("Updating hive {} to {}", hiveOldName, hiveNewName);
+            SH_LOG_DEBUG("Updating hive {} to {}", hiveOldName, hiveNewName);
         }
         else
         {
-            SH_LOG_INFO("Updated hive successfully.");
+            SH_LOG_TRACE("Updated hive successfully.");
         }
     }
     catch (const std::exception& e)
@@ -263,23 +529,23 @@ void cDatabase::UpdateHive(const std::string &hiveOldName, const std::string &hi
     }
 }
 
-void cDatabase::UpdateHiveName(const std::string &filename, const std::string &hiveName)
+void cDatabase::UpdateHiveName(int64_t id, const std::string &hiveName)
 {
     try
     {
-        const auto sql = "UPDATE SAMPLES SET HIVE = ? WHERE FILENAME = ?;";
+        const auto sql = "UPDATE SAMPLES SET HIVE = ? WHERE ID = ?;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
 
         throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, hiveName.c_str(), hiveName.size(), SQLITE_STATIC));
-        throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 2, filename.c_str(), filename.size(), SQLITE_STATIC));
+        throw_on_sqlite3_error(sqlite3_bind_int64(statement.stmt, 2, id));
 
         if (sqlite3_step(statement.stmt) == SQLITE_ROW)
         {
-            SH_LOG_INFO("Updating hive to {} for {}", hiveName, filename);
+            SH_LOG_DEBUG("Updating hive to {} for {}", hiveName, id);
         }
 
-        SH_LOG_INFO("Updated hive name successfully.");
+        SH_LOG_TRACE("Updated hive name successfully.");
     }
     catch (const std::exception &e)
     {
@@ -287,23 +553,23 @@ void cDatabase::UpdateHiveName(const std::string &filename, const std::string &h
     }
 }
 
-void cDatabase::UpdateFavoriteColumn(const std::string &filename, int value)
+void cDatabase::UpdateFavoriteColumn(int64_t id, int value)
 {
     try
     {
-        const auto sql = "UPDATE SAMPLES SET FAVORITE = ? WHERE FILENAME = ?;";
+        const auto sql = "UPDATE SAMPLES SET FAVORITE = ? WHERE ID = ?;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
 
         throw_on_sqlite3_error(sqlite3_bind_int(statement.stmt, 1, value));
-        throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 2, filename.c_str(), filename.size(), SQLITE_STATIC));
+        throw_on_sqlite3_error(sqlite3_bind_int64(statement.stmt, 2, id));
 
         if (sqlite3_step(statement.stmt) == SQLITE_ROW)
         {
-            SH_LOG_INFO("Updating favorite value of {} to {}", filename, value);
+            SH_LOG_DEBUG("Updating favorite value of {} to {}", id, value);
         }
 
-        SH_LOG_INFO("Updated favorite column successfully.");
+        SH_LOG_TRACE("Updated favorite column successfully.");
     }
     catch (const std::exception &e)
     {
@@ -311,23 +577,23 @@ void cDatabase::UpdateFavoriteColumn(const std::string &filename, int value)
     }
 }
 
-void cDatabase::UpdateSamplePack(const std::string &filename, const std::string &samplePack)
+void cDatabase::UpdateSamplePack(int64_t id, const std::string &samplePack)
 {
     try
     {
-        const auto sql = "UPDATE SAMPLES SET SAMPLEPACK = ? WHERE FILENAME = ?;";
+        const auto sql = "UPDATE SAMPLES SET SAMPLEPACK = ? WHERE ID = ?;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
 
         throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, samplePack.c_str(), samplePack.size(), SQLITE_STATIC));
-        throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 2, filename.c_str(), filename.size(), SQLITE_STATIC));
+        throw_on_sqlite3_error(sqlite3_bind_int64(statement.stmt, 2, id));
 
         if (sqlite3_step(statement.stmt) == SQLITE_ROW)
         {
-            SH_LOG_INFO("Updating sample pack of {} to {}", filename, samplePack);
+            SH_LOG_DEBUG("Updating sample pack of {} to {}", id, samplePack);
         }
 
-        SH_LOG_INFO("Updated sample pack successfully.");
+        SH_LOG_TRACE("Updated sample pack successfully.");
     }
     catch (const std::exception &e)
     {
@@ -335,23 +601,23 @@ void cDatabase::UpdateSamplePack(const std::string &filename, const std::string
     }
 }
 
-void cDatabase::UpdateSampleType(const std::string &filename, const std::string &type)
+void cDatabase::UpdateSampleType(int64_t id, const std::string &type)
 {
     try
     {
-        const auto sql = "UPDATE SAMPLES SET TYPE = ? WHERE FILENAME = ?;";
+        const auto sql = "UPDATE SAMPLES SET TYPE = ? WHERE ID = ?;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
 
         throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, type.c_str(), type.size(), SQLITE_STATIC));
-        throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 2, filename.c_str(), filename.size(), SQLITE_STATIC));
+        throw_on_sqlite3_error(sqlite3_bind_int64(statement.stmt, 2, id));
 
         if (sqlite3_step(statement.stmt) == SQLITE_ROW)
         {
-            SH_LOG_INFO("Updating sample type of {} to {}", filename, type);
+            SH_LOG_DEBUG("Updating sample type of {} to {}", id, type);
         }
 
-        SH_LOG_INFO("Updated sample type successfully.");
+        SH_LOG_TRACE("Updated sample type successfully.");
     }
     catch (const std::exception &e)
     {
@@ -359,26 +625,26 @@ void cDatabase::UpdateSampleType(const std::string &filename, const std::string
     }
 }
 
-std::string cDatabase::GetSampleType(const std::string &filename)
+std::string cDatabase::GetSampleType(int64_t id)
 {
     std::string type;
 
     try
     {
-        const auto sql = "SELECT TYPE FROM SAMPLES WHERE FILENAME = ?;";
+        const auto sql = "SELECT TYPE FROM SAMPLES WHERE ID = ?;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
 
-        throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, filename.c_str(), filename.size(), SQLITE_STATIC));
+        throw_on_sqlite3_error(sqlite3_bind_int64(statement.stmt, 1, id));
 
         if (sqlite3_step(statement.stmt) == SQLITE_ROW)
         {
-            SH_LOG_INFO("Record found, fetching sample type for {}", filename);
+            SH_LOG_TRACE("Record found, fetching sample type for {}", id);
 
             type = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 0)));
         }
 
-        SH_LOG_INFO("Selected sample type from table successfully.");
+        SH_LOG_TRACE("Selected sample type from table successfully.");
     }
     catch (const std::exception &e)
     {
@@ -388,25 +654,25 @@ std::string cDatabase::GetSampleType(const std::string &filename)
     return type;
 }
 
-int cDatabase::GetFavoriteColumnValueByFilename(const std::string &filename)
+int cDatabase::GetFavoriteColumnValueByID(int64_t id)
 {
     int value = 0;
 
     try
     {
-        const auto sql = "SELECT FAVORITE FROM SAMPLES WHERE FILENAME = ?;";
+        const auto sql = "SELECT FAVORITE FROM SAMPLES WHERE ID = ?;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
 
-        throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, filename.c_str(), filename.size(), SQLITE_STATIC));
+        throw_on_sqlite3_error(sqlite3_bind_int64(statement.stmt, 1, id));
 
         if (sqlite3_step(statement.stmt) == SQLITE_ROW)
         {
             value = sqlite3_column_int(statement.stmt, 0);
-            SH_LOG_INFO("Record found, fetching favorite column value for {}", filename);
+            SH_LOG_TRACE("Record found, fetching favorite column value for {}", id);
         }
 
-        SH_LOG_INFO("Selected favorite column from table successfully.");
+        SH_LOG_TRACE("Selected favorite column from table successfully.");
     }
     catch (const std::exception &e)
     {
@@ -416,25 +682,25 @@ int cDatabase::GetFavoriteColumnValueByFilename(const std::string &filename)
     return value;
 }
 
-std::string cDatabase::GetHiveByFilename(const std::string &filename)
+std::string cDatabase::GetHiveByID(int64_t id)
 {
     std::string hive;
 
     try
     {
-        const auto sql = "SELECT HIVE FROM SAMPLES WHERE FILENAME = ?;";
+        const auto sql = "SELECT HIVE FROM SAMPLES WHERE ID = ?;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
 
-        throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, filename.c_str(), filename.size(), SQLITE_STATIC));
+        throw_on_sqlite3_error(sqlite3_bind_int64(statement.stmt, 1, id));
 
         if (sqlite3_step(statement.stmt) == SQLITE_ROW)
         {
             hive = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 0)));
-            SH_LOG_INFO("Record found, fetching hive for {}", filename);
+            SH_LOG_TRACE("Record found, fetching hive for {}", id);
         }
 
-        SH_LOG_INFO("Selected hive from table successfully.");
+        SH_LOG_TRACE("Selected hive from table successfully.");
     }
     catch (const std::exception &e)
     {
@@ -444,22 +710,22 @@ std::string cDatabase::GetHiveByFilename(const std::string &filename)
     return hive;
 }
 
-void cDatabase::RemoveSampleFromDatabase(const std::string &filename)
+void cDatabase::RemoveSampleFromDatabase(int64_t id)
 {
     try
     {
-        const auto sql = "DELETE FROM SAMPLES WHERE FILENAME = ?;";
+        const auto sql = "DELETE FROM SAMPLES WHERE ID = ?;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
 
-        throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, filename.c_str(), filename.size(), SQLITE_STATIC));
+        throw_on_sqlite3_error(sqlite3_bind_int64(statement.stmt, 1, id));
 
         if (sqlite3_step(statement.stmt) == SQLITE_DONE)
         {
-            SH_LOG_INFO("Record found, Deleting {} from table", filename);
+            SH_LOG_TRACE("Record found, Deleting {} from table", id);
         }
 
-        SH_LOG_INFO("Deleted sample from table successfully.");
+        SH_LOG_TRACE("Deleted sample from table successfully.");
     }
     catch (const std::exception &e)
     {
@@ -473,16 +739,16 @@ void cDatabase::RemoveHiveFromDatabase(const std::string &hiveName)
     {
         const auto sql = "DELETE FROM HIVES WHERE HIVE = ?;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
 
         throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, hiveName.c_str(), hiveName.size(), SQLITE_STATIC));
 
         if (sqlite3_step(statement.stmt) == SQLITE_DONE)
         {
-            SH_LOG_INFO("Record found, Deleting hive {} from table", hiveName);
+            SH_LOG_TRACE("Record found, Deleting hive {} from table", hiveName);
         }
 
-        SH_LOG_INFO("Deleted hive from table successfully.");
+        SH_LOG_TRACE("Deleted hive from table successfully.");
     }
     catch (const std::exception &e)
     {
@@ -496,8 +762,6 @@ void cDatabase::DeleteAllSamples()
     {
         const auto sql = "DELETE FROM SAMPLES;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
-
         throw_on_sqlite3_error(sqlite3_exec(m_pDatabase, sql, NULL, 0, &m_pErrMsg));
 
         SH_LOG_INFO("All Samples deleted.");
@@ -508,25 +772,53 @@ void cDatabase::DeleteAllSamples()
     }
 }
 
-std::string cDatabase::GetSamplePathByFilename(const std::string &filename)
+int64_t cDatabase::GetSampleIDByPath(const std::string &path)
+{
+    int64_t id = -1;
+
+    try
+    {
+        const auto sql = "SELECT ID FROM SAMPLES WHERE PATH = ?;";
+
+        Sqlite3Statement statement(*this, sql);
+
+        throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, path.c_str(), path.size(), SQLITE_STATIC));
+
+        if (sqlite3_step(statement.stmt) == SQLITE_ROW)
+        {
+            id = sqlite3_column_int64(statement.stmt, 0);
+            SH_LOG_TRACE("Record found, fetching sample id for {}", path);
+        }
+
+        SH_LOG_TRACE("Selected sample id from table successfully.");
+    }
+    catch (const std::exception &e)
+    {
+        show_modal_dialog_and_log("Error! Cannot select sample id from table", "Error", e.what());
+    }
+
+    return id;
+}
+
+std::string cDatabase::GetSamplePathByID(int64_t id)
 {
     std::string path;
 
     try
     {
-        const auto sql = "SELECT PATH FROM SAMPLES WHERE FILENAME = ?;";
+        const auto sql = "SELECT PATH FROM SAMPLES WHERE ID = ?;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
 
-        throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, filename.c_str(), filename.size(), SQLITE_STATIC));
+        throw_on_sqlite3_error(sqlite3_bind_int64(statement.stmt, 1, id));
 
         if (sqlite3_step(statement.stmt) == SQLITE_ROW)
         {
             path = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 0)));
-            SH_LOG_INFO("Record found, fetching sample path for {}", filename);
+            SH_LOG_TRACE("Record found, fetching sample path for {}", id);
         }
 
-        SH_LOG_INFO("Selected sample path from table successfully.");
+        SH_LOG_TRACE("Selected sample path from table successfully.");
     }
     catch (const std::exception &e)
     {
@@ -536,25 +828,25 @@ std::string cDatabase::GetSamplePathByFilename(const std::string &filename)
     return path;
 }
 
-std::string cDatabase::GetSampleFileExtension(const std::string &filename)
+std::string cDatabase::GetSampleFileExtension(int64_t id)
 {
     std::string extension;
 
     try
     {
-        const auto sql = "SELECT EXTENSION FROM SAMPLES WHERE FILENAME = ?;";
+        const auto sql = "SELECT EXTENSION FROM SAMPLES WHERE ID = ?;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
 
-        throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, filename.c_str(), filename.size(), SQLITE_STATIC));
+        throw_on_sqlite3_error(sqlite3_bind_int64(statement.stmt, 1, id));
 
         if (sqlite3_step(statement.stmt) == SQLITE_ROW)
         {
             extension = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 0)));
-            SH_LOG_INFO("Record found, fetching file extension for {}", filename);
+            SH_LOG_TRACE("Record found, fetching file extension for {}", id);
         }
 
-        SH_LOG_INFO("Selected file extension from table successfully.");
+        SH_LOG_TRACE("Selected file extension from table successfully.");
     }
     catch (const std::exception &e)
     {
@@ -564,24 +856,20 @@ std::string cDatabase::GetSampleFileExtension(const std::string &filename)
     return extension;
 }
 
-wxVector<wxVector<wxVariant>> cDatabase::LoadSamplesDatabase(wxDataViewTreeCtrl &favorite_tree,
-                                                            wxDataViewItem &favorite_item,
-                                                            wxTreeCtrl &trash_tree, wxTreeItemId &trash_item,
-                                                            bool show_extension,
-                                                            const std::string &icon_star_filled,
-                                                            const std::string &icon_star_empty)
+std::vector<Sample> cDatabase::LoadSamplesDatabase(wxDataViewTreeCtrl &favorite_tree,
+                                                  wxDataViewItem &favorite_item,
+                                                  wxTreeCtrl &trash_tree, wxTreeItemId &trash_item,
+                                                  bool show_extension)
 {
-    wxVector<wxVector<wxVariant>> vecSet;
+    SH_TRACE_SCOPE("db.load");
 
-    wxVariant icon_filled, icon_empty;
-    icon_filled = wxVariant(wxBitmap(icon_star_filled, wxBITMAP_TYPE_PNG));
-    icon_empty = wxVariant(wxBitmap(icon_star_empty, wxBITMAP_TYPE_PNG));
+    std::vector<Sample> vecSet;
 
     try
     {
         int num_rows = 0;
 
-        Sqlite3Statement statement1(m_pDatabase, "SELECT Count(*) FROM SAMPLES;");
+        Sqlite3Statement statement1(*this, "SELECT Count(*) FROM SAMPLES;");
 
         if (SQLITE_ROW == sqlite3_step(statement1.stmt))
         {
@@ -592,112 +880,69 @@ wxVector<wxVector<wxVariant>> cDatabase::LoadSamplesDatabase(wxDataViewTreeCtrl
             vecSet.reserve(num_rows);
         }
 
-        Sqlite3Statement statement(m_pDatabase, "SELECT FAVORITE, FILENAME, EXTENSION, SAMPLEPACK, \
-                                                TYPE, CHANNELS, BPM, LENGTH, SAMPLERATE, BITRATE, PATH, \
-                                                TRASHED, HIVE FROM SAMPLES;");
-
-        int row = 0;
+        Sqlite3Statement statement(*this, "SELECT FAVORITE, FILENAME, SAMPLEPACK, TYPE, \
+                                                CHANNELS, BPM, LENGTH, SAMPLERATE, BITRATE, PATH, ID, \
+                                                EXTENSION, TRASHED, HIVE FROM SAMPLES;");
 
         while (SQLITE_ROW == sqlite3_step(statement.stmt))
         {
-            int favorite = sqlite3_column_int(statement.stmt, 0);
-            wxString filename = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 1)));
-            wxString file_extension = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 2)));
-            wxString sample_pack = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 3)));
-            wxString sample_type = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 4)));
-            int channels = sqlite3_column_int(statement.stmt, 5);
-            int bpm = sqlite3_column_int(statement.stmt, 6);
-            int length = sqlite3_column_int(statement.stmt, 7);
-            int sample_rate = sqlite3_column_int(statement.stmt, 8);
-            int bitrate = sqlite3_column_int(statement.stmt, 9);
-            wxString path = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 10)));
-            int trashed = sqlite3_column_int(statement.stmt, 11);
-            wxString hive_name = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 12)));
-
-            wxString _length = SampleHive::cUtils::Get().CalculateAndGetISOStandardTime(length);
-            wxString _bpm = SampleHive::cUtils::Get().GetBPMString(bpm);
-
-            wxVector<wxVariant> vec;
-            vec.reserve(12);
+            Sample sample = ReadListRow(statement.stmt);
+
+            wxString filename = sample.GetFilename();
+            wxString file_extension = column_string(statement.stmt, 11);
+            int trashed = sqlite3_column_int(statement.stmt, 12);
+            wxString hive_name = column_string(statement.stmt, 13);
+
+            if (show_extension)
+                filename = wxString::Format("%s.%s", filename, file_extension);
 
             if (trashed == 1)
             {
-                if (show_extension)
-                    trash_tree.AppendItem(trash_item, wxString::Format("%s.%s", filename, file_extension));
-                else
-                    trash_tree.AppendItem(trash_item, filename);
+                trash_tree.AppendItem(trash_item, filename, -1, -1, new SampleHive::cSampleItemData(sample.GetID()));
+                continue;
             }
-            else
+
+            if (sample.GetFavorite() == 1)
             {
-                if (favorite == 1)
-                {
-                    vec.push_back(icon_filled);
+                std::deque<wxDataViewItem> nodes;
+                nodes.push_back(favorite_tree.GetNthChild(wxDataViewItem(wxNullPtr), 0));
 
-                    std::deque<wxDataViewItem> nodes;
-                    nodes.push_back(favorite_tree.GetNthChild(wxDataViewItem(wxNullPtr), 0));
+                wxDataViewItem current_item, found_item;
 
-                    wxDataViewItem current_item, found_item;
+                int row = 0;
+                int hive_count = favorite_tree.GetChildCount(wxDataViewItem(wxNullPtr));
 
-                    int row = 0;
-                    int hive_count = favorite_tree.GetChildCount(wxDataViewItem(wxNullPtr));
+                while (!nodes.empty())
+                {
+                    current_item = nodes.front();
+                    nodes.pop_front();
 
-                    while (!nodes.empty())
+                    if (favorite_tree.GetItemText(current_item) == hive_name)
                     {
-                        current_item = nodes.front();
-                        nodes.pop_front();
-
-                        if (favorite_tree.GetItemText(current_item) == hive_name)
-                        {
-                            found_item = current_item;
-                            break;
-                        }
-
-                        wxDataViewItem child = favorite_tree.GetNthChild(wxDataViewItem(wxNullPtr), 0);
-
-                        while (row < (hive_count - 1))
-                        {
-                            row++;
-
-                            child = favorite_tree.GetNthChild(wxDataViewItem(wxNullPtr), row);
-                            nodes.push_back(child);
-                        }
+                        found_item = current_item;
+                        break;
                     }
 
-                    nodes.clear();
+                    wxDataViewItem child = favorite_tree.GetNthChild(wxDataViewItem(wxNullPtr), 0);
 
-                    if (found_item.IsOk())
+                    while (row < (hive_count - 1))
                     {
-                        if (show_extension)
-                            favorite_tree.AppendItem(found_item, wxString::Format("%s.%s", filename, file_extension));
-                        else
-                            favorite_tree.AppendItem(found_item, filename);
+                        row++;
+
+                        child = favorite_tree.GetNthChild(wxDataViewItem(wxNullPtr), row);
+                        nodes.push_back(child);
                     }
                 }
-                else
-                    vec.push_back(icon_empty);
 
-                if (show_extension)
-                {
-                    vec.push_back(path.AfterLast('/'));
-                }
-                else
+                nodes.clear();
+
+                if (found_item.IsOk())
                 {
-                    vec.push_back(path.AfterLast('/').BeforeLast('.'));
+                    favorite_tree.AppendItem(found_item, filename, -1, new SampleHive::cSampleItemData(sample.GetID()));
                 }
-
-                vec.push_back(sample_pack);
-                vec.push_back(sample_type);
-                vec.push_back(wxString::Format("%d", channels));
-                vec.push_back(_bpm);
-                vec.push_back(_length);
-                vec.push_back(wxString::Format("%d", sample_rate));
-                vec.push_back(wxString::Format("%d", bitrate));
-                vec.push_back(path);
-
-                vecSet.push_back(vec);
             }
 
-            row++;
+            vecSet.push_back(std::move(sample));
         }
     }
     catch (const std::exception &e)
@@ -708,73 +953,108 @@ wxVector<wxVector<wxVariant>> cDatabase::LoadSamplesDatabase(wxDataViewTreeCtrl
     return vecSet;
 }
 
-wxVector<wxVector<wxVariant>>cDatabase::FilterDatabaseBySampleName(const std::string &sampleName, bool show_extension,
-                                                                  const std::string &icon_star_filled,
-                                                                  const std::string &icon_star_empty)
+// Matches in the filename rank above matches in the pack or type, which rank
+// above matches that are only somewhere in the path.
+static const char* s_SearchMatchQuery = "SELECT S.FAVORITE, S.FILENAME, S.SAMPLEPACK, S.TYPE, \
+                                         S.CHANNELS, S.BPM, S.LENGTH, S.SAMPLERATE, S.BITRATE, S.PATH, S.ID \
+                                         FROM SAMPLES_FTS JOIN SAMPLES S ON S.ID = SAMPLES_FTS.rowid \
+                                         WHERE SAMPLES_FTS MATCH ? \
+                                         ORDER BY bm25(SAMPLES_FTS, 10.0, 5.0, 5.0, 1.0);";
+
+// Terms too short for the trigram index, and the empty search used to list
+// every sample, fall back to scanning the same columns the index covers.
+// Unranked, so the empty search can stream rows without sorting them all.
+static const char* s_SearchLikeQuery = "SELECT FAVORITE, FILENAME, SAMPLEPACK, TYPE, \
+                                        CHANNELS, BPM, LENGTH, SAMPLERATE, BITRATE, PATH, ID \
+                                        FROM SAMPLES WHERE FILENAME LIKE '%' || ?1 || '%' \
+                                        OR SAMPLEPACK LIKE '%' || ?1 || '%' \
+                                        OR TYPE LIKE '%' || ?1 || '%' \
+                                        OR PATH LIKE '%' || ?1 || '%';";
+
+// Turns the search text into an FTS5 query that matches every whitespace
+// separated term as a substring. Returns an empty string when a term is
+// shorter than the three characters the trigram tokenizer can look up.
+std::string cDatabase::BuildSearchMatchQuery(const std::string &search)
 {
-    wxVector<wxVector<wxVariant>> sampleVec;
-
-    wxVariant icon_filled, icon_empty;
-    icon_filled = wxVariant(wxBitmap(icon_star_filled, wxBITMAP_TYPE_PNG));
-    icon_empty = wxVariant(wxBitmap(icon_star_empty, wxBITMAP_TYPE_PNG));
+    std::istringstream terms(search);
+    std::string term;
+    std::string query;
 
-    try
+    while (terms >> term)
     {
-        Sqlite3Statement statement(m_pDatabase, "SELECT FAVORITE, FILENAME, SAMPLEPACK, TYPE, \
-                                                CHANNELS, BPM, LENGTH, SAMPLERATE, BITRATE, PATH \
-                                                FROM SAMPLES WHERE FILENAME LIKE '%' || ? || '%' ;");
+        int characters = 0;
 
-        throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, sampleName.c_str(), sampleName.size(), SQLITE_STATIC));
+        for (const char c : term)
+        {
+            if ((c & 0xC0) != 0x80)
+                characters++;
+        }
 
-        int row = 0;
+        if (characters < 3)
+            return std::string();
 
-        while (SQLITE_ROW == sqlite3_step(statement.stmt))
+        std::string escaped;
+
+        for (const char c : term)
         {
-            SH_LOG_INFO("Record found, filtering db by {}", sampleName);
+            if (c == '"')
+                escaped += '"';
 
-            int favorite = sqlite3_column_int(statement.stmt, 0);
-            wxString filename = wxString(std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 1))));
-            wxString sample_pack = wxString(std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 2))));
-            wxString sample_type = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 3)));
-            int channels = sqlite3_column_int(statement.stmt, 4);
-            int bpm = sqlite3_column_int(statement.stmt, 5);
-            int length = sqlite3_column_int(statement.stmt, 6);
-            int sample_rate = sqlite3_column_int(statement.stmt, 7);
-            int bitrate = sqlite3_column_int(statement.stmt, 8);
-            wxString path = wxString(std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 9))));
+            escaped += c;
+        }
 
-            wxString _length = SampleHive::cUtils::Get().CalculateAndGetISOStandardTime(length);
-            wxString _bpm = SampleHive::cUtils::Get().GetBPMString(bpm);
+        if (!query.empty())
+            query += " AND ";
 
-            wxVector<wxVariant> vec;
+        query += "\"" + escaped + "\"";
+    }
 
-            if (favorite == 1)
-                vec.push_back(icon_filled);
-            else
-                vec.push_back(icon_empty);
+    return query;
+}
 
-            if (show_extension)
-            {
-                vec.push_back(path.AfterLast('/'));
-            }
-            else
-            {
-                vec.push_back(path.AfterLast('/').BeforeLast('.'));
-            }
+const char* cDatabase::GetSearchQuery(const std::string &match)
+{
+    return match.empty() ? s_SearchLikeQuery : s_SearchMatchQuery;
+}
 
-            vec.push_back(sample_pack);
-            vec.push_back(sample_type);
-            vec.push_back(wxString::Format("%d", channels));
-            vec.push_back(_bpm);
-            vec.push_back(_length);
-            vec.push_back(wxString::Format("%d", sample_rate));
-            vec.push_back(wxString::Format("%d", bitrate));
-            vec.push_back(path);
+Sample cDatabase::ReadListRow(sqlite3_stmt *stmt)
+{
+    Sample sample;
+
+    sample.SetFavorite(sqlite3_column_int(stmt, 0));
+    sample.SetFilename(column_string(stmt, 1));
+    sample.SetSamplePack(column_string(stmt, 2));
+    sample.SetType(column_string(stmt, 3));
+    sample.SetChannels(sqlite3_column_int(stmt, 4));
+    sample.SetBPM(sqlite3_column_int(stmt, 5));
+    sample.SetLength(sqlite3_column_int(stmt, 6));
+    sample.SetSampleRate(sqlite3_column_int(stmt, 7));
+    sample.SetBitrate(sqlite3_column_int(stmt, 8));
+    sample.SetPath(column_string(stmt, 9));
+    sample.SetID(sqlite3_column_int64(stmt, 10));
+
+    return sample;
+}
 
-            sampleVec.push_back(vec);
+std::vector<Sample> cDatabase::FilterDatabaseBySampleName(const std::string &sampleName)
+{
+    std::vector<Sample> sampleVec;
 
-            row++;
-        }
+    try
+    {
+        const std::string match = BuildSearchMatchQuery(sampleName);
+
+        Sqlite3Statement statement(*this, GetSearchQuery(match));
+
+        if (match.empty())
+            throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, sampleName.c_str(), sampleName.size(), SQLITE_STATIC));
+        else
+            throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, match.c_str(), match.size(), SQLITE_STATIC));
+
+        while (SQLITE_ROW == sqlite3_step(statement.stmt))
+            sampleVec.push_back(ReadListRow(statement.stmt));
+
+        SH_LOG_INFO("Found {} samples filtering db by {}", sampleVec.size(), sampleName);
     }
     catch (const std::exception &e)
     {
@@ -784,76 +1064,64 @@ wxVector<wxVector<wxVariant>>cDatabase::FilterDatabaseBySampleName(const std::st
     return sampleVec;
 }
 
-wxVector<wxVector<wxVariant>>cDatabase::FilterDatabaseByHiveName(const std::string &hiveName, bool show_extension,
-                                                                const std::string &icon_star_filled,
-                                                                const std::string &icon_star_empty)
+std::vector<Sample> cDatabase::FilterDatabaseByHiveName(const std::string &hiveName)
 {
-    wxVector<wxVector<wxVariant>> sampleVec;
-
-    wxVariant icon_filled, icon_empty;
-    icon_filled = wxVariant(wxBitmap(icon_star_filled, wxBITMAP_TYPE_PNG));
-    icon_empty = wxVariant(wxBitmap(icon_star_empty, wxBITMAP_TYPE_PNG));
+    std::vector<Sample> sampleVec;
 
     try
     {
-        Sqlite3Statement statement(m_pDatabase, "SELECT FAVORITE, FILENAME, SAMPLEPACK, TYPE, \
-                                                CHANNELS, BPM, LENGTH, SAMPLERATE, BITRATE, PATH \
+        Sqlite3Statement statement(*this, "SELECT FAVORITE, FILENAME, SAMPLEPACK, TYPE, \
+                                                CHANNELS, BPM, LENGTH, SAMPLERATE, BITRATE, PATH, ID \
                                                 FROM SAMPLES WHERE HIVE = ? AND FAVORITE = 1;");
 
         throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, hiveName.c_str(), hiveName.size(), SQLITE_STATIC));
 
-        int row = 0;
-
         while (SQLITE_ROW == sqlite3_step(statement.stmt))
-        {
-            SH_LOG_INFO("Record found, filtering db by {}", hiveName);
+            sampleVec.push_back(ReadListRow(statement.stmt));
 
-            int favorite = sqlite3_column_int(statement.stmt, 0);
-            wxString filename = wxString(std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 1))));
-            wxString sample_pack = wxString(std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 2))));
-            wxString sample_type = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 3)));
-            int channels = sqlite3_column_int(statement.stmt, 4);
-            int bpm = sqlite3_column_int(statement.stmt, 5);
-            int length = sqlite3_column_int(statement.stmt, 6);
-            int sample_rate = sqlite3_column_int(statement.stmt, 7);
-            int bitrate = sqlite3_column_int(statement.stmt, 8);
-            wxString path = wxString(std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 9))));
+        SH_LOG_INFO("Found {} samples filtering db by {}", sampleVec.size(), hiveName);
+    }
+    catch (const std::exception &e)
+    {
+        show_modal_dialog_and_log("Error! Cannot filter data from table", "Error", e.what());
+    }
 
-            wxString _length = SampleHive::cUtils::Get().CalculateAndGetISOStandardTime(length);
-            wxString _bpm = SampleHive::cUtils::Get().GetBPMString(bpm);
+    return sampleVec;
+}
 
-            wxVector<wxVariant> vec;
+std::vector<std::vector<Sample>> cDatabase::GetDuplicateGroups()
+{
+    std::vector<std::vector<Sample>> groups;
 
-            if (favorite == 1)
-                vec.push_back(icon_filled);
-            else
-                vec.push_back(icon_empty);
+    try
+    {
+        // Both sides of the join are served by the partial FINGERPRINT index
+        Sqlite3Statement statement(*this, "SELECT FAVORITE, FILENAME, SAMPLEPACK, TYPE, \
+                                                CHANNELS, BPM, LENGTH, SAMPLERATE, BITRATE, PATH, ID, FINGERPRINT \
+                                                FROM SAMPLES WHERE FINGERPRINT != 0 AND FINGERPRINT IN \
+                                                (SELECT FINGERPRINT FROM SAMPLES WHERE FINGERPRINT != 0 \
+                                                 GROUP BY FINGERPRINT HAVING COUNT(*) > 1) \
+                                                ORDER BY FINGERPRINT, PATH;");
 
-            if (show_extension)
-                vec.push_back(path.AfterLast('/'));
-            else
-                vec.push_back(path.AfterLast('/').BeforeLast('.'));
-
-            vec.push_back(sample_pack);
-            vec.push_back(sample_type);
-            vec.push_back(wxString::Format("%d", channels));
-            vec.push_back(_bpm);
-            vec.push_back(_length);
-            vec.push_back(wxString::Format("%d", sample_rate));
-            vec.push_back(wxString::Format("%d", bitrate));
-            vec.push_back(path);
-
-            sampleVec.push_back(vec);
-
-            row++;
+        while (SQLITE_ROW == sqlite3_step(statement.stmt))
+        {
+            Sample sample = ReadListRow(statement.stmt);
+            sample.SetFingerprint(static_cast<uint64_t>(sqlite3_column_int64(statement.stmt, 11)));
+
+            if (groups.empty() || groups.back().front().GetFingerprint() != sample.GetFingerprint())
+                groups.emplace_back();
+
+            groups.back().push_back(std::move(sample));
         }
+
+        SH_LOG_INFO("Found {} groups of identical samples", groups.size());
     }
     catch (const std::exception &e)
     {
-        show_modal_dialog_and_log("Error! Cannot filter data from table", "Error", e.what());
+        show_modal_dialog_and_log("Error! Cannot look up duplicate samples", "Error", e.what());
     }
 
-    return sampleVec;
+    return groups;
 }
 
 void cDatabase::LoadHivesDatabase(wxDataViewTreeCtrl &treeCtrl)
@@ -862,12 +1130,12 @@ void cDatabase::LoadHivesDatabase(wxDataViewTreeCtrl &treeCtrl)
     {
         const auto sql = "SELECT HIVE FROM HIVES;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
+
+        SH_LOG_DEBUG("Loading hives..");
 
         while (SQLITE_ROW == sqlite3_step(statement.stmt))
         {
-            SH_LOG_INFO("Loading hives..");
-
             const auto hive = wxString(std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 0))));
 
             treeCtrl.AppendContainer(wxDataViewItem(wxNullPtr), hive);
@@ -880,33 +1148,210 @@ void cDatabase::LoadHivesDatabase(wxDataViewTreeCtrl &treeCtrl)
 }
 
 // Compares the input array with the database and removes duplicates.
-wxArrayString cDatabase::CheckDuplicates(const wxArrayString &files)
+void cDatabase::RemoveKnownPaths(sqlite3 *connection, std::vector<std::string> &paths)
 {
-    wxArrayString sorted_files;
-
-    std::string filename;
-    std::string sample;
+    if (paths.empty())
+        return;
+
+    // The candidates go into a temp table and come back out through one
+    // anti-join against the PATH index, instead of a lookup per file. Temp
+    // tables are private to the connection and work on read only ones too.
+    const auto setup = "CREATE TEMP TABLE IF NOT EXISTS IMPORT_CANDIDATES(PATH TEXT NOT NULL);"
+                       "DELETE FROM temp.IMPORT_CANDIDATES;";
+    const auto insert = "INSERT INTO temp.IMPORT_CANDIDATES(PATH) VALUES(?);";
+    const auto select = "SELECT C.PATH FROM temp.IMPORT_CANDIDATES AS C "
+                        "WHERE NOT EXISTS (SELECT 1 FROM SAMPLES AS S WHERE S.PATH = C.PATH) "
+                        "ORDER BY C.ROWID;";
+
+    sqlite3_stmt *statement = nullptr;
+    std::vector<std::string> unknown;
+    unknown.reserve(paths.size());
 
     try
     {
-        const auto sql = "SELECT * FROM SAMPLES WHERE FILENAME = ?;";
+        // A savepoint nests inside a transaction the caller may have open
+        throw_on_sqlite3_error(sqlite3_exec(connection, "SAVEPOINT remove_known_paths;", NULL, NULL, NULL));
+        throw_on_sqlite3_error(sqlite3_exec(connection, setup, NULL, NULL, NULL));
+        throw_on_sqlite3_error(sqlite3_prepare_v2(connection, insert, -1, &statement, NULL));
+
+        for (const auto &path : paths)
+        {
+            throw_on_sqlite3_error(sqlite3_bind_text(statement, 1, path.c_str(), path.size(), SQLITE_STATIC));
+
+            if (sqlite3_step(statement) != SQLITE_DONE)
+                throw std::runtime_error(sqlite3_errmsg(connection));
+
+            throw_on_sqlite3_error(sqlite3_reset(statement));
+        }
+
+        sqlite3_finalize(statement);
+        statement = nullptr;
+
+        throw_on_sqlite3_error(sqlite3_prepare_v2(connection, select, -1, &statement, NULL));
+
+        while (sqlite3_step(statement) == SQLITE_ROW)
+            unknown.push_back(column_string(statement, 0));
+
+        sqlite3_finalize(statement);
+        statement = nullptr;
+
+        throw_on_sqlite3_error(sqlite3_exec(connection, "DELETE FROM temp.IMPORT_CANDIDATES;"
+                                                        "RELEASE remove_known_paths;", NULL, NULL, NULL));
+    }
+    catch (...)
+    {
+        sqlite3_finalize(statement);
+        sqlite3_exec(connection, "ROLLBACK TO remove_known_paths;"
+                                 "RELEASE remove_known_paths;", NULL, NULL, NULL);
+
+        throw;
+    }
+
+    SH_LOG_TRACE("{} of {} paths already added, skipping..", paths.size() - unknown.size(), paths.size());
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+    paths.swap(unknown);
+}
+
+std::vector<Sample> cDatabase::RefreshSamples(sqlite3 *connection, std::vector<Sample> &samples)
+{
+    sqlite3_stmt *statement = nullptr;
+    sqlite3_stmt *select_id = nullptr;
+    std::vector<Sample> unknown;
+    std::vector<Sample> refreshed;
 
-        for (unsigned int i = 0; i < files.size(); i++)
+    try
+    {
+        throw_on_sqlite3_error(sqlite3_prepare_v2(connection, "UPDATE SAMPLES SET CHANNELS = ?, BPM = ?, LENGTH = ?, "
+                                                  "SAMPLERATE = ?, BITRATE = ?, FINGERPRINT = ? WHERE PATH = ?;",
+                                                  -1, &statement, NULL));
+        throw_on_sqlite3_error(sqlite3_prepare_v2(connection, "SELECT ID FROM SAMPLES WHERE PATH = ?;",
+                                                  -1, &select_id, NULL));
+        throw_on_sqlite3_error(sqlite3_exec(connection, "BEGIN TRANSACTION", NULL, NULL, NULL));
+
+        for (auto &sample : samples)
         {
-            filename = files[i].AfterLast('/').BeforeLast('.').ToStdString();
+            const std::string path = sample.GetPath();
 
-            throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, filename.c_str(), filename.size(), SQLITE_STATIC));
+            throw_on_sqlite3_error(sqlite3_bind_int(statement, 1, sample.GetChannels()));
+            throw_on_sqlite3_error(sqlite3_bind_int(statement, 2, sample.GetBPM()));
+            throw_on_sqlite3_error(sqlite3_bind_int(statement, 3, sample.GetLength()));
+            throw_on_sqlite3_error(sqlite3_bind_int(statement, 4, sample.GetSampleRate()));
+            throw_on_sqlite3_error(sqlite3_bind_int(statement, 5, sample.GetBitrate()));
+            throw_on_sqlite3_error(sqlite3_bind_int64(statement, 6, static_cast<sqlite3_int64>(sample.GetFingerprint())));
+            throw_on_sqlite3_error(sqlite3_bind_text(statement, 7, path.c_str(), path.size(), SQLITE_STATIC));
+
+            if (sqlite3_step(statement) != SQLITE_DONE)
+                throw std::runtime_error(sqlite3_errmsg(connection));
+
+            throw_on_sqlite3_error(sqlite3_reset(statement));
+
+            if (sqlite3_changes(connection) == 0)
+            {
+                unknown.push_back(std::move(sample));
+                continue;
+            }
 
-            if (sqlite3_step(statement.stmt) != SQLITE_ROW)
-                sorted_files.push_back(files[i]);
-            else
-                SH_LOG_INFO("Already added: {}, skipping..", files[i]);
+            // The list shows the row by id
+            throw_on_sqlite3_error(sqlite3_bind_text(select_id, 1, path.c_str(), path.size(), SQLITE_STATIC));
 
-            rc = sqlite3_clear_bindings(statement.stmt);
-            rc = sqlite3_reset(statement.stmt);
+            if (sqlite3_step(select_id) == SQLITE_ROW)
+                sample.SetID(sqlite3_column_int64(select_id, 0));
+
+            throw_on_sqlite3_error(sqlite3_reset(select_id));
+
+            refreshed.push_back(std::move(sample));
         }
+
+        throw_on_sqlite3_error(sqlite3_exec(connection, "END TRANSACTION", NULL, NULL, NULL));
+    }
+    catch (...)
+    {
+        sqlite3_finalize(statement);
+        sqlite3_finalize(select_id);
+
+        if (!sqlite3_get_autocommit(connection))
+            sqlite3_exec(connection, "ROLLBACK", NULL, NULL, NULL);
+
+        throw;
+    }
+
+    sqlite3_finalize(statement);
+    sqlite3_finalize(select_id);
+
+    samples.swap(unknown);
+
+    return refreshed;
+}
+
+std::vector<std::pair<int64_t, std::string>> cDatabase::GetSamplesWithoutFingerprint(sqlite3 *connection)
+{
+    std::vector<std::pair<int64_t, std::string>> samples;
+
+    sqlite3_stmt *statement = nullptr;
+
+    throw_on_sqlite3_error(sqlite3_prepare_v2(connection, "SELECT ID, PATH FROM SAMPLES WHERE FINGERPRINT = 0;",
+                                              -1, &statement, NULL));
+
+    while (sqlite3_step(statement) == SQLITE_ROW)
+        samples.emplace_back(sqlite3_column_int64(statement, 0), column_string(statement, 1));
+
+    sqlite3_finalize(statement);
+
+    return samples;
+}
+
+void cDatabase::UpdateFingerprints(sqlite3 *connection, const std::vector<std::pair<int64_t, uint64_t>> &fingerprints)
+{
+    sqlite3_stmt *statement = nullptr;
+
+    try
+    {
+        throw_on_sqlite3_error(sqlite3_prepare_v2(connection, "UPDATE SAMPLES SET FINGERPRINT = ? WHERE ID = ?;",
+                                                  -1, &statement, NULL));
+        throw_on_sqlite3_error(sqlite3_exec(connection, "BEGIN TRANSACTION", NULL, NULL, NULL));
+
+        for (const auto &fingerprint : fingerprints)
+        {
+            throw_on_sqlite3_error(sqlite3_bind_int64(statement, 1, static_cast<sqlite3_int64>(fingerprint.second)));
+            throw_on_sqlite3_error(sqlite3_bind_int64(statement, 2, fingerprint.first));
+
+            if (sqlite3_step(statement) != SQLITE_DONE)
+                throw std::runtime_error(sqlite3_errmsg(connection));
+
+            throw_on_sqlite3_error(sqlite3_reset(statement));
+        }
+
+        throw_on_sqlite3_error(sqlite3_exec(connection, "END TRANSACTION", NULL, NULL, NULL));
+    }
+    catch (...)
+    {
+        sqlite3_finalize(statement);
+
+        if (!sqlite3_get_autocommit(connection))
+            sqlite3_exec(connection, "ROLLBACK", NULL, NULL, NULL);
+
+        throw;
+    }
+
+    sqlite3_finalize(statement);
+}
+
+wxArrayString cDatabase::CheckDuplicates(const wxArrayString &files)
+{
+    wxArrayString sorted_files;
+
+    std::vector<std::string> paths;
+    paths.reserve(files.size());
+
+    for (const auto &file : files)
+        paths.push_back(file.ToStdString());
+
+    try
+    {
+        RemoveKnownPaths(m_pDatabase, paths);
+
+        for (const auto &path : paths)
+            sorted_files.push_back(path);
     }
     catch (const std::exception &e)
     {
@@ -916,25 +1361,25 @@ wxArrayString cDatabase::CheckDuplicates(const wxArrayString &files)
     return sorted_files;
 }
 
-bool cDatabase::IsTrashed(const std::string &filename)
+bool cDatabase::IsTrashed(int64_t id)
 {
     try
     {
-        const auto sql = "SELECT TRASHED FROM SAMPLES WHERE FILENAME = ?;";
+        const auto sql = "SELECT TRASHED FROM SAMPLES WHERE ID = ?;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
 
-        throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, filename.c_str(), filename.size(), SQLITE_STATIC));
+        throw_on_sqlite3_error(sqlite3_bind_int64(statement.stmt, 1, id));
 
         if (sqlite3_step(statement.stmt) == SQLITE_ROW)
         {
-            SH_LOG_INFO("Record found, fetching {} trash status", filename);
+            SH_LOG_TRACE("Record found, fetching {} trash status", id);
 
             if (sqlite3_column_int(statement.stmt, 0) == 1)
                 return true;
         }
 
-        SH_LOG_INFO("Selected trash status from table successfully.");
+        SH_LOG_TRACE("Selected trash status from table successfully.");
     }
     catch (const std::exception &e)
     {
@@ -944,23 +1389,23 @@ bool cDatabase::IsTrashed(const std::string &filename)
     return false;
 }
 
-void cDatabase::UpdateTrashColumn(const std::string &filename, int value)
+void cDatabase::UpdateTrashColumn(int64_t id, int value)
 {
     try
     {
-        const auto sql = "UPDATE SAMPLES SET TRASHED = ? WHERE FILENAME = ?;";
+        const auto sql = "UPDATE SAMPLES SET TRASHED = ? WHERE ID = ?;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
 
         throw_on_sqlite3_error(sqlite3_bind_int(statement.stmt, 1, value));
-        throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 2, filename.c_str(), filename.size(), SQLITE_STATIC));
+        throw_on_sqlite3_error(sqlite3_bind_int64(statement.stmt, 2, id));
 
         if (sqlite3_step(statement.stmt) == SQLITE_ROW)
         {
-            SH_LOG_INFO("Record found, updating trash status for {}", filename);
+            SH_LOG_TRACE("Record found, updating trash status for {}", id);
         }
 
-        SH_LOG_INFO("Updated trash status successfully.");
+        SH_LOG_TRACE("Updated trash status successfully.");
     }
     catch (const std::exception &e)
     {
@@ -968,70 +1413,20 @@ void cDatabase::UpdateTrashColumn(const std::string &filename, int value)
     }
 }
 
-wxVector<wxVector<wxVariant>>cDatabase::RestoreFromTrashByFilename(const std::string &filename,
-                                                                  wxVector<wxVector<wxVariant>> &vecSet, bool show_extension,
-                                                                  const std::string &icon_star_filled,
-                                                                  const std::string &icon_star_empty)
+std::vector<Sample> cDatabase::RestoreFromTrashByID(int64_t id, std::vector<Sample> &vecSet)
 {
-    wxVariant icon_filled, icon_empty;
-    icon_filled = wxVariant(wxBitmap(icon_star_filled, wxBITMAP_TYPE_PNG));
-    icon_empty = wxVariant(wxBitmap(icon_star_empty, wxBITMAP_TYPE_PNG));
-
     try
     {
-        const auto sql = "SELECT FAVORITE, FILENAME, EXTENSION, SAMPLEPACK, \
-                          TYPE, CHANNELS, BPM, LENGTH, SAMPLERATE, BITRATE, PATH, \
-                          TRASHED, HIVE FROM SAMPLES WHERE FILENAME = ?;";
+        const auto sql = "SELECT FAVORITE, FILENAME, SAMPLEPACK, TYPE, \
+                          CHANNELS, BPM, LENGTH, SAMPLERATE, BITRATE, PATH, ID \
+                          FROM SAMPLES WHERE ID = ? AND TRASHED = 0;";
 
-        Sqlite3Statement statement(m_pDatabase, sql);
+        Sqlite3Statement statement(*this, sql);
 
-        throw_on_sqlite3_error(sqlite3_bind_text(statement.stmt, 1, filename.c_str(), filename.size(), SQLITE_STATIC));
+        throw_on_sqlite3_error(sqlite3_bind_int64(statement.stmt, 1, id));
 
         while (SQLITE_ROW == sqlite3_step(statement.stmt))
-        {
-            int favorite = sqlite3_column_int(statement.stmt, 0);
-            wxString filename = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 1)));
-            wxString file_extension = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 2)));
-            wxString sample_pack = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 3)));
-            wxString sample_type = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 4)));
-            int channels = sqlite3_column_int(statement.stmt, 5);
-            int bpm = sqlite3_column_int(statement.stmt, 6);
-            int length = sqlite3_column_int(statement.stmt, 7);
-            int sample_rate = sqlite3_column_int(statement.stmt, 8);
-            int bitrate = sqlite3_column_int(statement.stmt, 9);
-            wxString path = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 10)));
-            int trashed = sqlite3_column_int(statement.stmt, 11);
-            wxString hive_name = std::string(reinterpret_cast<const char*>(sqlite3_column_text(statement.stmt, 12)));
-
-            wxString _length = SampleHive::cUtils::Get().CalculateAndGetISOStandardTime(length);
-            wxString _bpm = SampleHive::cUtils::Get().GetBPMString(bpm);
-
-            wxVector<wxVariant> vec;
-
-            if (trashed == 0)
-            {
-                if (favorite == 1)
-                    vec.push_back(icon_filled);
-                else
-                    vec.push_back(icon_empty);
-
-                if (show_extension)
-                    vec.push_back(path.AfterLast('/'));
-                else
-                    vec.push_back(path.AfterLast('/').BeforeLast('.'));
-
-                vec.push_back(sample_pack);
-                vec.push_back(sample_type);
-                vec.push_back(wxString::Format("%d", channels));
-                vec.push_back(_bpm);
-                vec.push_back(_length);
-                vec.push_back(wxString::Format("%d", sample_rate));
-                vec.push_back(wxString::Format("%d", bitrate));
-                vec.push_back(path);
-
-                vecSet.push_back(vec);
-            }
-        }
+            vecSet.push_back(ReadListRow(statement.stmt));
     }
     catch (const std::exception &e)
     {
@@ -1043,15 +1438,41 @@ wxVector<wxVector<wxVariant>>cDatabase::RestoreFromTrashByFilename(const std::st
 
 void cDatabase::OpenDatabase()
 {
-    throw_on_sqlite3_error(sqlite3_open(static_cast<std::string>(DATABASE_FILEPATH).c_str(), &m_pDatabase));
+    m_Path = static_cast<std::string>(DATABASE_FILEPATH);
+
+    throw_on_sqlite3_error(sqlite3_open(m_Path.c_str(), &m_pDatabase));
+
+    ConfigureConnection();
 }
 
 void cDatabase::OpenTemporaryDatabase()
 {
-    throw_on_sqlite3_error(sqlite3_open("tempdb.db", &m_pDatabase));
+    m_Path = "tempdb.db";
+
+    throw_on_sqlite3_error(sqlite3_open(m_Path.c_str(), &m_pDatabase));
+
+    ConfigureConnection();
+}
+
+void cDatabase::ConfigureConnection()
+{
+    cQueryProfiler::Get().Attach(m_pDatabase);
+
+    // The connection lives for the whole session, WAL keeps readers from
+    // blocking on writes and NORMAL sync is safe in WAL mode.
+    throw_on_sqlite3_error(sqlite3_exec(m_pDatabase, "PRAGMA journal_mode = WAL;", NULL, 0, &m_pErrMsg));
+    throw_on_sqlite3_error(sqlite3_exec(m_pDatabase, "PRAGMA synchronous = NORMAL;", NULL, 0, &m_pErrMsg));
+
+    // Imports, searches and the duplicate finder use connections of their
+    // own while the library stays in use, wait out their short transactions
+    // instead of failing
+    sqlite3_busy_timeout(m_pDatabase, 5000);
 }
 
 void cDatabase::CloseDatabase()
 {
-    throw_on_sqlite3_error(sqlite3_close(m_pDatabase));
+    FinalizeCachedStatements();
+
+    sqlite3_close(m_pDatabase);
+    m_pDatabase = nullptr;
 }
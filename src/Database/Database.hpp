@@ -21,7 +21,10 @@
 
 #include "Utility/Sample.hpp"
 
+#include <cstdint>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <iostream>
 
@@ -36,16 +39,38 @@
 
 class cDatabase
 {
-    public:
+    private:
         cDatabase();
         ~cDatabase();
 
+    public:
+        // -------------------------------------------------------------------
+        cDatabase(const cDatabase&) = delete;
+        cDatabase& operator=(const cDatabase&) = delete;
+
+    public:
+        // -------------------------------------------------------------------
+        // The connection is opened once and shared by the whole application
+        static cDatabase& Get()
+        {
+            static cDatabase s_Database;
+            return s_Database;
+        }
+
     private:
         // -------------------------------------------------------------------
         sqlite3* m_pDatabase = nullptr;
+        std::string m_Path;
         int rc;
         char* m_pErrMsg = nullptr;
 
+        // -------------------------------------------------------------------
+        // Prepared statements keyed by their SQL text, finalized on close
+        std::unordered_map<std::string, sqlite3_stmt*> m_StatementCache;
+
+        unsigned long m_StatementCacheHits = 0;
+        unsigned long m_StatementCacheMisses = 0;
+
     private:
         // -------------------------------------------------------------------
         void OpenDatabase();
@@ -53,60 +78,115 @@ class cDatabase
 
         void OpenTemporaryDatabase();
 
+        // Settings every session connection needs, demo mode or not
+        void ConfigureConnection();
+
+        // -------------------------------------------------------------------
+        // Return a cached statement for query, preparing it on first use
+        sqlite3_stmt* GetCachedStatement(const std::string& query);
+        void FinalizeCachedStatements();
+
+        friend class Sqlite3Statement;
+
+    public:
+        // -------------------------------------------------------------------
+        // Statement cache statistics
+        inline unsigned long GetStatementCacheHits() const { return m_StatementCacheHits; }
+        inline unsigned long GetStatementCacheMisses() const { return m_StatementCacheMisses; }
+        inline size_t GetStatementCacheSize() const { return m_StatementCache.size(); }
+
+        // -------------------------------------------------------------------
+        // File the connection was opened on, for workers that need their own
+        inline const std::string& GetPath() const { return m_Path; }
+
+    public:
+        // -------------------------------------------------------------------
+        // Turn search text into an FTS5 trigram query, empty when a term is
+        // too short for the index, and pick the SQL that runs it
+        static std::string BuildSearchMatchQuery(const std::string& search);
+        static const char* GetSearchQuery(const std::string& match);
+
+        // Insert and duplicate checks shared with the import pipeline, which
+        // writes through its own connection
+        static const char* GetInsertSampleQuery();
+        static void InsertSamples(sqlite3* connection, sqlite3_stmt* statement, std::vector<Sample>& samples);
+        static void RemoveKnownPaths(sqlite3* connection, std::vector<std::string>& paths);
+
+        // Store the new analysis of files changed on disk and return those
+        // samples with their ids, leaves the ones not in the library yet in samples
+        static std::vector<Sample> RefreshSamples(sqlite3* connection, std::vector<Sample>& samples);
+
+        // Content fingerprints, filled in by the find duplicates job for
+        // samples imported before they were stored
+        static std::vector<std::pair<int64_t, std::string>> GetSamplesWithoutFingerprint(sqlite3* connection);
+        static void UpdateFingerprints(sqlite3* connection, const std::vector<std::pair<int64_t, uint64_t>>& fingerprints);
+
+        // Read a row selected as FAVORITE, FILENAME, SAMPLEPACK, TYPE, CHANNELS,
+        // BPM, LENGTH, SAMPLERATE, BITRATE, PATH, ID
+        static Sample ReadListRow(sqlite3_stmt* stmt);
+
     public:
         // -------------------------------------------------------------------
         // Create the table
         void CreateTableSamples();
         void CreateTableHives();
+        void CreateTableMetadata();
+        void CreateTableScanState();
 
         // -------------------------------------------------------------------
-        // Insert into database
-        void InsertIntoSamples(const std::vector<Sample>&);
+        // Insert into database, assigns the new sample ids to the samples
+        void InsertIntoSamples(std::vector<Sample>& samples);
         void InsertIntoHives(const std::string& hiveName);
         
         // -------------------------------------------------------------------
         // Update database
-        void UpdateFavoriteColumn(const std::string& filename, int value);
+        void UpdateFavoriteColumn(int64_t id, int value);
         void UpdateHive(const std::string& hiveOldName, const std::string& hiveNewName);
-        void UpdateHiveName(const std::string& filename, const std::string& hiveName);
-        void UpdateTrashColumn(const std::string& filename, int value);
-        void UpdateSamplePack(const std::string& filename, const std::string& samplePack);
-        void UpdateSampleType(const std::string& filename, const std::string& type);
+        void UpdateHiveName(int64_t id, const std::string& hiveName);
+        void UpdateTrashColumn(int64_t id, int value);
+        void UpdateSamplePack(int64_t id, const std::string& samplePack);
+        void UpdateSampleType(int64_t id, const std::string& type);
 
         // -------------------------------------------------------------------
         // Get from database
-        int GetFavoriteColumnValueByFilename(const std::string& filename);
-        std::string GetHiveByFilename(const std::string& filename);
-        std::string GetSamplePathByFilename(const std::string& filename);
-        std::string GetSampleFileExtension(const std::string& filename);
-        std::string GetSampleType(const std::string& filename);
+        int64_t GetSampleIDByPath(const std::string& path);
+        int GetFavoriteColumnValueByID(int64_t id);
+        std::string GetHiveByID(int64_t id);
+        std::string GetSamplePathByID(int64_t id);
+        std::string GetSampleFileExtension(int64_t id);
+        std::string GetSampleType(int64_t id);
 
         // -------------------------------------------------------------------
         // Check database
-        bool IsTrashed(const std::string& filename);
+        bool IsTrashed(int64_t id);
         wxArrayString CheckDuplicates(const wxArrayString& files);
 
         // -------------------------------------------------------------------
         // Remove from database
-        void RemoveSampleFromDatabase(const std::string& filename);
+        void RemoveSampleFromDatabase(int64_t id);
         void RemoveHiveFromDatabase(const std::string& hiveName);
 
         void DeleteAllSamples();
 
         // -------------------------------------------------------------------
-        wxVector<wxVector<wxVariant>> 
+        // Rows for the library list, hive and trash items are added to the
+        // trees while loading
+        std::vector<Sample>
         LoadSamplesDatabase(wxDataViewTreeCtrl& favorite_tree, wxDataViewItem& favorite_item,
-                            wxTreeCtrl& trash_tree, wxTreeItemId& trash_item, bool show_extension,
-                            const std::string& icon_star_filled, const std::string& icon_star_emtpy);
+                            wxTreeCtrl& trash_tree, wxTreeItemId& trash_item, bool show_extension);
         void LoadHivesDatabase(wxDataViewTreeCtrl& favorite_tree);
-        wxVector<wxVector<wxVariant>>
-        RestoreFromTrashByFilename(const std::string& filename,
-                                   wxVector<wxVector<wxVariant>>& vecSet, bool show_extension,
-                                   const std::string& icon_star_filled, const std::string& icon_star_empty);
-        wxVector<wxVector<wxVariant>>
-        FilterDatabaseBySampleName(const std::string& sampleName, bool show_extension,
-                                   const std::string& icon_star_filled, const std::string& icon_star_empty);
-        wxVector<wxVector<wxVariant>>
-        FilterDatabaseByHiveName(const std::string& hiveName, bool show_extension,
-                                 const std::string& icon_star_filled, const std::string& icon_star_empty);
+        std::vector<Sample> RestoreFromTrashByID(int64_t id, std::vector<Sample>& vecSet);
+        std::vector<Sample> FilterDatabaseBySampleName(const std::string& sampleName);
+        std::vector<Sample> FilterDatabaseByHiveName(const std::string& hiveName);
+
+        // Samples sharing a fingerprint, one group per distinct sound
+        std::vector<std::vector<Sample>> GetDuplicateGroups();
+
+    private:
+        // -------------------------------------------------------------------
+        // Move samples from a pre-id SAMPLES table into the current schema
+        void MigrateTableSamples();
+
+        // Trigram full-text index over SAMPLES used by the search bar
+        void CreateTableSamplesSearch();
 };
@@ -0,0 +1,176 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Database
+
+#include "Database/QueryProfiler.hpp"
+#include "Utility/Log.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+    double to_milliseconds(int64_t nanoseconds)
+    {
+        return static_cast<double>(nanoseconds) / 1e6;
+    }
+
+    // Statements are reported on one line, whatever their formatting
+    std::string single_line(const std::string& sql, size_t maxLength)
+    {
+        std::string line;
+        line.reserve(std::min(sql.size(), maxLength));
+
+        bool space = false;
+
+        for (char c : sql)
+        {
+            if (c == ' ' || c == '\n' || c == '\t' || c == '\r')
+            {
+                space = !line.empty();
+                continue;
+            }
+
+            if (space)
+                line += ' ';
+
+            line += c;
+            space = false;
+
+            if (line.size() >= maxLength)
+            {
+                line += "...";
+                break;
+            }
+        }
+
+        return line;
+    }
+
+}
+
+void cQueryProfiler::Attach(sqlite3* connection)
+{
+    if (!connection || !IsEnabled())
+        return;
+
+    sqlite3_trace_v2(connection, SQLITE_TRACE_PROFILE, &cQueryProfiler::OnTrace, this);
+}
+
+int cQueryProfiler::OnTrace(unsigned type, void* context, void* statement, void* elapsed)
+{
+    if (type == SQLITE_TRACE_PROFILE)
+        static_cast<cQueryProfiler*>(context)->Record(static_cast<sqlite3_stmt*>(statement),
+                                                      *static_cast<sqlite3_int64*>(elapsed));
+
+    return 0;
+}
+
+void cQueryProfiler::Record(sqlite3_stmt* statement, int64_t nanoseconds)
+{
+    const char* sql = sqlite3_sql(statement);
+
+    if (!sql)
+        return;
+
+    // Reset so the next run of a cached statement starts counting from zero
+    const int full_scan_steps = sqlite3_stmt_status(statement, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    Stats& stats = m_Stats[sql];
+
+    stats.Count++;
+    stats.TotalTime += nanoseconds;
+    stats.MaxTime = std::max(stats.MaxTime, nanoseconds);
+    stats.FullScanSteps += static_cast<uint64_t>(full_scan_steps);
+
+    if (stats.Recent.size() < s_RecentRuns)
+        stats.Recent.push_back(nanoseconds);
+    else
+    {
+        stats.Recent[stats.NextRecent] = nanoseconds;
+        stats.NextRecent = (stats.NextRecent + 1) % s_RecentRuns;
+    }
+}
+
+std::string cQueryProfiler::GetReport(size_t maxStatements)
+{
+    struct Row
+    {
+        const std::string* Sql;
+        const Stats* Stat;
+        int64_t P99;
+    };
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    std::vector<Row> rows;
+    rows.reserve(m_Stats.size());
+
+    for (const auto& entry : m_Stats)
+    {
+        std::vector<int64_t> recent = entry.second.Recent;
+        const size_t index = recent.size() * 99 / 100;
+
+        std::nth_element(recent.begin(), recent.begin() + index, recent.end());
+
+        rows.push_back({ &entry.first, &entry.second, recent[index] });
+    }
+
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b)
+    {
+        return a.Stat->TotalTime > b.Stat->TotalTime;
+    });
+
+    if (rows.size() > maxStatements)
+        rows.resize(maxStatements);
+
+    std::string report;
+    char line[256];
+
+    std::snprintf(line, sizeof(line), "%10s %12s %10s %10s %12s  %s\n",
+                  "count", "total ms", "p99 ms", "max ms", "full scan", "statement");
+    report += line;
+
+    for (const auto& row : rows)
+    {
+        std::snprintf(line, sizeof(line), "%10llu %12.2f %10.3f %10.3f %12llu  ",
+                      static_cast<unsigned long long>(row.Stat->Count),
+                      to_milliseconds(row.Stat->TotalTime),
+                      to_milliseconds(row.P99),
+                      to_milliseconds(row.Stat->MaxTime),
+                      static_cast<unsigned long long>(row.Stat->FullScanSteps));
+
+        report += line;
+        report += single_line(*row.Sql, 160);
+        report += '\n';
+    }
+
+    return report;
+}
+
+void cQueryProfiler::Reset()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_Stats.clear();
+}
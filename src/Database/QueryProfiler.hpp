@@ -0,0 +1,96 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sqlite3.h>
+
+// Times every statement run on the connections attached to it through
+// sqlite3_trace_v2 and aggregates the runs by SQL text. Attaching is a
+// no-op unless profiling was enabled before the connection was opened.
+class cQueryProfiler
+{
+    private:
+        cQueryProfiler() = default;
+
+    public:
+        ~cQueryProfiler() = default;
+
+    public:
+        // -------------------------------------------------------------------
+        cQueryProfiler(const cQueryProfiler&) = delete;
+        cQueryProfiler& operator=(const cQueryProfiler&) = delete;
+
+    public:
+        // -------------------------------------------------------------------
+        static cQueryProfiler& Get()
+        {
+            static cQueryProfiler s_QueryProfiler;
+            return s_QueryProfiler;
+        }
+
+    public:
+        // -------------------------------------------------------------------
+        void Enable() { m_bEnabled = true; }
+        inline bool IsEnabled() const { return m_bEnabled.load(); }
+
+        // Call right after opening a connection, closing it detaches
+        void Attach(sqlite3* connection);
+
+        // -------------------------------------------------------------------
+        // One line per statement, slowest total time first
+        std::string GetReport(size_t maxStatements = 25);
+        void Reset();
+
+    private:
+        // -------------------------------------------------------------------
+        static int OnTrace(unsigned type, void* context, void* statement, void* elapsed);
+
+        void Record(sqlite3_stmt* statement, int64_t nanoseconds);
+
+    private:
+        // -------------------------------------------------------------------
+        struct Stats
+        {
+            uint64_t Count = 0;
+            int64_t TotalTime = 0;
+            int64_t MaxTime = 0;
+            uint64_t FullScanSteps = 0;
+
+            // The most recent runs, enough for a p99 without keeping them all
+            std::vector<int64_t> Recent;
+            size_t NextRecent = 0;
+        };
+
+        static const size_t s_RecentRuns = 1024;
+
+        std::atomic<bool> m_bEnabled{false};
+
+        // Runs come in from the UI, search, import and metadata connections
+        std::mutex m_Mutex;
+        std::unordered_map<std::string, Stats> m_Stats;
+};
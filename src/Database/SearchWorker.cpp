@@ -0,0 +1,219 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Database
+
+#include "Database/SearchWorker.hpp"
+#include "Database/Database.hpp"
+#include "Database/QueryProfiler.hpp"
+#include "Utility/Event.hpp"
+#include "Utility/Log.hpp"
+#include "Utility/Trace.hpp"
+
+#include <utility>
+
+cSearchWorker::cSearchWorker(wxEvtHandler& handler)
+    : m_Handler(handler), m_Generation(0)
+{
+    m_Thread = std::thread(&cSearchWorker::Run, this);
+}
+
+unsigned long cSearchWorker::Search(const std::string& databasePath, const std::string& search)
+{
+    unsigned long generation;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_PendingSearch = search;
+        m_PendingDatabasePath = databasePath;
+        m_bPending = true;
+
+        generation = ++m_Generation;
+
+        if (m_pDatabase)
+            sqlite3_interrupt(m_pDatabase);
+    }
+
+    m_Condition.notify_one();
+
+    return generation;
+}
+
+unsigned long cSearchWorker::Cancel()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_bPending = false;
+
+    const unsigned long generation = ++m_Generation;
+
+    if (m_pDatabase)
+        sqlite3_interrupt(m_pDatabase);
+
+    return generation;
+}
+
+void cSearchWorker::Run()
+{
+    while (true)
+    {
+        std::string search;
+        unsigned long generation;
+
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+
+            m_Condition.wait(lock, [this] { return m_bPending || m_bStop; });
+
+            if (m_bStop)
+                break;
+
+            search = m_PendingSearch;
+            generation = m_Generation.load();
+            m_ActiveGeneration = generation;
+            m_bPending = false;
+
+            // The library can be switched to and from the demo database, so
+            // follow whichever file the main connection is on.
+            if (!m_pDatabase || m_DatabasePath != m_PendingDatabasePath)
+            {
+                if (m_pDatabase)
+                    sqlite3_close(m_pDatabase);
+
+                m_pDatabase = nullptr;
+                m_DatabasePath = m_PendingDatabasePath;
+
+                if (sqlite3_open_v2(m_DatabasePath.c_str(), &m_pDatabase, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK)
+                {
+                    SH_LOG_ERROR("Error! Cannot open {} for searching: {}", m_DatabasePath,
+                                 sqlite3_errmsg(m_pDatabase));
+
+                    sqlite3_close(m_pDatabase);
+                    m_pDatabase = nullptr;
+                }
+                else
+                {
+                    cQueryProfiler::Get().Attach(m_pDatabase);
+
+                    // A newer search can land between picking this one up and
+                    // the first step, before there is anything to interrupt.
+                    sqlite3_progress_handler(m_pDatabase, 1000, [](void* worker)
+                    {
+                        cSearchWorker* self = static_cast<cSearchWorker*>(worker);
+                        return self->IsStale(self->m_ActiveGeneration) ? 1 : 0;
+                    }, this);
+                }
+            }
+        }
+
+        if (m_pDatabase)
+            RunQuery(search, generation);
+        else
+        {
+            std::vector<Sample> results;
+            PostResults(results, generation, true);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    sqlite3_close(m_pDatabase);
+    m_pDatabase = nullptr;
+}
+
+void cSearchWorker::RunQuery(const std::string& search, unsigned long generation)
+{
+    SH_TRACE_SCOPE("search.query");
+
+    const std::string match = cDatabase::BuildSearchMatchQuery(search);
+    const std::string& bind = match.empty() ? search : match;
+
+    sqlite3_stmt* stmt = nullptr;
+
+    if (sqlite3_prepare_v2(m_pDatabase, cDatabase::GetSearchQuery(match), -1, &stmt, NULL) != SQLITE_OK ||
+        sqlite3_bind_text(stmt, 1, bind.c_str(), bind.size(), SQLITE_STATIC) != SQLITE_OK)
+    {
+        SH_LOG_ERROR("Error! Cannot search for {}: {}", search, sqlite3_errmsg(m_pDatabase));
+
+        sqlite3_finalize(stmt);
+
+        std::vector<Sample> results;
+        PostResults(results, generation, true);
+        return;
+    }
+
+    std::vector<Sample> results;
+    results.reserve(s_BatchSize);
+
+    int rc;
+
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        if (IsStale(generation))
+            break;
+
+        results.push_back(cDatabase::ReadListRow(stmt));
+
+        if (results.size() == s_BatchSize)
+            PostResults(results, generation, false);
+    }
+
+    sqlite3_finalize(stmt);
+
+    // Superseded searches end quietly, their generation is already stale on
+    // the UI side as well.
+    if (IsStale(generation) || rc == SQLITE_INTERRUPT)
+        return;
+
+    if (rc != SQLITE_DONE)
+        SH_LOG_ERROR("Error! Search for {} failed: {}", search, sqlite3_errstr(rc));
+
+    PostResults(results, generation, true);
+}
+
+void cSearchWorker::PostResults(std::vector<Sample>& results, unsigned long generation, bool last)
+{
+    auto event = new SampleHive::cSearchResultsEvent(SampleHive::SH_EVT_SEARCH_RESULTS, wxID_ANY);
+    event->SetResults(std::move(results));
+    event->SetGeneration(generation);
+    event->SetLastBatch(last);
+
+    results.clear();
+    results.reserve(s_BatchSize);
+
+    wxQueueEvent(&m_Handler, event);
+}
+
+cSearchWorker::~cSearchWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_bStop = true;
+        ++m_Generation;
+
+        if (m_pDatabase)
+            sqlite3_interrupt(m_pDatabase);
+    }
+
+    m_Condition.notify_one();
+    m_Thread.join();
+}
@@ -0,0 +1,96 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Utility/Sample.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <wx/event.h>
+
+#include <sqlite3.h>
+
+// Runs library searches on a thread with its own read only connection and
+// posts the results back to a handler in batches.
+class cSearchWorker
+{
+    public:
+        cSearchWorker(wxEvtHandler& handler);
+        ~cSearchWorker();
+
+    public:
+        // -------------------------------------------------------------------
+        cSearchWorker(const cSearchWorker&) = delete;
+        cSearchWorker& operator=(const cSearchWorker&) = delete;
+
+    public:
+        // -------------------------------------------------------------------
+        // Replace any pending search and interrupt the one running, returns
+        // the generation the results will be tagged with
+        unsigned long Search(const std::string& databasePath, const std::string& search);
+
+        // Interrupt the running search and drop the pending one, returns the
+        // generation that makes results already posted stale
+        unsigned long Cancel();
+
+    private:
+        // -------------------------------------------------------------------
+        void Run();
+        void RunQuery(const std::string& search, unsigned long generation);
+        void PostResults(std::vector<Sample>& results, unsigned long generation, bool last);
+
+        bool IsStale(unsigned long generation) const { return generation != m_Generation.load(); }
+
+    private:
+        // -------------------------------------------------------------------
+        // Rows handed to the UI per event
+        static constexpr size_t s_BatchSize = 250;
+
+        wxEvtHandler& m_Handler;
+
+        // -------------------------------------------------------------------
+        // Owned by the worker thread, guarded by m_Mutex so Cancel() never
+        // interrupts a connection that is being closed
+        sqlite3* m_pDatabase = nullptr;
+        std::string m_DatabasePath;
+
+        // -------------------------------------------------------------------
+        std::thread m_Thread;
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+
+        std::string m_PendingSearch;
+        std::string m_PendingDatabasePath;
+        bool m_bPending = false;
+        bool m_bStop = false;
+
+        std::atomic<unsigned long> m_Generation;
+
+        // Generation of the query on the worker connection, only touched by
+        // the worker thread
+        unsigned long m_ActiveGeneration = 0;
+};
@@ -0,0 +1,91 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "GUI/Dialogs/Duplicates.hpp"
+#include "Utility/Utils.hpp"
+
+#include <wx/defs.h>
+#include <wx/gdicmn.h>
+#include <wx/string.h>
+
+cDuplicates::cDuplicates(wxWindow* window, const std::vector<std::vector<Sample>>& groups)
+    : wxDialog(window, wxID_ANY, _("Duplicate samples"), wxDefaultPosition,
+               wxSize(720, 480), wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER),
+      m_pWindow(window)
+{
+    m_pPanel = new wxPanel(this, wxID_ANY, wxDefaultPosition, wxDefaultSize);
+
+    m_pMainSizer = new wxBoxSizer(wxVERTICAL);
+    m_pButtonSizer = new wxBoxSizer(wxHORIZONTAL);
+
+    size_t redundant = 0;
+
+    for (const auto& group : groups)
+        redundant += group.size() - 1;
+
+    wxString summary;
+
+    if (groups.empty())
+        summary = _("No sample in the library is stored more than once.");
+    else
+        summary = wxString::Format(_("%lu sounds are stored more than once, %lu files could be removed."),
+                                   static_cast<unsigned long>(groups.size()),
+                                   static_cast<unsigned long>(redundant));
+
+    m_pSummaryText = new wxStaticText(m_pPanel, wxID_ANY, summary, wxDefaultPosition, wxDefaultSize);
+
+    m_pGroupsTree = new wxTreeCtrl(m_pPanel, wxID_ANY, wxDefaultPosition, wxDefaultSize,
+                                   wxTR_HIDE_ROOT | wxTR_HAS_BUTTONS | wxTR_NO_LINES | wxTR_SINGLE);
+
+    const wxTreeItemId root = m_pGroupsTree->AddRoot("Duplicates");
+
+    for (const auto& group : groups)
+    {
+        const Sample& first = group.front();
+
+        const wxString label = wxString::Format(_("%s  (%lu copies, %s)"), first.GetFilename(),
+                                                static_cast<unsigned long>(group.size()),
+                                                SampleHive::cUtils::Get().CalculateAndGetISOStandardTime(first.GetLength()));
+
+        const wxTreeItemId item = m_pGroupsTree->AppendItem(root, label);
+
+        for (const auto& sample : group)
+            m_pGroupsTree->AppendItem(item, sample.GetPath());
+    }
+
+    m_pCloseButton = new wxButton(m_pPanel, wxID_OK, _("Close"), wxDefaultPosition, wxDefaultSize);
+
+    m_pButtonSizer->Add(m_pCloseButton, 0, wxALL | wxALIGN_BOTTOM, 2);
+
+    m_pMainSizer->Add(m_pSummaryText, 0, wxALL | wxEXPAND, 4);
+    m_pMainSizer->Add(m_pGroupsTree, 1, wxALL | wxEXPAND, 2);
+    m_pMainSizer->Add(m_pButtonSizer, 0, wxALL | wxALIGN_RIGHT, 2);
+
+    // Top panel layout
+    m_pPanel->SetSizer(m_pMainSizer);
+    m_pMainSizer->Fit(m_pPanel);
+    m_pMainSizer->SetSizeHints(m_pPanel);
+    m_pMainSizer->Layout();
+}
+
+cDuplicates::~cDuplicates()
+{
+
+}
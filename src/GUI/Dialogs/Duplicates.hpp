@@ -0,0 +1,66 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Utility/Sample.hpp"
+
+#include <vector>
+
+#include <wx/button.h>
+#include <wx/dialog.h>
+#include <wx/event.h>
+#include <wx/panel.h>
+#include <wx/sizer.h>
+#include <wx/stattext.h>
+#include <wx/treectrl.h>
+#include <wx/window.h>
+
+// Lists the samples in the library that decode to the same audio, one
+// branch per sound with every path it is stored under.
+class cDuplicates : public wxDialog
+{
+    public:
+        cDuplicates(wxWindow* window, const std::vector<std::vector<Sample>>& groups);
+        ~cDuplicates();
+
+    private:
+        // -------------------------------------------------------------------
+        wxWindow* m_pWindow = nullptr;
+
+    private:
+        // -------------------------------------------------------------------
+        // Top panel for wxDialog
+        wxPanel* m_pPanel = nullptr;
+
+        // -------------------------------------------------------------------
+        // Top panel sizers
+        wxBoxSizer* m_pMainSizer = nullptr;
+        wxBoxSizer* m_pButtonSizer = nullptr;
+
+        // -------------------------------------------------------------------
+        // Dialog controls
+        wxStaticText* m_pSummaryText = nullptr;
+        wxTreeCtrl* m_pGroupsTree = nullptr;
+
+        // -------------------------------------------------------------------
+        // Common buttons for wxDialog
+        wxButton* m_pCloseButton = nullptr;
+};
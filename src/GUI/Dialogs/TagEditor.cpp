@@ -22,6 +22,7 @@
 #include "Database/Database.hpp"
 #include "Utility/ControlIDs.hpp"
 #include "Utility/Log.hpp"
+#include "Utility/MetadataCache.hpp"
 #include "Utility/Paths.hpp"
 #include "Utility/Event.hpp"
 #include "Utility/Signal.hpp"
@@ -32,10 +33,10 @@
 #include <wx/stringimpl.h>
 #include <wx/textdlg.h>
 
-cTagEditor::cTagEditor(wxWindow* window, const std::string& filename)
+cTagEditor::cTagEditor(wxWindow* window, const std::string& filename, int64_t sampleID)
     : wxDialog(window, wxID_ANY, "Edit tags", wxDefaultPosition,
                wxSize(640, 360), wxDEFAULT_DIALOG_STYLE | wxSTAY_ON_TOP),
-      m_pWindow(window), m_Filename(filename), tags(filename)
+      m_pWindow(window), m_Filename(filename), m_SampleID(sampleID), tags(filename)
 {
     m_pPanel = new wxPanel(this, wxID_ANY, wxDefaultPosition, wxDefaultSize);
 
@@ -61,15 +62,17 @@ cTagEditor::cTagEditor(wxWindow* window, const std::string& filename)
     m_pCommentCheck = new wxCheckBox(m_pPanel, SampleHive::ID::ET_CommentsCheck, "Comments", wxDefaultPosition, wxDefaultSize);
     m_pSampleTypeCheck = new wxCheckBox(m_pPanel, SampleHive::ID::ET_TypeCheck, "Type", wxDefaultPosition, wxDefaultSize);
 
-    m_pTitleText = new wxTextCtrl(m_pPanel, wxID_ANY, tags.GetAudioInfo().title, wxDefaultPosition, wxDefaultSize);
+    const auto info = SampleHive::cMetadataCache::Get().GetAudioInfo(m_Filename);
+
+    m_pTitleText = new wxTextCtrl(m_pPanel, wxID_ANY, info.title, wxDefaultPosition, wxDefaultSize);
     m_pTitleText->Disable();
-    m_pArtistText = new wxTextCtrl(m_pPanel, wxID_ANY, tags.GetAudioInfo().artist, wxDefaultPosition, wxDefaultSize);
+    m_pArtistText = new wxTextCtrl(m_pPanel, wxID_ANY, info.artist, wxDefaultPosition, wxDefaultSize);
     m_pArtistText->Disable();
-    m_pAlbumText = new wxTextCtrl(m_pPanel, wxID_ANY, tags.GetAudioInfo().album, wxDefaultPosition, wxDefaultSize);
+    m_pAlbumText = new wxTextCtrl(m_pPanel, wxID_ANY, info.album, wxDefaultPosition, wxDefaultSize);
     m_pAlbumText->Disable();
-    m_pGenreText = new wxTextCtrl(m_pPanel, wxID_ANY, tags.GetAudioInfo().genre, wxDefaultPosition, wxDefaultSize);
+    m_pGenreText = new wxTextCtrl(m_pPanel, wxID_ANY, info.genre, wxDefaultPosition, wxDefaultSize);
     m_pGenreText->Disable();
-    m_pCommentText = new wxTextCtrl(m_pPanel, wxID_ANY, tags.GetAudioInfo().comment, wxDefaultPosition, wxDefaultSize);
+    m_pCommentText = new wxTextCtrl(m_pPanel, wxID_ANY, info.comment, wxDefaultPosition, wxDefaultSize);
     m_pCommentText->Disable();
     m_pSampleTypeChoice = new wxChoice(m_pPanel, wxID_ANY, wxDefaultPosition, wxDefaultSize, 10, choices, wxCB_SORT);
     m_pSampleTypeChoice->Disable();
@@ -229,7 +232,7 @@ void cTagEditor::OnClickCustomTagButton(wxCommandEvent& event)
 
 void cTagEditor::OnClickApply(wxCommandEvent& event)
 {
-    cDatabase db;
+    cDatabase& db = cDatabase::Get();
 
     wxString title = m_pTitleText->GetValue();
     wxString artist = m_pArtistText->GetValue();
@@ -238,9 +241,7 @@ void cTagEditor::OnClickApply(wxCommandEvent& event)
     wxString comment = m_pCommentText->GetValue();
     wxString type = m_pSampleTypeChoice->GetStringSelection();
 
-    std::string sampleType = db.GetSampleType(m_Filename);
-
-    std::string filename = wxString(m_Filename).AfterLast('/').BeforeLast('.').ToStdString();
+    std::string sampleType = db.GetSampleType(m_SampleID);
 
     wxString warning_msg = "Are you sure you want save these changes?";
     wxMessageDialog* msgDialog = new wxMessageDialog(this, warning_msg,
@@ -252,10 +253,13 @@ void cTagEditor::OnClickApply(wxCommandEvent& event)
 
     wxString info_msg;
 
+    // Compare with the tags as they are on disk now, an earlier apply may have changed them
+    const auto info = SampleHive::cMetadataCache::Get().GetAudioInfo(m_Filename);
+
     switch (msgDialog->ShowModal())
     {
         case wxID_YES:
-            if (m_pTitleCheck->GetValue() && m_pTitleText->GetValue() != tags.GetAudioInfo().title)
+            if (m_pTitleCheck->GetValue() && m_pTitleText->GetValue() != info.title)
             {
                 SH_LOG_INFO("Changing title tag..");
                 tags.SetTitle(title.ToStdString());
@@ -263,19 +267,19 @@ void cTagEditor::OnClickApply(wxCommandEvent& event)
                 info_msg = wxString::Format("Successfully changed title tag to %s", title);
             }
 
-            if (m_pArtistCheck->GetValue() && m_pArtistText->GetValue() != tags.GetAudioInfo().artist)
+            if (m_pArtistCheck->GetValue() && m_pArtistText->GetValue() != info.artist)
             {
                 SH_LOG_INFO("Changing artist tag..");
                 tags.SetArtist(artist.ToStdString());
 
-                db.UpdateSamplePack(m_Filename, artist.ToStdString());
+                db.UpdateSamplePack(m_SampleID, artist.ToStdString());
 
                 SH_LOG_DEBUG("SAMPLE FILENAME HERE: %s", m_Filename);
 
                 info_msg = wxString::Format("Successfully changed artist tag to %s", artist);
             }
 
-            if (m_pAlbumCheck->GetValue() && m_pAlbumText->GetValue() != tags.GetAudioInfo().album)
+            if (m_pAlbumCheck->GetValue() && m_pAlbumText->GetValue() != info.album)
             {
                 SH_LOG_INFO("Changing album tag..");
                 tags.SetAlbum(album.ToStdString());
@@ -283,7 +287,7 @@ void cTagEditor::OnClickApply(wxCommandEvent& event)
                 info_msg = wxString::Format("Successfully changed album tag to %s", album);
             }
 
-            if (m_pGenreCheck->GetValue() && m_pGenreText->GetValue() != tags.GetAudioInfo().genre)
+            if (m_pGenreCheck->GetValue() && m_pGenreText->GetValue() != info.genre)
             {
                 SH_LOG_INFO("Changing genre tag..");
                 tags.SetGenre(genre.ToStdString());
@@ -291,7 +295,7 @@ void cTagEditor::OnClickApply(wxCommandEvent& event)
                 info_msg = wxString::Format("Successfully changed genre tag to %s", genre);
             }
 
-            if (m_pCommentCheck->GetValue() && m_pCommentText->GetValue() != tags.GetAudioInfo().comment)
+            if (m_pCommentCheck->GetValue() && m_pCommentText->GetValue() != info.comment)
             {
                 SH_LOG_INFO("Changing comment tag..");
                 tags.SetComment(comment.ToStdString());
@@ -302,10 +306,12 @@ void cTagEditor::OnClickApply(wxCommandEvent& event)
             if (m_pSampleTypeCheck->GetValue() && m_pSampleTypeChoice->GetStringSelection() != sampleType)
             {
                 SH_LOG_INFO("Changing type tag..");
-                db.UpdateSampleType(filename, type.ToStdString());
+                db.UpdateSampleType(m_SampleID, type.ToStdString());
 
                 info_msg = wxString::Format("Successfully changed type tag to %s", type);
             }
+
+            SampleHive::cMetadataCache::Get().Invalidate(m_Filename);
             break;
         case wxID_NO:
             break;
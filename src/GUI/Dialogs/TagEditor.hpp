@@ -22,6 +22,7 @@
 
 #include "Utility/Tags.hpp"
 
+#include <cstdint>
 #include <string>
 
 #include <wx/button.h>
@@ -39,7 +40,7 @@
 class cTagEditor : public wxDialog
 {
     public:
-        cTagEditor(wxWindow* window, const std::string& filename);
+        cTagEditor(wxWindow* window, const std::string& filename, int64_t sampleID);
         ~cTagEditor();
 
     private:
@@ -63,7 +64,8 @@ class cTagEditor : public wxDialog
         wxWindow* m_pWindow = nullptr;
 
         // -------------------------------------------------------------------
-        const std::string& m_Filename;
+        const std::string m_Filename;
+        int64_t m_SampleID = -1;
 
     private:
         // -------------------------------------------------------------------
@@ -21,7 +21,9 @@
 #include "Database/Database.hpp"
 #include "GUI/DirectoryBrowser.hpp"
 #include "Utility/ControlIDs.hpp"
+#include "Utility/DirectoryWalker.hpp"
 #include "Utility/HiveData.hpp"
+#include "Utility/ImportJobs.hpp"
 #include "Utility/Log.hpp"
 #include "Utility/Paths.hpp"
 #include "Utility/Sample.hpp"
@@ -29,7 +31,6 @@
 #include "Utility/Utils.hpp"
 
 #include <wx/dataobj.h>
-#include <wx/dir.h>
 #include <wx/dnd.h>
 #include <wx/treebase.h>
 
@@ -85,34 +86,31 @@ void cDirectoryBrowser::OnDragFromDirCtrl(wxTreeEvent& event)
 
 void cDirectoryBrowser::OnDirCtrlExpanded(wxTreeEvent& event)
 {
-    cDatabase db;
+    cDatabase& db = cDatabase::Get();
     SampleHive::cSerializer serializer;
 
     if (serializer.DeserializeDemoMode())
     {
         wxBusyCursor busy_cursor;
-        wxWindowDisabler window_disabler;
 
-        wxString filepath;
         wxArrayString filepath_array;
 
         const wxString pathToDirectory = this->GetPath(event.GetItem());
 
-        size_t number_of_files = wxDir::GetAllFiles(pathToDirectory, &filepath_array, wxEmptyString, wxDIR_FILES);
+        // Only the audio files directly in the expanded directory
+        SampleHive::cDirectoryWalker walker(serializer.DeserializeFollowSymLink(), false, 1);
+        const std::atomic<bool> cancelled(false);
 
-        for (size_t i = 0; i < number_of_files; i++)
+        walker.Walk({ pathToDirectory.ToStdString() }, [&filepath_array](std::vector<std::string>& files)
         {
-            filepath = filepath_array[i];
-
-            if (wxFileExists(filepath))
-            {
-                filepath_array.push_back(filepath);
-            }
-            else if (wxDirExists(filepath))
-            {
-                wxDir::GetAllFiles(filepath, &filepath_array);
-            }
-        }
+            for (const auto& file : files)
+                filepath_array.push_back(file);
+
+            return true;
+        }, cancelled);
+
+        // The previous directory's import would keep adding to the list
+        SampleHive::cImportJobs::Get().Cancel();
 
         // Delete all Files
         if (SampleHive::cHiveData::Get().GetListCtrlItemCount() >= 1)
@@ -81,8 +81,7 @@ cHivesPanel::cHivesPanel(wxWindow* window)
 
 void cHivesPanel::OnDragAndDropToHives(wxDropFilesEvent& event)
 {
-    SampleHive::cSerializer serializer;
-    cDatabase db;
+    cDatabase& db = cDatabase::Get();
 
     if (event.GetNumberOfFiles() > 0)
     {
@@ -112,29 +111,28 @@ void cHivesPanel::OnDragAndDropToHives(wxDropFilesEvent& event)
 
             files = file_data.GetFilenames();
 
-            wxString file_name = serializer.DeserializeShowFileExtension() ?
-                files[i].BeforeLast('.') : files[i];
+            int64_t id = SampleHive::cHiveData::Get().GetListCtrlSampleID(row);
 
             SH_LOG_DEBUG("Dropping {} file(s) {} on {}", rows - i, files[i], m_pHives->GetItemText(drop_target));
 
             if (drop_target.IsOk() && m_pHives->IsContainer(drop_target) &&
-                db.GetFavoriteColumnValueByFilename(file_name.ToStdString()) == 0)
+                db.GetFavoriteColumnValueByID(id) == 0)
             {
-                m_pHives->AppendItem(drop_target, files[i]);
+                m_pHives->AppendItem(drop_target, files[i], -1, new SampleHive::cSampleItemData(id));
 
-                SampleHive::cHiveData::Get().ListCtrlSetVariant(wxVariant(wxBitmap(ICON_STAR_FILLED_16px, wxBITMAP_TYPE_PNG)), row, 0);
+                SampleHive::cHiveData::Get().ListCtrlSetFavorite(row, true);
 
-                db.UpdateFavoriteColumn(file_name.ToStdString(), 1);
-                db.UpdateHiveName(file_name.ToStdString(), hive_name.ToStdString());
+                db.UpdateFavoriteColumn(id, 1);
+                db.UpdateHiveName(id, hive_name.ToStdString());
 
                 msg = wxString::Format(_("%s added to %s."), files[i], hive_name);
             }
             else
             {
-                if (db.GetFavoriteColumnValueByFilename(file_name.ToStdString()) == 1)
+                if (db.GetFavoriteColumnValueByID(id) == 1)
                 {
                     wxMessageBox(wxString::Format(_("%s is already added to %s hive"), files[i],
-                                                  db.GetHiveByFilename(file_name.ToStdString())),
+                                                  db.GetHiveByID(id)),
                                  _("Error!"), wxOK | wxICON_ERROR | wxCENTRE, this);
                 }
                 else
@@ -157,8 +155,7 @@ void cHivesPanel::OnDragAndDropToHives(wxDropFilesEvent& event)
 
 void cHivesPanel::OnShowHivesContextMenu(wxDataViewEvent& event)
 {
-    SampleHive::cSerializer serializer;
-    cDatabase db;
+    cDatabase& db = cDatabase::Get();
 
     wxDataViewItem selected_hive = event.GetItem();
 
@@ -259,11 +256,8 @@ void cHivesPanel::OnShowHivesContextMenu(wxDataViewEvent& event)
                                 {
                                     wxDataViewItem sample_item = m_pHives->GetNthChild(selected_hive, i);
 
-                                    wxString sample_name = serializer.DeserializeShowFileExtension() ?
-                                        m_pHives->GetItemText(sample_item).BeforeLast('.') :
-                                        m_pHives->GetItemText(sample_item);
-
-                                    db.UpdateHiveName(sample_name.ToStdString(), hive_name.ToStdString());
+                                    db.UpdateHiveName(SampleHive::cHiveData::Get().GetHiveItemSampleID(sample_item),
+                                                      hive_name.ToStdString());
                                     db.UpdateHive(selected_hive_name.ToStdString(), hive_name.ToStdString());
 
                                     m_pHives->SetItemText(selected_hive, hive_name);
@@ -348,37 +342,19 @@ void cHivesPanel::OnShowHivesContextMenu(wxDataViewEvent& event)
                             {
                                 wxDataViewItem child_item;
 
-                                for (int i = 0; i < SampleHive::cHiveData::Get().GetListCtrlItemCount(); i++)
+                                for (int j = 0; j < m_pHives->GetChildCount(selected_hive); j++)
                                 {
-                                    wxString matched_sample = serializer.DeserializeShowFileExtension() ?
-                                        SampleHive::cHiveData::Get().GetListCtrlTextValue(i, 1).BeforeLast('.') :
-                                        SampleHive::cHiveData::Get().GetListCtrlTextValue(i, 1);
-
-                                    for (int j = 0; j < m_pHives->GetChildCount(selected_hive); j++)
-                                    {
-                                        child_item = m_pHives->GetNthChild(selected_hive, j);
-
-                                        wxString child_name =
-                                            serializer.DeserializeShowFileExtension() ?
-                                            m_pHives->GetItemText(child_item).BeforeLast('.') :
-                                            m_pHives->GetItemText(child_item);
-
-                                        if (child_name == matched_sample)
-                                        {
-                                            SH_LOG_DEBUG("Found match");
-
-                                            SampleHive::cHiveData::Get().ListCtrlSetVariant(wxVariant(wxBitmap(ICON_STAR_EMPTY_16px, wxBITMAP_TYPE_PNG)),
-                                                                                           i, 0);
-
-                                            db.UpdateFavoriteColumn(matched_sample.ToStdString(), 0);
-                                            db.UpdateHiveName(matched_sample.ToStdString(),
-                                                              m_pHives->GetItemText(m_FavoritesHive).ToStdString());
-
-                                            break;
-                                        }
-                                        else
-                                            SH_LOG_DEBUG("No match found");
-                                    }
+                                    child_item = m_pHives->GetNthChild(selected_hive, j);
+
+                                    int64_t id = SampleHive::cHiveData::Get().GetHiveItemSampleID(child_item);
+
+                                    db.UpdateFavoriteColumn(id, 0);
+                                    db.UpdateHiveName(id, m_pHives->GetItemText(m_FavoritesHive).ToStdString());
+
+                                    int row = SampleHive::cHiveData::Get().GetListCtrlRowFromSampleID(id);
+
+                                    if (row != wxNOT_FOUND)
+                                        SampleHive::cHiveData::Get().ListCtrlSetFavorite(row, false);
                                 }
 
                                 m_pHives->DeleteChildren(selected_hive);
@@ -407,9 +383,7 @@ void cHivesPanel::OnShowHivesContextMenu(wxDataViewEvent& event)
                 {
                     try
                     {
-                        const auto dataset = db.FilterDatabaseByHiveName(hive_name.ToStdString(),
-                                                                         serializer.DeserializeShowFileExtension(),
-                                                                         ICON_STAR_FILLED_16px, ICON_STAR_EMPTY_16px);
+                        const auto dataset = db.FilterDatabaseByHiveName(hive_name.ToStdString());
 
                         if (dataset.empty())
                         {
@@ -420,11 +394,7 @@ void cHivesPanel::OnShowHivesContextMenu(wxDataViewEvent& event)
                         else
                         {
                             SampleHive::cHiveData::Get().ListCtrlDeleteAllItems();
-
-                            for (auto data : dataset)
-                            {
-                                SampleHive::cHiveData::Get().ListCtrlAppendItem(data);
-                            }
+                            SampleHive::cHiveData::Get().ListCtrlAppendSamples(dataset);
                         }
                     }
                     catch (std::exception& e)
@@ -439,8 +409,7 @@ void cHivesPanel::OnShowHivesContextMenu(wxDataViewEvent& event)
                 {
                     try
                     {
-                        const auto dataset = db.FilterDatabaseBySampleName("", serializer.DeserializeShowFileExtension(),
-                                                                           ICON_STAR_FILLED_16px, ICON_STAR_EMPTY_16px);
+                        const auto dataset = db.FilterDatabaseBySampleName("");
 
                         if (dataset.empty())
                         {
@@ -449,11 +418,7 @@ void cHivesPanel::OnShowHivesContextMenu(wxDataViewEvent& event)
                         else
                         {
                             SampleHive::cHiveData::Get().ListCtrlDeleteAllItems();
-
-                            for (auto data : dataset)
-                            {
-                                SampleHive::cHiveData::Get().ListCtrlAppendItem(data);
-                            }
+                            SampleHive::cHiveData::Get().ListCtrlAppendSamples(dataset);
                         }
                     }
                     catch (std::exception& e)
@@ -475,60 +440,39 @@ void cHivesPanel::OnShowHivesContextMenu(wxDataViewEvent& event)
         switch (m_pHives->GetPopupMenuSelectionFromUser(menu, event.GetPosition()))
         {
             case SampleHive::ID::MN_RemoveSample:
-                for (int i = 0; i < SampleHive::cHiveData::Get().GetListCtrlItemCount(); i++)
-                {
-                    wxString matched_sample = serializer.DeserializeShowFileExtension() ?
-                        SampleHive::cHiveData::Get().GetListCtrlTextValue(i, 1).BeforeLast('.') :
-                        SampleHive::cHiveData::Get().GetListCtrlTextValue(i, 1);
-
-                    wxString selected_sample_name = serializer.DeserializeShowFileExtension() ?
-                        m_pHives->GetItemText(event.GetItem()).BeforeLast('.') :
-                        m_pHives->GetItemText(event.GetItem());
-
-                    if (selected_sample_name == matched_sample)
-                    {
-                        SH_LOG_DEBUG("Found match");
+            {
+                int64_t id = SampleHive::cHiveData::Get().GetHiveItemSampleID(selected_hive);
 
-                        SampleHive::cHiveData::Get().ListCtrlSetVariant(wxVariant(wxBitmap(ICON_STAR_EMPTY_16px, wxBITMAP_TYPE_PNG)), i, 0);
+                wxString msg = wxString::Format(_("Removed %s from %s"), m_pHives->GetItemText(selected_hive),
+                                                db.GetHiveByID(id));
 
-                        db.UpdateFavoriteColumn(matched_sample.ToStdString(), 0);
-                        db.UpdateHiveName(matched_sample.ToStdString(), m_pHives->GetItemText(m_FavoritesHive).ToStdString());
+                int row = SampleHive::cHiveData::Get().GetListCtrlRowFromSampleID(id);
 
-                        m_pHives->DeleteItem(selected_hive);
+                if (row != wxNOT_FOUND)
+                    SampleHive::cHiveData::Get().ListCtrlSetFavorite(row, false);
 
-                        break;
-                    }
+                db.UpdateFavoriteColumn(id, 0);
+                db.UpdateHiveName(id, m_pHives->GetItemText(m_FavoritesHive).ToStdString());
 
-                    wxString msg = wxString::Format(_("Removed %s from %s"), m_pHives->GetItemText(event.GetItem()),
-                                                    db.GetHiveByFilename(matched_sample.ToStdString()));
+                m_pHives->DeleteItem(selected_hive);
 
-                    SampleHive::cSignal::SendInfoBarMessage(msg, wxICON_INFORMATION, *this);
-                }
+                SampleHive::cSignal::SendInfoBarMessage(msg, wxICON_INFORMATION, *this);
+            }
                 break;
             case SampleHive::ID::MN_ShowInLibrary:
-                for (int i = 0; i < SampleHive::cHiveData::Get().GetListCtrlItemCount(); i++)
-                {
-                    wxString matched_sample = serializer.DeserializeShowFileExtension() ?
-                        SampleHive::cHiveData::Get().GetListCtrlTextValue(i, 1).BeforeLast('.') :
-                        SampleHive::cHiveData::Get().GetListCtrlTextValue(i, 1);
-
-                    wxString selected_sample_name = serializer.DeserializeShowFileExtension() ?
-                        m_pHives->GetItemText(event.GetItem()).BeforeLast('.') :
-                        m_pHives->GetItemText(event.GetItem());
-
-                    if (selected_sample_name == matched_sample)
-                    {
-                        SH_LOG_DEBUG("Found match");
-
-                        wxDataViewItem matched_item = SampleHive::cHiveData::Get().GetListCtrlItemFromRow(i);
+            {
+                int row = SampleHive::cHiveData::Get()
+                    .GetListCtrlRowFromSampleID(SampleHive::cHiveData::Get().GetHiveItemSampleID(selected_hive));
 
-                        SampleHive::cHiveData::Get().ListCtrlUnselectAllItems();
-                        SampleHive::cHiveData::Get().ListCtrlSelectRow(i);
-                        SampleHive::cHiveData::Get().ListCtrlEnsureVisible(matched_item);
+                if (row != wxNOT_FOUND)
+                {
+                    wxDataViewItem matched_item = SampleHive::cHiveData::Get().GetListCtrlItemFromRow(row);
 
-                        break;
-                    }
+                    SampleHive::cHiveData::Get().ListCtrlUnselectAllItems();
+                    SampleHive::cHiveData::Get().ListCtrlSelectRow(row);
+                    SampleHive::cHiveData::Get().ListCtrlEnsureVisible(matched_item);
                 }
+            }
                 break;
             default:
                 return;
@@ -544,7 +488,7 @@ void cHivesPanel::OnHiveStartEditing(wxDataViewEvent &event)
 
 void cHivesPanel::OnClickAddHive(wxCommandEvent& event)
 {
-    cDatabase db;
+    cDatabase& db = cDatabase::Get();
 
     std::deque<wxDataViewItem> nodes;
     nodes.push_back(m_pHives->GetNthChild(wxDataViewItem(wxNullPtr), 0));
@@ -618,8 +562,7 @@ void cHivesPanel::OnClickAddHive(wxCommandEvent& event)
 
 void cHivesPanel::OnClickRemoveHive(wxCommandEvent& event)
 {
-    SampleHive::cSerializer serializer;
-    cDatabase db;
+    cDatabase& db = cDatabase::Get();
 
     wxDataViewItem selected_item = m_pHives->GetSelection();
     wxString hive_name = m_pHives->GetItemText(selected_item);
@@ -680,34 +623,19 @@ void cHivesPanel::OnClickRemoveHive(wxCommandEvent& event)
                 {
                     wxDataViewItem child_item;
 
-                    for (int i = 0; i < SampleHive::cHiveData::Get().GetListCtrlItemCount(); i++)
+                    for (int j = 0; j < m_pHives->GetChildCount(selected_item); j++)
                     {
-                        wxString matched_sample = serializer.DeserializeShowFileExtension() ?
-                            SampleHive::cHiveData::Get().GetListCtrlTextValue(i, 1).BeforeLast('.') :
-                            SampleHive::cHiveData::Get().GetListCtrlTextValue(i, 1);
-
-                        for (int j = 0; j < m_pHives->GetChildCount(selected_item); j++)
-                        {
-                            child_item = m_pHives->GetNthChild(selected_item, j);
+                        child_item = m_pHives->GetNthChild(selected_item, j);
 
-                            wxString child_name = serializer.DeserializeShowFileExtension() ?
-                                m_pHives->GetItemText(child_item).BeforeLast('.') :
-                                m_pHives->GetItemText(child_item);
-
-                            if (child_name == matched_sample)
-                            {
-                                SH_LOG_DEBUG("Found match");
+                        int64_t id = SampleHive::cHiveData::Get().GetHiveItemSampleID(child_item);
 
-                                SampleHive::cHiveData::Get().ListCtrlSetVariant(wxVariant(wxBitmap(ICON_STAR_EMPTY_16px, wxBITMAP_TYPE_PNG)), i, 0);
+                        db.UpdateFavoriteColumn(id, 0);
+                        db.UpdateHiveName(id, m_pHives->GetItemText(m_FavoritesHive).ToStdString());
 
-                                db.UpdateFavoriteColumn(matched_sample.ToStdString(), 0);
-                                db.UpdateHiveName(matched_sample.ToStdString(), m_pHives->GetItemText(m_FavoritesHive).ToStdString());
+                        int row = SampleHive::cHiveData::Get().GetListCtrlRowFromSampleID(id);
 
-                                break;
-                            }
-                            else
-                                SH_LOG_DEBUG("No match found");
-                        }
+                        if (row != wxNOT_FOUND)
+                            SampleHive::cHiveData::Get().ListCtrlSetFavorite(row, false);
                     }
 
                     m_pHives->DeleteChildren(selected_item);
@@ -0,0 +1,147 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "GUI/ImportStatus.hpp"
+#include "Utility/ControlIDs.hpp"
+
+#include <algorithm>
+
+#include <wx/gdicmn.h>
+#include <wx/intl.h>
+#include <wx/string.h>
+
+cImportStatus::cImportStatus(wxWindow* window)
+    : wxPanel(window, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxTAB_TRAVERSAL | wxNO_BORDER)
+{
+    m_pMainSizer = new wxBoxSizer(wxHORIZONTAL);
+
+    m_pStatusText = new wxStaticText(this, wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize,
+                                     wxST_ELLIPSIZE_END);
+
+    m_pGauge = new wxGauge(this, wxID_ANY, 100, wxDefaultPosition, wxSize(80, -1), wxGA_HORIZONTAL | wxGA_SMOOTH);
+
+    m_pPauseButton = new wxToggleButton(this, SampleHive::ID::BC_ImportPause, _("Pause"),
+                                        wxDefaultPosition, wxDefaultSize, wxBU_EXACTFIT);
+    m_pPauseButton->SetToolTip(_("Pause the import"));
+
+    m_pCancelButton = new wxButton(this, SampleHive::ID::BC_ImportCancel, _("Cancel"),
+                                   wxDefaultPosition, wxDefaultSize, wxBU_EXACTFIT);
+    m_pCancelButton->SetToolTip(_("Stop the import, samples added so far are kept"));
+
+    m_pPauseButton->SetWindowVariant(wxWINDOW_VARIANT_SMALL);
+    m_pCancelButton->SetWindowVariant(wxWINDOW_VARIANT_SMALL);
+
+    m_pMainSizer->Add(m_pStatusText, 1, wxLEFT | wxRIGHT | wxALIGN_CENTER_VERTICAL, 2);
+    m_pMainSizer->Add(m_pGauge, 0, wxLEFT | wxRIGHT | wxALIGN_CENTER_VERTICAL, 2);
+    m_pMainSizer->Add(m_pPauseButton, 0, wxLEFT | wxALIGN_CENTER_VERTICAL, 2);
+    m_pMainSizer->Add(m_pCancelButton, 0, wxLEFT | wxALIGN_CENTER_VERTICAL, 2);
+
+    this->SetSizer(m_pMainSizer);
+    m_pMainSizer->Layout();
+
+    Bind(wxEVT_TOGGLEBUTTON, &cImportStatus::OnClickPause, this, SampleHive::ID::BC_ImportPause);
+    Bind(wxEVT_BUTTON, &cImportStatus::OnClickCancel, this, SampleHive::ID::BC_ImportCancel);
+
+    // Nothing to show until an import starts
+    Hide();
+
+    SampleHive::cImportJobs::Get().SetStatusHandler([this](const SampleHive::cImportJobs::Status& status)
+    {
+        SetStatus(status);
+    });
+}
+
+void cImportStatus::SetStatus(const SampleHive::cImportJobs::Status& status)
+{
+    if (!status.bActive)
+    {
+        Hide();
+        return;
+    }
+
+    const auto& progress = status.Progress;
+
+    wxString text;
+
+    if (status.bCancelling)
+        text = _("Cancelling import");
+    else if (progress.bWalking)
+        text = wxString::Format(_("Importing, %lu found"), static_cast<unsigned long>(progress.Found));
+    else
+        text = wxString::Format(_("Importing %lu of %lu"), static_cast<unsigned long>(progress.Analysed),
+                                static_cast<unsigned long>(progress.Found));
+
+    if (status.bPaused)
+        text = wxString::Format(_("Paused, %s"), text);
+
+    if (status.Queued > 0)
+        text += wxString::Format(_(" (%lu more queued)"), static_cast<unsigned long>(status.Queued));
+
+    m_pStatusText->SetLabel(text);
+
+    m_pStatusText->SetToolTip(wxString::Format(_("%lu added, %lu already in the library, %lu updated, %lu failed"),
+                                               static_cast<unsigned long>(progress.Inserted),
+                                               static_cast<unsigned long>(progress.Skipped),
+                                               static_cast<unsigned long>(progress.Refreshed),
+                                               static_cast<unsigned long>(progress.Failed)));
+
+    // The total is not known while the walk is still finding files
+    if (progress.bWalking)
+    {
+        if (!status.bPaused)
+            m_pGauge->Pulse();
+    }
+    else
+    {
+        m_pGauge->SetRange(static_cast<int>(std::max<size_t>(progress.Found, 1)));
+        m_pGauge->SetValue(static_cast<int>(std::min(progress.Analysed, progress.Found)));
+    }
+
+    m_pPauseButton->SetValue(status.bPaused);
+    m_pPauseButton->SetLabel(status.bPaused ? _("Resume") : _("Pause"));
+
+    // Nothing left to pause or cancel until the threads are out
+    m_pPauseButton->Enable(!status.bCancelling);
+    m_pCancelButton->Enable(!status.bCancelling);
+
+    if (!IsShown())
+    {
+        Show();
+        m_pMainSizer->Layout();
+    }
+}
+
+void cImportStatus::OnClickPause(wxCommandEvent& event)
+{
+    if (m_pPauseButton->GetValue())
+        SampleHive::cImportJobs::Get().Pause();
+    else
+        SampleHive::cImportJobs::Get().Resume();
+}
+
+void cImportStatus::OnClickCancel(wxCommandEvent& event)
+{
+    SampleHive::cImportJobs::Get().Cancel();
+}
+
+cImportStatus::~cImportStatus()
+{
+    SampleHive::cImportJobs::Get().SetStatusHandler(nullptr);
+}
@@ -0,0 +1,59 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Utility/ImportJobs.hpp"
+
+#include <wx/button.h>
+#include <wx/event.h>
+#include <wx/gauge.h>
+#include <wx/panel.h>
+#include <wx/sizer.h>
+#include <wx/stattext.h>
+#include <wx/tglbtn.h>
+#include <wx/window.h>
+
+// Sits in the status bar while imports run in the background, shows how far
+// the current one got and lets it be paused or cancelled
+class cImportStatus : public wxPanel
+{
+    public:
+        cImportStatus(wxWindow* window);
+        ~cImportStatus();
+
+    public:
+        // -------------------------------------------------------------------
+        void SetStatus(const SampleHive::cImportJobs::Status& status);
+
+    private:
+        // -------------------------------------------------------------------
+        void OnClickPause(wxCommandEvent& event);
+        void OnClickCancel(wxCommandEvent& event);
+
+    private:
+        // -------------------------------------------------------------------
+        wxBoxSizer* m_pMainSizer = nullptr;
+
+        wxStaticText* m_pStatusText = nullptr;
+        wxGauge* m_pGauge = nullptr;
+        wxToggleButton* m_pPauseButton = nullptr;
+        wxButton* m_pCancelButton = nullptr;
+};
@@ -39,7 +39,7 @@ class cLibrary : public wxPanel
     public:
         wxSearchCtrl* GetSearchCtrlObject() const { return m_pSearchBar; }
         wxInfoBar* GetInfoBarObject() const { return m_pInfoBar; }
-        wxDataViewListCtrl* GetListCtrlObject() const { return m_pListCtrl; }
+        cListCtrl* GetListCtrlObject() const { return m_pListCtrl; }
 
     private:
         cSearchBar* m_pSearchBar = nullptr;
@@ -30,25 +30,35 @@
 #include "Utility/Paths.hpp"
 #include "Utility/Utils.hpp"
 
-#include <wx/dir.h>
+#include <algorithm>
+
 #include <wx/gdicmn.h>
 #include <wx/menu.h>
-#include <wx/progdlg.h>
 #include <wx/msgdlg.h>
 
 cListCtrl::cListCtrl(wxWindow* window)
-    : wxDataViewListCtrl(window, SampleHive::ID::BC_Library, wxDefaultPosition, wxDefaultSize,
-                         wxDV_MULTIPLE | wxDV_HORIZ_RULES | wxDV_VERT_RULES | wxDV_ROW_LINES),
+    : wxDataViewCtrl(window, SampleHive::ID::BC_Library, wxDefaultPosition, wxDefaultSize,
+                     wxDV_MULTIPLE | wxDV_HORIZ_RULES | wxDV_VERT_RULES | wxDV_ROW_LINES),
       m_pWindow(window)
 {
-    // Adding columns to wxDataViewListCtrl.
+    SampleHive::cSerializer serializer;
+
+    // The control keeps the model alive, our reference is dropped right away
+    m_pModel = new cSampleListModel();
+    m_pModel->SetShowExtension(serializer.DeserializeShowFileExtension());
+
+    AssociateModel(m_pModel);
+    m_pModel->DecRef();
+
+    // Adding columns to wxDataViewCtrl.
     AppendBitmapColumn(wxBitmap(ICON_STAR_FILLED_16px, wxBITMAP_TYPE_PNG),
-                       0,
+                       cSampleListModel::Col_Favorite,
                        wxDATAVIEW_CELL_ACTIVATABLE,
                        30,
                        wxALIGN_CENTER,
                        !wxDATAVIEW_COL_RESIZABLE);
     AppendTextColumn(_("Filename"),
+                     cSampleListModel::Col_Filename,
                      wxDATAVIEW_CELL_INERT,
                      250,
                      wxALIGN_LEFT,
@@ -56,6 +66,7 @@ cListCtrl::cListCtrl(wxWindow* window)
                      wxDATAVIEW_COL_SORTABLE |
                      wxDATAVIEW_COL_REORDERABLE);
     AppendTextColumn(_("Sample Pack"),
+                     cSampleListModel::Col_SamplePack,
                      wxDATAVIEW_CELL_INERT,
                      180,
                      wxALIGN_LEFT,
@@ -63,6 +74,7 @@ cListCtrl::cListCtrl(wxWindow* window)
                      wxDATAVIEW_COL_SORTABLE |
                      wxDATAVIEW_COL_REORDERABLE);
     AppendTextColumn(_("Type"),
+                     cSampleListModel::Col_Type,
                      wxDATAVIEW_CELL_INERT,
                      120,
                      wxALIGN_LEFT,
@@ -70,6 +82,7 @@ cListCtrl::cListCtrl(wxWindow* window)
                      wxDATAVIEW_COL_SORTABLE |
                      wxDATAVIEW_COL_REORDERABLE);
     AppendTextColumn(_("Channels"),
+                     cSampleListModel::Col_Channels,
                      wxDATAVIEW_CELL_INERT,
                      90,
                      wxALIGN_RIGHT,
@@ -77,6 +90,7 @@ cListCtrl::cListCtrl(wxWindow* window)
                      wxDATAVIEW_COL_SORTABLE |
                      wxDATAVIEW_COL_REORDERABLE);
     AppendTextColumn(_("BPM"),
+                     cSampleListModel::Col_BPM,
                      wxDATAVIEW_CELL_INERT,
                      80,
                      wxALIGN_RIGHT,
@@ -84,6 +98,7 @@ cListCtrl::cListCtrl(wxWindow* window)
                      wxDATAVIEW_COL_SORTABLE |
                      wxDATAVIEW_COL_REORDERABLE);
     AppendTextColumn(_("Length"),
+                     cSampleListModel::Col_Length,
                      wxDATAVIEW_CELL_INERT,
                      80,
                      wxALIGN_RIGHT,
@@ -91,6 +106,7 @@ cListCtrl::cListCtrl(wxWindow* window)
                      wxDATAVIEW_COL_SORTABLE |
                      wxDATAVIEW_COL_REORDERABLE);
     AppendTextColumn(_("Sample Rate"),
+                     cSampleListModel::Col_SampleRate,
                      wxDATAVIEW_CELL_INERT,
                      120,
                      wxALIGN_RIGHT,
@@ -98,6 +114,7 @@ cListCtrl::cListCtrl(wxWindow* window)
                      wxDATAVIEW_COL_SORTABLE |
                      wxDATAVIEW_COL_REORDERABLE);
     AppendTextColumn(_("Bitrate"),
+                     cSampleListModel::Col_Bitrate,
                      wxDATAVIEW_CELL_INERT,
                      80,
                      wxALIGN_RIGHT,
@@ -105,6 +122,7 @@ cListCtrl::cListCtrl(wxWindow* window)
                      wxDATAVIEW_COL_SORTABLE |
                      wxDATAVIEW_COL_REORDERABLE);
     AppendTextColumn(_("Path"),
+                     cSampleListModel::Col_Path,
                      wxDATAVIEW_CELL_INERT,
                      250,
                      wxALIGN_LEFT,
@@ -124,11 +142,12 @@ cListCtrl::cListCtrl(wxWindow* window)
     this->Connect(wxEVT_DROP_FILES, wxDropFilesEventHandler(cListCtrl::OnDragAndDropToLibrary), NULL, this);
     Bind(wxEVT_COMMAND_DATAVIEW_ITEM_CONTEXT_MENU, &cListCtrl::OnShowLibraryContextMenu, this, SampleHive::ID::BC_Library);
     Bind(wxEVT_DATAVIEW_COLUMN_HEADER_RIGHT_CLICK, &cListCtrl::OnShowLibraryColumnHeaderContextMenu, this, SampleHive::ID::BC_Library);
+    Bind(wxEVT_DATAVIEW_COLUMN_SORTED, &cListCtrl::OnSortLibrary, this, SampleHive::ID::BC_Library);
 }
 
 void cListCtrl::OnClickLibrary(wxDataViewEvent& event)
 {
-    cDatabase db;
+    cDatabase& db = cDatabase::Get();
 
     int selected_row = this->ItemToRow(event.GetItem());
     int current_row = this->ItemToRow(this->GetCurrentItem());
@@ -162,9 +181,7 @@ void cListCtrl::OnClickLibrary(wxDataViewEvent& event)
     if (!CurrentColumn)
         return;
 
-    wxString sample_path = SampleHive::cUtils::Get().GetFilenamePathAndExtension(selection).Path;
-    std::string filename = SampleHive::cUtils::Get().GetFilenamePathAndExtension(selection).Filename;
-    std::string extension = SampleHive::cUtils::Get().GetFilenamePathAndExtension(selection).Extension;
+    int64_t sample_id = SampleHive::cHiveData::Get().GetListCtrlSampleID(selected_row);
 
     if (CurrentColumn != FavoriteColumn)
     {
@@ -172,7 +189,8 @@ void cListCtrl::OnClickLibrary(wxDataViewEvent& event)
         SampleHive::cSignal::SendClearLoopPointsStatus(*this);
 
         // Play the sample
-        SampleHive::cSignal::SendCallFunctionPlay(selection, true, *this);
+        SampleHive::cSignal::SendCallFunctionPlay(selection, SampleHive::cHiveData::Get().GetListCtrlSamplePath(selected_row),
+                                                  true, *this);
     }
     else
     {
@@ -192,14 +210,13 @@ void cListCtrl::OnClickLibrary(wxDataViewEvent& event)
         // Get root
         wxDataViewItem root = wxDataViewItem(wxNullPtr);
         wxDataViewItem container;
-        wxDataViewItem child;
 
-        if (db.GetFavoriteColumnValueByFilename(filename) == 0)
+        if (db.GetFavoriteColumnValueByID(sample_id) == 0)
         {
-            this->SetValue(wxVariant(wxBitmap(ICON_STAR_FILLED_16px, wxBITMAP_TYPE_PNG)), selected_row, 0);
+            m_pModel->SetFavorite(selected_row, true);
 
-            db.UpdateFavoriteColumn(filename, 1);
-            db.UpdateHiveName(filename, hive_name);
+            db.UpdateFavoriteColumn(sample_id, 1);
+            db.UpdateHiveName(sample_id, hive_name);
 
             for (int i = 0; i < SampleHive::cHiveData::Get().GetHiveChildCount(root); i++)
             {
@@ -207,7 +224,7 @@ void cListCtrl::OnClickLibrary(wxDataViewEvent& event)
 
                 if (SampleHive::cHiveData::Get().GetHiveItemText(false, container) == hive_name)
                 {
-                    SampleHive::cHiveData::Get().HiveAppendItem(container, name);
+                    SampleHive::cHiveData::Get().HiveAppendItem(container, name, sample_id);
                     break;
                 }
             }
@@ -216,26 +233,12 @@ void cListCtrl::OnClickLibrary(wxDataViewEvent& event)
         }
         else
         {
-            this->SetValue(wxVariant(wxBitmap(ICON_STAR_EMPTY_16px, wxBITMAP_TYPE_PNG)), selected_row, 0);
+            m_pModel->SetFavorite(selected_row, false);
 
-            db.UpdateFavoriteColumn(filename, 0);
-            db.UpdateHiveName(filename, SampleHive::cHiveData::Get().GetHiveItemText(true).ToStdString());
+            db.UpdateFavoriteColumn(sample_id, 0);
+            db.UpdateHiveName(sample_id, SampleHive::cHiveData::Get().GetHiveItemText(true).ToStdString());
 
-            for (int i = 0; i < SampleHive::cHiveData::Get().GetHiveChildCount(root); i++)
-            {
-                container = SampleHive::cHiveData::Get().GetHiveNthChild(root, i);
-
-                for (int j = 0; j < SampleHive::cHiveData::Get().GetHiveChildCount(container); j++)
-                {
-                    child = SampleHive::cHiveData::Get().GetHiveNthChild(container, j);
-
-                    if (SampleHive::cHiveData::Get().GetHiveItemText(false, child) == name)
-                    {
-                        SampleHive::cHiveData::Get().HiveDeleteItem(child);
-                        break;
-                    }
-                }
-            }
+            SampleHive::cHiveData::Get().HiveDeleteSampleItem(sample_id);
 
             msg = wxString::Format(_("Removed %s from %s"), name, hive_name);
         }
@@ -247,7 +250,7 @@ void cListCtrl::OnClickLibrary(wxDataViewEvent& event)
 
 void cListCtrl::OnDoubleClickLibrary(wxDataViewEvent& event)
 {
-    cDatabase db;
+    cDatabase& db = cDatabase::Get();
     SampleHive::cSerializer serializer;
 
     int selected_row = this->ItemToRow(event.GetItem());
@@ -289,7 +292,9 @@ void cListCtrl::OnDoubleClickLibrary(wxDataViewEvent& event)
 
         // Play the sample
         if (serializer.DeserializeDoubleClickToPlay())
-            SampleHive::cSignal::SendCallFunctionPlay(selection, false, *this);
+            SampleHive::cSignal::SendCallFunctionPlay(selection,
+                                                      SampleHive::cHiveData::Get().GetListCtrlSamplePath(selected_row),
+                                                      false, *this);
     }
 }
 
@@ -302,40 +307,12 @@ void cListCtrl::OnDragAndDropToLibrary(wxDropFilesEvent& event)
         wxString* dropped = event.GetFiles();
         wxASSERT(dropped);
 
-        wxBusyCursor busy_cursor;
-        wxWindowDisabler window_disabler;
-
-        wxString name;
-        wxString filepath;
+        // Directories are walked by the import itself, which only picks up
+        // the audio files in them
         wxArrayString filepath_array;
 
-        wxProgressDialog* progressDialog = new wxProgressDialog(_("Reading files.."),
-                                                                _("Reading files, please wait..."),
-                                                                event.GetNumberOfFiles(), this,
-                                                                wxPD_APP_MODAL | wxPD_SMOOTH |
-                                                                wxPD_CAN_ABORT | wxPD_AUTO_HIDE);
-
-        progressDialog->CenterOnParent(wxBOTH);
-
-        wxYield();
-
         for (int i = 0; i < event.GetNumberOfFiles(); i++)
-        {
-            filepath = dropped[i];
-
-            if (wxFileExists(filepath))
-            {
-                filepath_array.push_back(filepath);
-            }
-            else if (wxDirExists(filepath))
-            {
-                wxDir::GetAllFiles(filepath, &filepath_array);
-            }
-
-            progressDialog->Pulse(_("Reading Samples"), NULL);
-        }
-
-        progressDialog->Destroy();
+            filepath_array.push_back(dropped[i]);
 
         SampleHive::cUtils::Get().AddSamples(filepath_array, m_pWindow);
 
@@ -350,9 +327,7 @@ void cListCtrl::OnDragFromLibrary(wxDataViewEvent& event)
     if (selected_row < 0)
         return;
 
-    wxString selection = this->GetTextValue(selected_row, 1);
-
-    wxString sample_path = SampleHive::cUtils::Get().GetFilenamePathAndExtension(selection).Path;
+    wxString sample_path = cDatabase::Get().GetSamplePathByID(SampleHive::cHiveData::Get().GetListCtrlSampleID(selected_row));
 
     wxFileDataObject* fileData = new wxFileDataObject();
 
@@ -365,8 +340,7 @@ void cListCtrl::OnDragFromLibrary(wxDataViewEvent& event)
 void cListCtrl::OnShowLibraryContextMenu(wxDataViewEvent& event)
 {
     cTagEditor* tagEditor;
-    cDatabase db;
-    SampleHive::cSerializer serializer;
+    cDatabase& db = cDatabase::Get();
 
     wxString msg;
 
@@ -380,16 +354,15 @@ void cListCtrl::OnShowLibraryContextMenu(wxDataViewEvent& event)
 
     wxString selection = this->GetTextValue(selected_row, 1);
 
-    wxString sample_path = SampleHive::cUtils::Get().GetFilenamePathAndExtension(selection).Path;
-    std::string filename = SampleHive::cUtils::Get().GetFilenamePathAndExtension(selection).Filename;
-    std::string extension = SampleHive::cUtils::Get().GetFilenamePathAndExtension(selection).Extension;
+    int64_t sample_id = SampleHive::cHiveData::Get().GetListCtrlSampleID(selected_row);
+    wxString sample_path = db.GetSamplePathByID(sample_id);
 
     wxMenu menu;
 
     //true = add false = remove
     bool favorite_add = false;
 
-    if (db.GetFavoriteColumnValueByFilename(filename) == 1)
+    if (db.GetFavoriteColumnValueByID(sample_id) == 1)
         menu.Append(SampleHive::ID::MN_FavoriteSample, _("Remove from hive"), _("Remove the selected sample(s) from hive"));
     else
     {
@@ -428,7 +401,6 @@ void cListCtrl::OnShowLibraryContextMenu(wxDataViewEvent& event)
 
             wxDataViewItem root = wxDataViewItem(wxNullPtr);
             wxDataViewItem container;
-            wxDataViewItem child;
 
             wxDataViewItemArray samples;
             int sample_count = this->GetSelections(samples);
@@ -444,10 +416,9 @@ void cListCtrl::OnShowLibraryContextMenu(wxDataViewEvent& event)
 
                 wxString name = this->GetTextValue(selected_row, 1);
 
-                filename = serializer.DeserializeShowFileExtension() ?
-                    name.BeforeLast('.').ToStdString() : name.ToStdString();
+                int64_t id = SampleHive::cHiveData::Get().GetListCtrlSampleID(selected_row);
 
-                db_status = db.GetFavoriteColumnValueByFilename(filename);
+                db_status = db.GetFavoriteColumnValueByID(id);
 
                 // Aleady Added, Do Nothing
                 if (favorite_add && db_status == 1)
@@ -460,10 +431,10 @@ void cListCtrl::OnShowLibraryContextMenu(wxDataViewEvent& event)
                 // Add To Favorites
                 if (favorite_add && db_status == 0)
                 {
-                    this->SetValue(wxVariant(wxBitmap(ICON_STAR_FILLED_16px, wxBITMAP_TYPE_PNG)), selected_row, 0);
+                    m_pModel->SetFavorite(selected_row, true);
 
-                    db.UpdateFavoriteColumn(filename, 1);
-                    db.UpdateHiveName(filename, hive_name);
+                    db.UpdateFavoriteColumn(id, 1);
+                    db.UpdateHiveName(id, hive_name);
 
                     for (int i = 0; i < SampleHive::cHiveData::Get().GetHiveChildCount(root); i++)
                     {
@@ -471,7 +442,7 @@ void cListCtrl::OnShowLibraryContextMenu(wxDataViewEvent& event)
 
                         if (SampleHive::cHiveData::Get().GetHiveItemText(false, container) == hive_name)
                         {
-                            SampleHive::cHiveData::Get().HiveAppendItem(container, name);
+                            SampleHive::cHiveData::Get().HiveAppendItem(container, name, id);
 
                             msg = wxString::Format(_("Added %s to %s"), name, hive_name);
                             break;
@@ -481,28 +452,14 @@ void cListCtrl::OnShowLibraryContextMenu(wxDataViewEvent& event)
                 else
                 {
                     //Remove From Favorites
-                    this->SetValue(wxVariant(wxBitmap(ICON_STAR_EMPTY_16px, wxBITMAP_TYPE_PNG)), selected_row, 0);
+                    m_pModel->SetFavorite(selected_row, false);
 
-                    db.UpdateFavoriteColumn(filename, 0);
-                    db.UpdateHiveName(filename, SampleHive::cHiveData::Get().GetHiveItemText(true).ToStdString());
-
-                    for (int i = 0; i < SampleHive::cHiveData::Get().GetHiveChildCount(root); i++)
-                    {
-                        container = SampleHive::cHiveData::Get().GetHiveNthChild(root, i);
-
-                        for (int j = 0; j < SampleHive::cHiveData::Get().GetHiveChildCount(container); j++)
-                        {
-                            child = SampleHive::cHiveData::Get().GetHiveNthChild(container, j);
+                    db.UpdateFavoriteColumn(id, 0);
+                    db.UpdateHiveName(id, SampleHive::cHiveData::Get().GetHiveItemText(true).ToStdString());
 
-                            if (SampleHive::cHiveData::Get().GetHiveItemText(false, child) == name)
-                            {
-                                SampleHive::cHiveData::Get().HiveDeleteItem(child);
+                    SampleHive::cHiveData::Get().HiveDeleteSampleItem(id);
 
-                                msg = wxString::Format(_("Removed %s from %s"), name, hive_name);
-                                break;
-                            }
-                        }
-                    }
+                    msg = wxString::Format(_("Removed %s from %s"), name, hive_name);
                 }
             }
 
@@ -525,39 +482,16 @@ void cListCtrl::OnShowLibraryContextMenu(wxDataViewEvent& event)
                                               wxMessageBoxCaptionStr,
                                               wxYES_NO | wxNO_DEFAULT | wxICON_QUESTION | wxSTAY_ON_TOP | wxCENTER);
 
-            wxDataViewItem root = wxDataViewItem(wxNullPtr);
-            wxDataViewItem container;
-            wxDataViewItem child;
-
             if (this->GetSelectedItemsCount() <= 1)
             {
                 switch (singleMsgDialog.ShowModal())
                 {
                     case wxID_YES:
                     {
-                        db.RemoveSampleFromDatabase(filename);
+                        db.RemoveSampleFromDatabase(sample_id);
                         this->DeleteItem(selected_row);
 
-                        for (int j = 0; j < SampleHive::cHiveData::Get().GetHiveChildCount(root); j++)
-                        {
-                            container = SampleHive::cHiveData::Get().GetHiveNthChild(root, j);
-
-                            for (int k = 0; k < SampleHive::cHiveData::Get().GetHiveChildCount(container); k++)
-                            {
-                                child = SampleHive::cHiveData::Get().GetHiveNthChild(container, k);
-
-                                wxString child_text = serializer.DeserializeShowFileExtension() ?
-                                    SampleHive::cHiveData::Get().GetHiveItemText(false, child).BeforeLast('.') :
-                                    SampleHive::cHiveData::Get().GetHiveItemText(false, child);
-
-                                if (child_text == filename)
-                                {
-                                    SampleHive::cHiveData::Get().HiveDeleteItem(child);
-
-                                    break;
-                                }
-                            }
-                        }
+                        SampleHive::cHiveData::Get().HiveDeleteSampleItem(sample_id);
 
                         msg = wxString::Format(_("Deleted %s from database successfully"), selection);
                     }
@@ -576,37 +510,17 @@ void cListCtrl::OnShowLibraryContextMenu(wxDataViewEvent& event)
                 {
                     case wxID_YES:
                     {
-                        for (int i = 0; i < rows; i++)
+                        for (int row : this->GetSelectedRows())
                         {
-                            int row = this->ItemToRow(items[i]);
 
                             wxString text_value = this->GetTextValue(row, 1);
 
-                            std::string multi_selection = serializer.DeserializeShowFileExtension() ?
-                                text_value.BeforeLast('.').ToStdString() : text_value.ToStdString() ;
+                            int64_t id = SampleHive::cHiveData::Get().GetListCtrlSampleID(row);
 
-                            db.RemoveSampleFromDatabase(multi_selection);
+                            db.RemoveSampleFromDatabase(id);
                             this->DeleteItem(row);
 
-                            for (int j = 0; j < SampleHive::cHiveData::Get().GetHiveChildCount(root); j++)
-                            {
-                                container = SampleHive::cHiveData::Get().GetHiveNthChild(root, j);
-
-                                for (int k = 0; k < SampleHive::cHiveData::Get().GetHiveChildCount(container); k++)
-                                {
-                                    child = SampleHive::cHiveData::Get().GetHiveNthChild(container, k);
-
-                                    wxString child_text = serializer.DeserializeShowFileExtension() ?
-                                        SampleHive::cHiveData::Get().GetHiveItemText(false, child).BeforeLast('.') :
-                                        SampleHive::cHiveData::Get().GetHiveItemText(false, child);
-
-                                    if (child_text == multi_selection)
-                                    {
-                                        SampleHive::cHiveData::Get().HiveDeleteItem(child);
-                                        break;
-                                    }
-                                }
-                            }
+                            SampleHive::cHiveData::Get().HiveDeleteSampleItem(id);
 
                             msg = wxString::Format(_("Deleted %s from database successfully"), text_value);
                         }
@@ -624,67 +538,32 @@ void cListCtrl::OnShowLibraryContextMenu(wxDataViewEvent& event)
         break;
         case SampleHive::ID::MN_TrashSample:
         {
-            wxDataViewItem root = wxDataViewItem(wxNullPtr);
-            wxDataViewItem container, child;
-
-            if (db.IsTrashed(filename))
-                SH_LOG_INFO("{} already trashed", filename);
+            if (db.IsTrashed(sample_id))
+                SH_LOG_INFO("{} already trashed", selection);
             else
             {
-                wxDataViewItemArray items;
-                int rows = this->GetSelections(items);
-
-                wxString name;
-                wxFileDataObject file_data;
-                wxArrayString files;
-
-                for (int i = 0; i < rows; i++)
+                for (int item_row : this->GetSelectedRows())
                 {
-                    int item_row = this->ItemToRow(items[i]);
 
                     wxString text_value = this->GetTextValue(item_row, 1);
 
-                    std::string multi_selection = serializer.DeserializeShowFileExtension() ?
-                        this->GetTextValue(item_row, 1).BeforeLast('.').ToStdString() :
-                        this->GetTextValue(item_row, 1).ToStdString() ;
-
-                    file_data.AddFile(multi_selection);
+                    int64_t id = SampleHive::cHiveData::Get().GetListCtrlSampleID(item_row);
 
-                    files = file_data.GetFilenames();
-
-                    if (db.GetFavoriteColumnValueByFilename(files[i].ToStdString()))
+                    if (db.GetFavoriteColumnValueByID(id))
                     {
-                        this->SetValue(wxVariant(wxBitmap(ICON_STAR_EMPTY_16px, wxBITMAP_TYPE_PNG)), item_row, 0);
+                        m_pModel->SetFavorite(item_row, false);
 
-                        db.UpdateFavoriteColumn(files[i].ToStdString(), 0);
+                        db.UpdateFavoriteColumn(id, 0);
 
-                        for (int j = 0; j < SampleHive::cHiveData::Get().GetHiveChildCount(root); j++)
-                        {
-                            container = SampleHive::cHiveData::Get().GetHiveNthChild(root, j);
-
-                            for (int k = 0; k < SampleHive::cHiveData::Get().GetHiveChildCount(container); k++)
-                            {
-                                child = SampleHive::cHiveData::Get().GetHiveNthChild(container, k);
-
-                                wxString child_text = serializer.DeserializeShowFileExtension() ?
-                                    SampleHive::cHiveData::Get().GetHiveItemText(false, child).BeforeLast('.') :
-                                    SampleHive::cHiveData::Get().GetHiveItemText(false, child);
-
-                                if (child_text == files[i])
-                                {
-                                    SampleHive::cHiveData::Get().HiveDeleteItem(child);
-                                    break;
-                                }
-                            }
-                        }
+                        SampleHive::cHiveData::Get().HiveDeleteSampleItem(id);
                     }
 
-                    SampleHive::cHiveData::Get().TrashAppendItem(SampleHive::cHiveData::Get().GetTrashRoot(), text_value);
+                    SampleHive::cHiveData::Get().TrashAppendItem(SampleHive::cHiveData::Get().GetTrashRoot(), text_value, id);
 
                     this->DeleteItem(item_row);
 
-                    db.UpdateTrashColumn(files[i].ToStdString(), 1);
-                    db.UpdateHiveName(files[i].ToStdString(), SampleHive::cHiveData::Get().GetHiveItemText(true).ToStdString());
+                    db.UpdateTrashColumn(id, 1);
+                    db.UpdateHiveName(id, SampleHive::cHiveData::Get().GetHiveItemText(true).ToStdString());
 
                     msg = wxString::Format(_("%s sent to trash"), text_value);
                 }
@@ -693,7 +572,7 @@ void cListCtrl::OnShowLibraryContextMenu(wxDataViewEvent& event)
         break;
         case SampleHive::ID::MN_EditTagSample:
         {
-            tagEditor = new cTagEditor(this, static_cast<std::string>(sample_path));
+            tagEditor = new cTagEditor(this, static_cast<std::string>(sample_path), sample_id);
 
             switch (tagEditor->ShowModal())
             {
@@ -799,6 +678,38 @@ void cListCtrl::OnShowLibraryColumnHeaderContextMenu(wxDataViewEvent& event)
     }
 }
 
+void cListCtrl::OnSortLibrary(wxDataViewEvent& event)
+{
+    wxDataViewColumn* column = event.GetDataViewColumn();
+
+    if (!column)
+        return;
+
+    m_pModel->Sort(column->GetModelColumn(), column->IsSortOrderAscending());
+}
+
+std::vector<int> cListCtrl::GetSelectedRows() const
+{
+    wxDataViewItemArray items;
+    GetSelections(items);
+
+    std::vector<int> rows;
+
+    for (const auto& item : items)
+    {
+        int row = ItemToRow(item);
+
+        if (row >= 0)
+            rows.push_back(row);
+    }
+
+    // Items of a virtual list are row numbers, so deleting from the back
+    // keeps the remaining ones valid
+    std::sort(rows.rbegin(), rows.rend());
+
+    return rows;
+}
+
 cListCtrl::~cListCtrl()
 {
 
@@ -20,11 +20,15 @@
 
 #pragma once
 
+#include "GUI/SampleListModel.hpp"
+
+#include <vector>
+
 #include <wx/dataview.h>
 #include <wx/treectrl.h>
 #include <wx/window.h>
 
-class cListCtrl : public wxDataViewListCtrl
+class cListCtrl : public wxDataViewCtrl
 {
     public:
         // -------------------------------------------------------------------
@@ -33,7 +37,24 @@ class cListCtrl : public wxDataViewListCtrl
 
     public:
         // -------------------------------------------------------------------
-        wxDataViewListCtrl* GetListCtrlObject() { return this; }
+        cListCtrl* GetListCtrlObject() { return this; }
+        cSampleListModel* GetSampleModel() const { return m_pModel; }
+
+    public:
+        // -------------------------------------------------------------------
+        // Row based access to the virtual model
+        int ItemToRow(const wxDataViewItem& item) const
+                     { return item.IsOk() ? static_cast<int>(m_pModel->GetRow(item)) : wxNOT_FOUND; }
+        wxDataViewItem RowToItem(int row) const { return row < 0 ? wxDataViewItem() : m_pModel->GetItem(row); }
+        int GetSelectedRow() const { return ItemToRow(GetSelection()); }
+        int GetItemCount() const { return static_cast<int>(m_pModel->GetRowCount()); }
+        wxString GetTextValue(unsigned int row, unsigned int col) const { return m_pModel->GetTextValue(row, col); }
+        void SelectRow(unsigned int row) { Select(RowToItem(row)); }
+        void DeleteItem(unsigned int row) { m_pModel->DeleteRow(row); }
+        void DeleteAllItems() { m_pModel->DeleteAllRows(); }
+
+        // Selected rows, last row first so they can be deleted in order
+        std::vector<int> GetSelectedRows() const;
 
     private:
         // -------------------------------------------------------------------
@@ -44,8 +65,12 @@ class cListCtrl : public wxDataViewListCtrl
         void OnDragFromLibrary(wxDataViewEvent& event);
         void OnShowLibraryContextMenu(wxDataViewEvent& event);
         void OnShowLibraryColumnHeaderContextMenu(wxDataViewEvent& event);
+        void OnSortLibrary(wxDataViewEvent& event);
 
     private:
         // -------------------------------------------------------------------
         wxWindow* m_pWindow = nullptr;
+
+        // Owned by the control once associated
+        cSampleListModel* m_pModel = nullptr;
 };
@@ -19,12 +19,19 @@
  */
 
 #include "GUI/MainFrame.hpp"
+#include "GUI/Dialogs/Duplicates.hpp"
 #include "GUI/Dialogs/Settings.hpp"
 #include "Database/Database.hpp"
+#include "Database/QueryProfiler.hpp"
+#include "Utility/ConfigStore.hpp"
 #include "Utility/ControlIDs.hpp"
+#include "Utility/DuplicateJob.hpp"
 #include "Utility/HiveData.hpp"
+#include "Utility/ImportJobs.hpp"
 #include "Utility/Log.hpp"
+#include "Utility/MetadataCache.hpp"
 #include "Utility/Paths.hpp"
+#include "Utility/Trace.hpp"
 #include "Utility/Utils.hpp"
 #include "SampleHiveConfig.hpp"
 
@@ -39,6 +46,7 @@
 #include <wx/menu.h>
 #include <wx/msgdlg.h>
 #include <wx/stringimpl.h>
+#include <wx/utils.h>
 
 cMainFrame::cMainFrame()
     : wxFrame(NULL, wxID_ANY, "SampleHive", wxDefaultPosition)
@@ -52,6 +60,8 @@ cMainFrame::cMainFrame()
 
     m_pHiveBitmap = new wxStaticBitmap(m_pStatusBar, wxID_ANY, wxBitmap(ICON_HIVE_24px, wxBITMAP_TYPE_PNG));
 
+    m_pImportStatus = new cImportStatus(m_pStatusBar);
+
     // Initialize menubar and menus
     m_pMenuBar = new wxMenuBar();
     m_pFileMenu = new wxMenu();
@@ -73,6 +83,9 @@ cMainFrame::cMainFrame()
     m_pFileMenu->Append(wxID_EXIT, wxEmptyString, _("Exits the application"));
 
     // Edit menu items
+    m_pEditMenu->Append(SampleHive::ID::MN_FindDuplicates, _("Find duplicates"),
+                        _("Find samples in the library that have identical audio"));
+    m_pEditMenu->AppendSeparator();
     m_pEditMenu->Append(wxID_PREFERENCES, _("Preferences\tCtrl+P"), _("Open preferences dialog"));
 
     // View menu items
@@ -147,15 +160,17 @@ cMainFrame::cMainFrame()
     m_pTopSplitter->SplitHorizontally(m_pTopPanel, m_pBottomSplitter);
     m_pBottomSplitter->SplitVertically(m_pNotebook, m_pLibrary);
 
-    // Initializing wxMediaCtrl.
-    m_pMediaCtrl = new wxMediaCtrl(this, SampleHive::ID::BC_MediaCtrl, wxEmptyString, wxDefaultPosition,
-                                   wxDefaultSize, 0, wxEmptyString);
+    // Initializing the audio engine, SAMPLEHIVE_AUDIO_BACKEND can pick "alsa", "null" or "wav:<path>"
+    wxString backend;
+    wxGetEnv("SAMPLEHIVE_AUDIO_BACKEND", &backend);
+
+    m_pAudioEngine = new SampleHive::cAudioEngine(SampleHive::cAudioBackend::Create(backend.ToStdString()));
 
     // Intializing wxTimer
     m_pTimer = new wxTimer(this);
 
-    m_pTransportControls = new cTransportControls(m_pTopPanel, *m_pMediaCtrl);
-    m_pWaveformViewer = new cWaveformViewer(m_pTopPanel, *m_pMediaCtrl);
+    m_pTransportControls = new cTransportControls(m_pTopPanel, *m_pAudioEngine);
+    m_pWaveformViewer = new cWaveformViewer(m_pTopPanel, *m_pAudioEngine);
 
     // Binding events.
     Bind(wxEVT_MENU, &cMainFrame::OnSelectAddFile, this, SampleHive::ID::MN_AddFile);
@@ -165,6 +180,7 @@ cMainFrame::cMainFrame()
     Bind(wxEVT_MENU, &cMainFrame::OnSelectToggleMenuBar, this, SampleHive::ID::MN_ToggleMenuBar);
     Bind(wxEVT_MENU, &cMainFrame::OnSelectToggleStatusBar, this, SampleHive::ID::MN_ToggleStatusBar);
     Bind(wxEVT_MENU, &cMainFrame::OnSelectExit, this, wxID_EXIT);
+    Bind(wxEVT_MENU, &cMainFrame::OnSelectFindDuplicates, this, SampleHive::ID::MN_FindDuplicates);
     Bind(wxEVT_MENU, &cMainFrame::OnSelectPreferences, this, wxID_PREFERENCES);
     Bind(wxEVT_MENU, &cMainFrame::OnSelectResetAppData, this, wxID_REFRESH);
     Bind(wxEVT_MENU, &cMainFrame::OnSelectAbout, this, wxID_ABOUT);
@@ -175,10 +191,11 @@ cMainFrame::cMainFrame()
     this->Connect(wxEVT_SIZE, wxSizeEventHandler(cMainFrame::OnResizeFrame), NULL, this);
     m_pStatusBar->Connect(wxEVT_SIZE, wxSizeEventHandler(cMainFrame::OnResizeStatusBar), NULL, this);
 
-    Bind(wxEVT_MEDIA_FINISHED, &cMainFrame::OnMediaFinished, this, SampleHive::ID::BC_MediaCtrl);
-
     Bind(wxEVT_TIMER, &cMainFrame::UpdateElapsedTime, this);
 
+    // The transport controls leave the A-B toggle to us as we own the loop points
+    Bind(wxEVT_TOGGLEBUTTON, &cMainFrame::OnClickLoopABButton, this, SampleHive::ID::BC_LoopABButton);
+
     Bind(SampleHive::SH_EVT_LOOP_POINTS_UPDATED, &cMainFrame::OnRecieveLoopPoints, this);
     Bind(SampleHive::SH_EVT_LOOP_POINTS_CLEAR, &cMainFrame::OnRecieveClearLoopPointsStatus, this);
     Bind(SampleHive::SH_EVT_STATUSBAR_STATUS_PUSH, &cMainFrame::OnRecievePushStatusBarStatus, this);
@@ -215,46 +232,43 @@ cMainFrame::cMainFrame()
     CallAfter(&cMainFrame::SetAfterFrameCreate);
 }
 
-void cMainFrame::OnMediaFinished(wxMediaEvent& event)
+void cMainFrame::OnPlaybackFinished()
 {
-    if (m_pTransportControls->CanLoop())
+    // Looping happens inside the audio engine, so this only runs once the sample has really ended
+    if (m_pTimer->IsRunning())
     {
-        // FIXME: Temporary fix for the sample not playing from beginning when looping. Might need to change this.
-        if (m_pMediaCtrl->Stop()) // TODO: <--
-            if (!m_pMediaCtrl->Play())
-            {
-                wxMessageDialog msgDialog(NULL, _("Error! Cannot loop media."), _("Error"), wxOK | wxICON_ERROR);
-                msgDialog.ShowModal();
-            }
+        m_pTimer->Stop();
+        SH_LOG_DEBUG("Stopping timer.");
     }
-    else
-    {
-        if (m_pTimer->IsRunning())
-        {
-            m_pTimer->Stop();
-            SH_LOG_DEBUG("Stopping timer.");
-        }
 
-        m_pTransportControls->SetSamplePositionText("--:--.---/--:--.---");
-        PopStatusText(1);
-        this->SetStatusText(_("Stopped"), 1);
-    }
+    m_pTransportControls->SetSamplePositionText("--:--.---/--:--.---");
+    PopStatusText(1);
+    this->SetStatusText(_("Stopped"), 1);
+}
+
+void cMainFrame::OnClickLoopABButton(wxCommandEvent& event)
+{
+    UpdateLoopRegion();
 }
 
 void cMainFrame::UpdateElapsedTime(wxTimerEvent& event)
 {
     wxString duration, position;
 
-    duration = SampleHive::cUtils::Get().CalculateAndGetISOStandardTime(m_pMediaCtrl->Length());
-    position = SampleHive::cUtils::Get().CalculateAndGetISOStandardTime(m_pMediaCtrl->Tell());
+    // Starts a sample that was still being decoded when it was clicked
+    m_pAudioEngine->Update();
+
+    const SampleHive::cAudioEngine::PlaybackState state = m_pAudioEngine->GetPlaybackState();
+
+    duration = SampleHive::cUtils::Get().CalculateAndGetISOStandardTime(state.Length);
+    position = SampleHive::cUtils::Get().CalculateAndGetISOStandardTime(state.Position);
 
     m_pTransportControls->SetSamplePositionText(wxString::Format(wxT("%s/%s"), position.c_str(), duration.c_str()));
 
-    m_pWaveformViewer->Refresh();
+    m_pWaveformViewer->UpdatePlayhead();
 
-    if (m_bLoopPointsSet && m_pTransportControls->IsLoopABOn())
-        if (static_cast<double>(m_pMediaCtrl->Tell()) >= m_LoopB.ToDouble())
-            m_pMediaCtrl->Seek(m_LoopA.ToDouble(), wxFromStart);
+    if (!m_pAudioEngine->IsPlaying())
+        OnPlaybackFinished();
 }
 
 void cMainFrame::LoadDatabase()
@@ -263,22 +277,18 @@ void cMainFrame::LoadDatabase()
 
     try
     {
-        const auto dataset = m_pDatabase->LoadSamplesDatabase(*m_pNotebook->GetHivesPanel()->GetHivesObject(),
-                                                              m_pNotebook->GetHivesPanel()->GetFavoritesHive(),
-                                                              *m_pNotebook->GetTrashPanel()->GetTrashObject(),
-                                                              m_pNotebook->GetTrashPanel()->GetTrashRoot(),
-                                                              serializer.DeserializeShowFileExtension(),
-                                                              ICON_STAR_FILLED_16px, ICON_STAR_EMPTY_16px);
+        const auto dataset = cDatabase::Get().LoadSamplesDatabase(*m_pNotebook->GetHivesPanel()->GetHivesObject(),
+                                                                  m_pNotebook->GetHivesPanel()->GetFavoritesHive(),
+                                                                  *m_pNotebook->GetTrashPanel()->GetTrashObject(),
+                                                                  m_pNotebook->GetTrashPanel()->GetTrashRoot(),
+                                                                  serializer.DeserializeShowFileExtension());
 
         if (dataset.empty())
             SH_LOG_INFO("Error! Database is empty.");
         else
-        {
-            for (auto data : dataset)
-                SampleHive::cHiveData::Get().ListCtrlAppendItem(data);
-        }
+            SampleHive::cHiveData::Get().ListCtrlAppendSamples(dataset);
 
-        m_pDatabase->LoadHivesDatabase(*m_pNotebook->GetHivesPanel()->GetHivesObject());
+        cDatabase::Get().LoadHivesDatabase(*m_pNotebook->GetHivesPanel()->GetHivesObject());
     }
     catch (std::exception& e)
     {
@@ -328,6 +338,12 @@ void cMainFrame::LoadConfigFile()
     else
         SH_LOG_INFO("Found {} directory.", APP_DATA_DIR);
 
+    // Waveform peaks are written here while importing
+    if (!wxDirExists(APP_PEAKS_DIR) &&
+        !wxFileName::Mkdir(APP_PEAKS_DIR, wxPOSIX_USER_READ | wxPOSIX_USER_WRITE | wxPOSIX_USER_EXECUTE,
+                           wxPATH_MKDIR_FULL))
+        SH_LOG_ERROR("Error! Could not create peaks directory {}", APP_PEAKS_DIR);
+
     SampleHive::cSerializer serializer;
 
     SH_LOG_INFO("Reading configuration file..");
@@ -638,6 +654,29 @@ void cMainFrame::OnSelectExit(wxCommandEvent& event)
     Close();
 }
 
+void cMainFrame::OnSelectFindDuplicates(wxCommandEvent& event)
+{
+    // The same item cancels the job while it runs
+    if (SampleHive::cDuplicateJob::Get().IsBusy())
+    {
+        SampleHive::cDuplicateJob::Get().Cancel();
+        return;
+    }
+
+    m_pEditMenu->SetLabel(SampleHive::ID::MN_FindDuplicates, _("Cancel finding duplicates"));
+
+    SampleHive::cDuplicateJob::Get().Start(this, [this](bool cancelled)
+    {
+        m_pEditMenu->SetLabel(SampleHive::ID::MN_FindDuplicates, _("Find duplicates"));
+
+        if (cancelled)
+            return;
+
+        cDuplicates duplicates(this, cDatabase::Get().GetDuplicateGroups());
+        duplicates.ShowModal();
+    });
+}
+
 void cMainFrame::OnSelectPreferences(wxCommandEvent& event)
 {
     cSettings* settings = new cSettings(this);
@@ -678,6 +717,10 @@ void cMainFrame::OnSelectResetAppData(wxCommandEvent& event)
         case wxID_YES:
             remove = true;
 
+            // Nothing may still be writing to the database about to go
+            SampleHive::cImportJobs::Get().CancelAndWait();
+            SampleHive::cDuplicateJob::Get().CancelAndWait();
+
             if (remove)
             {
                 if (!wxFileExists(static_cast<std::string>(CONFIG_FILEPATH)))
@@ -688,6 +731,9 @@ void cMainFrame::OnSelectResetAppData(wxCommandEvent& event)
 
                 bool config_is_deleted = wxRemoveFile(static_cast<std::string>(CONFIG_FILEPATH));
 
+                // Otherwise a pending write would bring the old config back
+                SampleHive::cConfigStore::Get().Discard();
+
                 if (config_is_deleted)
                     SH_LOG_INFO("Deleted {}", static_cast<std::string>(CONFIG_FILEPATH));
                 else
@@ -765,6 +811,9 @@ void cMainFrame::OnResizeStatusBar(wxSizeEvent& event)
     m_pHiveBitmap->Move(rect.x + (rect.width - bitmap_size.x),
                         rect.y + (rect.height - bitmap_size.y));
 
+    m_pStatusBar->GetFieldRect(0, rect);
+    m_pImportStatus->SetSize(rect);
+
     event.Skip();
 }
 
@@ -822,6 +871,8 @@ void cMainFrame::OnRecieveLoopPoints(SampleHive::cLoopPointsEvent& event)
     m_pTransportControls->SetLoopABValue(true);
 
     m_bLoopPointsSet = true;
+
+    UpdateLoopRegion();
 }
 
 void cMainFrame::OnRecievePushStatusBarStatus(SampleHive::cStatusBarStatusEvent& event)
@@ -863,27 +914,30 @@ void cMainFrame::OnRecieveCallFunctionPlay(SampleHive::cCallFunctionEvent& event
     wxString selection = event.GetSlection();
     bool checkAutoplay = event.GetAutoplayValue();
 
-    wxString sample_path = SampleHive::cUtils::Get().GetFilenamePathAndExtension(selection).Path;
+    // Rows with the same name can be different files, play the one clicked
+    wxString sample_path = event.GetPath();
 
     if (checkAutoplay)
     {
         if (m_pTransportControls->CanAutoplay())
         {
             if (m_bLoopPointsSet && m_pTransportControls->IsLoopABOn())
-                PlaySample(sample_path.ToStdString(), selection.ToStdString(), true, m_LoopA.ToDouble(), wxFromStart);
+                PlaySample(sample_path.ToStdString(), selection.ToStdString(), true, m_LoopA.GetValue());
             else
                 PlaySample(sample_path.ToStdString(), selection.ToStdString());
         }
         else
-            m_pMediaCtrl->Stop();
+            m_pAudioEngine->Stop();
     }
     else
     {
         if (m_bLoopPointsSet && m_pTransportControls->IsLoopABOn())
-            PlaySample(sample_path.ToStdString(), selection.ToStdString(), true, m_LoopA.ToDouble(), wxFromStart);
+            PlaySample(sample_path.ToStdString(), selection.ToStdString(), true, m_LoopA.GetValue());
         else
             PlaySample(sample_path.ToStdString(), selection.ToStdString());
     }
+
+    PrefetchAdjacentSamples();
 }
 
 void cMainFrame::OnRecieveWaveformUpdateStatus(SampleHive::cWaveformUpdateEvent& event)
@@ -899,6 +953,8 @@ void cMainFrame::OnRecieveClearLoopPointsStatus(SampleHive::cLoopPointsEvent& ev
 void cMainFrame::OnRecieveLoopABButtonValueChange(SampleHive::cLoopPointsEvent& event)
 {
     m_pTransportControls->SetLoopABValue(false);
+
+    UpdateLoopRegion();
 }
 
 void cMainFrame::ClearLoopPoints()
@@ -907,25 +963,59 @@ void cMainFrame::ClearLoopPoints()
     m_LoopB = 0;
 
     m_bLoopPointsSet = false;
+
+    UpdateLoopRegion();
+}
+
+void cMainFrame::UpdateLoopRegion()
+{
+    if (m_bLoopPointsSet && m_pTransportControls->IsLoopABOn())
+        m_pAudioEngine->SetLoopRegion(m_LoopA.ToDouble(), m_LoopB.ToDouble());
+    else
+        m_pAudioEngine->ClearLoopRegion();
 }
 
-void cMainFrame::PlaySample(const std::string& filepath, const std::string& sample, bool seek, wxFileOffset where, wxSeekMode mode)
+void cMainFrame::PrefetchAdjacentSamples()
 {
-    if (m_pMediaCtrl->Load(filepath))
+    const int rows_each_way = 2;
+
+    int selected_row = SampleHive::cHiveData::Get().GetListCtrlSelectedRow();
+    int row_count = SampleHive::cHiveData::Get().GetListCtrlItemCount();
+
+    if (selected_row < 0)
+        return;
+
+    // Nearest first, the next row down is the likeliest to be played next
+    std::vector<std::string> paths;
+
+    for (int i = 1; i <= rows_each_way; i++)
     {
+        if (selected_row + i < row_count)
+            paths.push_back(SampleHive::cHiveData::Get().GetListCtrlSamplePath(selected_row + i).ToStdString());
+
+        if (selected_row - i >= 0)
+            paths.push_back(SampleHive::cHiveData::Get().GetListCtrlSamplePath(selected_row - i).ToStdString());
+    }
+
+    m_pAudioEngine->GetSampleCache().Prefetch(paths);
+}
+
+void cMainFrame::PlaySample(const std::string& filepath, const std::string& sample, bool seek, int64_t where)
+{
+    SH_TRACE_SCOPE("playback.start");
+
+    if (m_pAudioEngine->Load(filepath))
+    {
+        m_pAudioEngine->SetLooping(m_pTransportControls->CanLoop());
+
+        UpdateLoopRegion();
+
         if (seek)
-            m_pMediaCtrl->Seek(where, mode);
+            m_pAudioEngine->Seek(where);
 
-        if (!m_pMediaCtrl->Play())
+        if (!m_pAudioEngine->Play())
             SH_LOG_ERROR("Error! Cannot play sample.");
 
-        // ====================================================
-        // TODO: Remove these lines (for debugging only)
-        float bpm = SampleHive::cUtils::Get().GetBPM(filepath);
-        wxString bpm_str = SampleHive::cUtils::Get().GetBPMString(bpm);
-        SH_LOG_DEBUG("BPM: {}, BPM_STR: {}", bpm, bpm_str);
-        // ====================================================
-
         PushStatusText(wxString::Format(_("Now playing: %s"), sample), 1);
 
         if (!m_pTimer->IsRunning())
@@ -943,11 +1033,14 @@ void cMainFrame::InitDatabase()
     // Initialize the database
     try
     {
-        m_pDatabase = std::make_unique<cDatabase>();
-        m_pDatabase->CreateTableSamples();
+        cDatabase::Get().CreateTableSamples();
+        cDatabase::Get().CreateTableMetadata();
+        cDatabase::Get().CreateTableScanState();
 
         if (!m_bDemoMode)
-            m_pDatabase->CreateTableHives();
+            cDatabase::Get().CreateTableHives();
+
+        SampleHive::cMetadataCache::Get().Open(cDatabase::Get().GetPath());
     }
     catch (std::exception& e)
     {
@@ -957,12 +1050,36 @@ void cMainFrame::InitDatabase()
 
 cMainFrame::~cMainFrame()
 {
+    // A running import or duplicate search writes to the database until it
+    // is told to stop
+    SampleHive::cImportJobs::Get().Close();
+    SampleHive::cDuplicateJob::Get().Close();
+
     // Delete wxTimer
     delete m_pTimer;
 
+    // Stops the audio thread, nothing is painted or played from here on
+    delete m_pAudioEngine;
+
     // Delete wxFilesystemWatcher
     delete m_pFsWatcher;
 
+    SH_LOG_DEBUG("Statement cache: {} statements, {} hits, {} misses",
+                 cDatabase::Get().GetStatementCacheSize(),
+                 cDatabase::Get().GetStatementCacheHits(),
+                 cDatabase::Get().GetStatementCacheMisses());
+
+    if (cQueryProfiler::Get().IsEnabled())
+        SH_LOG_INFO("SQL profile:\n{}", cQueryProfiler::Get().GetReport());
+
+    SH_LOG_DEBUG("Metadata cache: {} memory hits, {} database hits, {} misses",
+                 SampleHive::cMetadataCache::Get().GetMemoryHits(),
+                 SampleHive::cMetadataCache::Get().GetDatabaseHits(),
+                 SampleHive::cMetadataCache::Get().GetMisses());
+
+    // Stores what the tag editor read while logging is still up
+    SampleHive::cMetadataCache::Get().Close();
+
     SampleHive::cSerializer serializer;
 
     if (serializer.DeserializeDemoMode())
@@ -975,4 +1092,7 @@ cMainFrame::~cMainFrame()
         else
             SH_LOG_DEBUG("File doesn't exists");
     }
+
+    // Write out the last window size and sash positions before wx goes away
+    SampleHive::cConfigStore::Get().Close();
 }
@@ -20,10 +20,12 @@
 
 #pragma once
 
+#include "GUI/ImportStatus.hpp"
 #include "GUI/Library.hpp"
 #include "GUI/Notebook.hpp"
 #include "GUI/TransportControls.hpp"
 #include "GUI/WaveformViewer.hpp"
+#include "Audio/AudioEngine.hpp"
 #include "Database/Database.hpp"
 #include "Utility/Serialize.hpp"
 #include "Utility/Event.hpp"
@@ -35,7 +37,6 @@
 #include <wx/event.h>
 #include <wx/frame.h>
 #include <wx/fswatcher.h>
-#include <wx/mediactrl.h>
 #include <wx/panel.h>
 #include <wx/sizer.h>
 #include <wx/splitter.h>
@@ -53,7 +54,8 @@ class cMainFrame : public wxFrame
     private:
         // -------------------------------------------------------------------
         // Top panel control handlers
-        void OnMediaFinished(wxMediaEvent& event);
+        void OnPlaybackFinished();
+        void OnClickLoopABButton(wxCommandEvent& event);
 
         // -------------------------------------------------------------------
         // App menu items event handlers
@@ -64,6 +66,7 @@ class cMainFrame : public wxFrame
         void OnSelectToggleMenuBar(wxCommandEvent& event);
         void OnSelectToggleStatusBar(wxCommandEvent& event);
         void OnSelectExit(wxCommandEvent& event);
+        void OnSelectFindDuplicates(wxCommandEvent& event);
         void OnSelectPreferences(wxCommandEvent& event);
         void OnSelectResetAppData(wxCommandEvent& event);
         void OnSelectAbout(wxCommandEvent& event);
@@ -86,7 +89,13 @@ class cMainFrame : public wxFrame
 
         // -------------------------------------------------------------------
         void PlaySample(const std::string& filepath, const std::string& sample, bool seek = false,
-                        wxFileOffset where = NULL, wxSeekMode mode = wxFromStart);
+                        int64_t where = 0);
+
+        // Hand the A-B loop to the audio engine, or take it away
+        void UpdateLoopRegion();
+
+        // Decode the rows around the selection ahead of the arrow keys reaching them
+        void PrefetchAdjacentSamples();
 
         // Recieve custom events
         // -------------------------------------------------------------------
@@ -135,6 +144,10 @@ class cMainFrame : public wxFrame
         // Hive bitmap icon for the statusbar
         wxStaticBitmap* m_pHiveBitmap = nullptr;
 
+        // -------------------------------------------------------------------
+        // Background import progress, in the first statusbar section
+        cImportStatus* m_pImportStatus = nullptr;
+
         // -------------------------------------------------------------------
         // App statusbar
         wxStatusBar* m_pStatusBar = nullptr;
@@ -177,16 +190,13 @@ class cMainFrame : public wxFrame
         cLibrary* m_pLibrary = nullptr;
 
         // -------------------------------------------------------------------
-        // MediaCtrl
-        wxMediaCtrl* m_pMediaCtrl = nullptr;
+        // Audio engine for previews
+        SampleHive::cAudioEngine* m_pAudioEngine = nullptr;
 
         // -------------------------------------------------------------------
         // Timer
         wxTimer* m_pTimer = nullptr;
 
-        // -------------------------------------------------------------------
-        std::unique_ptr<cDatabase> m_pDatabase = nullptr;
-
         // -------------------------------------------------------------------
         // FileSystemWatcher
         wxFileSystemWatcher* m_pFsWatcher = nullptr;
@@ -0,0 +1,398 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "GUI/SampleListModel.hpp"
+#include "Utility/Paths.hpp"
+#include "Utility/Utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+#include <wx/gdicmn.h>
+#include <wx/variant.h>
+
+// Reorder one column array so that row i holds what was at order[i]
+template<typename T>
+static void apply_order(std::vector<T>& values, const std::vector<unsigned int>& order)
+{
+    std::vector<T> sorted;
+    sorted.reserve(values.size());
+
+    for (const unsigned int row : order)
+        sorted.push_back(values[row]);
+
+    values.swap(sorted);
+}
+
+cSampleListModel::cSampleListModel()
+    : wxDataViewVirtualListModel(0)
+{
+
+}
+
+wxString cSampleListModel::GetColumnType(unsigned int col) const
+{
+    if (col == Col_Favorite)
+        return "wxBitmap";
+
+    return "string";
+}
+
+void cSampleListModel::GetValueByRow(wxVariant& variant, unsigned int row, unsigned int col) const
+{
+    if (row >= GetRowCount())
+        return;
+
+    switch (col)
+    {
+        case Col_Favorite:
+        {
+            if (!m_IconFilled.IsOk())
+            {
+                m_IconFilled = wxBitmap(ICON_STAR_FILLED_16px, wxBITMAP_TYPE_PNG);
+                m_IconEmpty = wxBitmap(ICON_STAR_EMPTY_16px, wxBITMAP_TYPE_PNG);
+            }
+
+            variant << (m_Favorites[row] ? m_IconFilled : m_IconEmpty);
+        }
+        break;
+        case Col_Filename:
+            variant = GetFilename(row);
+            break;
+        case Col_SamplePack:
+            variant = wxString::FromUTF8(m_Strings[m_SamplePacks[row]].c_str());
+            break;
+        case Col_Type:
+            variant = wxString::FromUTF8(m_Strings[m_Types[row]].c_str());
+            break;
+        case Col_Channels:
+            variant = wxString::Format("%d", m_Channels[row]);
+            break;
+        case Col_BPM:
+            variant = SampleHive::cUtils::Get().GetBPMString(m_BPMs[row]);
+            break;
+        case Col_Length:
+            variant = SampleHive::cUtils::Get().CalculateAndGetISOStandardTime(m_Lengths[row]);
+            break;
+        case Col_SampleRate:
+            variant = wxString::Format("%u", m_SampleRates[row]);
+            break;
+        case Col_Bitrate:
+            variant = wxString::Format("%u", m_Bitrates[row]);
+            break;
+        case Col_Path:
+            variant = GetPath(row);
+            break;
+        default:
+            break;
+    }
+}
+
+bool cSampleListModel::SetValueByRow(const wxVariant& WXUNUSED(variant), unsigned int WXUNUSED(row),
+                                     unsigned int WXUNUSED(col))
+{
+    // Cells are not editable in place
+    return false;
+}
+
+wxString cSampleListModel::GetTextValue(unsigned int row, unsigned int col) const
+{
+    if (row >= GetRowCount() || col == Col_Favorite)
+        return wxEmptyString;
+
+    wxVariant variant;
+    GetValueByRow(variant, row, col);
+
+    return variant.GetString();
+}
+
+wxString cSampleListModel::GetPath(unsigned int row) const
+{
+    return wxString::FromUTF8(m_PathData.data() + m_PathOffsets[row], m_PathLengths[row]);
+}
+
+wxString cSampleListModel::GetFilename(unsigned int row) const
+{
+    wxString filename = GetPath(row).AfterLast('/');
+
+    // A name without a dot, or only a leading one, has no extension to hide
+    if (m_bShowExtension || filename.Find('.', true) <= 0)
+        return filename;
+
+    return filename.BeforeLast('.');
+}
+
+uint32_t cSampleListModel::InternString(const std::string& text)
+{
+    auto it = m_StringIndex.find(text);
+
+    if (it != m_StringIndex.end())
+        return it->second;
+
+    const uint32_t index = static_cast<uint32_t>(m_Strings.size());
+
+    m_Strings.push_back(text);
+    m_StringIndex.emplace(text, index);
+
+    return index;
+}
+
+void cSampleListModel::PushRow(const Sample& sample)
+{
+    const std::string path = sample.GetPath();
+
+    m_IDs.push_back(sample.GetID());
+    m_Favorites.push_back(sample.GetFavorite() == 1 ? 1 : 0);
+    m_SamplePacks.push_back(InternString(sample.GetSamplePack()));
+    m_Types.push_back(InternString(sample.GetType()));
+    m_Channels.push_back(static_cast<uint16_t>(sample.GetChannels()));
+    m_BPMs.push_back(static_cast<uint16_t>(sample.GetBPM()));
+    m_Lengths.push_back(static_cast<uint32_t>(sample.GetLength()));
+    m_SampleRates.push_back(static_cast<uint32_t>(sample.GetSampleRate()));
+    m_Bitrates.push_back(static_cast<uint32_t>(sample.GetBitrate()));
+    m_PathOffsets.push_back(static_cast<uint32_t>(m_PathData.size()));
+    m_PathLengths.push_back(static_cast<uint32_t>(path.size()));
+
+    m_PathData += path;
+}
+
+void cSampleListModel::AppendSample(const Sample& sample)
+{
+    PushRow(sample);
+    RowAppended();
+}
+
+void cSampleListModel::AppendSamples(const std::vector<Sample>& samples)
+{
+    if (samples.empty())
+        return;
+
+    const bool was_empty = m_IDs.empty();
+
+    for (const auto& sample : samples)
+    {
+        PushRow(sample);
+
+        if (!was_empty)
+            RowAppended();
+    }
+
+    // Filling an empty list is the library load, one reset is far cheaper
+    // than a notification per row
+    if (was_empty)
+        Reset(GetRowCount());
+}
+
+void cSampleListModel::UpdateSamples(const std::vector<Sample>& samples)
+{
+    if (samples.empty())
+        return;
+
+    std::unordered_map<int64_t, const Sample*> by_id;
+
+    for (const auto& sample : samples)
+        by_id[sample.GetID()] = &sample;
+
+    // One pass over the rows, not a search per sample
+    for (unsigned int row = 0; row < GetRowCount(); row++)
+    {
+        const auto it = by_id.find(m_IDs[row]);
+
+        if (it == by_id.end())
+            continue;
+
+        const Sample& sample = *it->second;
+
+        m_Channels[row] = static_cast<uint16_t>(sample.GetChannels());
+        m_BPMs[row] = static_cast<uint16_t>(sample.GetBPM());
+        m_Lengths[row] = static_cast<uint32_t>(sample.GetLength());
+        m_SampleRates[row] = static_cast<uint32_t>(sample.GetSampleRate());
+        m_Bitrates[row] = static_cast<uint32_t>(sample.GetBitrate());
+
+        RowChanged(row);
+    }
+}
+
+void cSampleListModel::DeleteRow(unsigned int row)
+{
+    if (row >= GetRowCount())
+        return;
+
+    m_IDs.erase(m_IDs.begin() + row);
+    m_Favorites.erase(m_Favorites.begin() + row);
+    m_SamplePacks.erase(m_SamplePacks.begin() + row);
+    m_Types.erase(m_Types.begin() + row);
+    m_Channels.erase(m_Channels.begin() + row);
+    m_BPMs.erase(m_BPMs.begin() + row);
+    m_Lengths.erase(m_Lengths.begin() + row);
+    m_SampleRates.erase(m_SampleRates.begin() + row);
+    m_Bitrates.erase(m_Bitrates.begin() + row);
+    m_PathOffsets.erase(m_PathOffsets.begin() + row);
+    m_PathLengths.erase(m_PathLengths.begin() + row);
+
+    RowDeleted(row);
+}
+
+void cSampleListModel::DeleteAllRows()
+{
+    m_IDs.clear();
+    m_Favorites.clear();
+    m_SamplePacks.clear();
+    m_Types.clear();
+    m_Channels.clear();
+    m_BPMs.clear();
+    m_Lengths.clear();
+    m_SampleRates.clear();
+    m_Bitrates.clear();
+    m_PathOffsets.clear();
+    m_PathLengths.clear();
+    m_PathData.clear();
+
+    Reset(0);
+}
+
+int cSampleListModel::GetRowFromSampleID(int64_t id) const
+{
+    auto it = std::find(m_IDs.begin(), m_IDs.end(), id);
+
+    return it == m_IDs.end() ? wxNOT_FOUND : static_cast<int>(it - m_IDs.begin());
+}
+
+void cSampleListModel::SetFavorite(unsigned int row, bool favorite)
+{
+    if (row >= GetRowCount())
+        return;
+
+    m_Favorites[row] = favorite ? 1 : 0;
+    RowValueChanged(row, Col_Favorite);
+}
+
+void cSampleListModel::Sort(unsigned int col, bool ascending)
+{
+    std::vector<unsigned int> order(GetRowCount());
+    std::iota(order.begin(), order.end(), 0);
+
+    // Compares the UTF-8 bytes of two slices of m_PathData
+    auto compare_text = [this](uint32_t a, uint32_t a_len, uint32_t b, uint32_t b_len)
+    {
+        const int result = std::memcmp(m_PathData.data() + a, m_PathData.data() + b, std::min(a_len, b_len));
+
+        return result != 0 ? result < 0 : a_len < b_len;
+    };
+
+    auto by_number = [](const auto& values)
+    {
+        return [&values](unsigned int a, unsigned int b) { return values[a] < values[b]; };
+    };
+
+    auto by_string = [this](const std::vector<uint32_t>& values)
+    {
+        return [this, &values](unsigned int a, unsigned int b) { return m_Strings[values[a]] < m_Strings[values[b]]; };
+    };
+
+    // Descending flips the comparison rather than the result, so rows with
+    // equal keys keep their order either way
+    auto sort_by = [&order, ascending](const auto& less)
+    {
+        if (ascending)
+            std::stable_sort(order.begin(), order.end(), less);
+        else
+            std::stable_sort(order.begin(), order.end(), [&less](unsigned int a, unsigned int b) { return less(b, a); });
+    };
+
+    switch (col)
+    {
+        case Col_Favorite:
+            sort_by(by_number(m_Favorites));
+            break;
+        case Col_Filename:
+        {
+            // Only the part after the last slash takes part in the comparison
+            std::vector<uint32_t> names(order.size());
+
+            for (unsigned int row = 0; row < names.size(); row++)
+            {
+                uint32_t name = m_PathLengths[row];
+
+                while (name > 0 && m_PathData[m_PathOffsets[row] + name - 1] != '/')
+                    name--;
+
+                names[row] = name;
+            }
+
+            sort_by([&](unsigned int a, unsigned int b)
+            {
+                return compare_text(m_PathOffsets[a] + names[a], m_PathLengths[a] - names[a],
+                                    m_PathOffsets[b] + names[b], m_PathLengths[b] - names[b]);
+            });
+        }
+        break;
+        case Col_SamplePack:
+            sort_by(by_string(m_SamplePacks));
+            break;
+        case Col_Type:
+            sort_by(by_string(m_Types));
+            break;
+        case Col_Channels:
+            sort_by(by_number(m_Channels));
+            break;
+        case Col_BPM:
+            sort_by(by_number(m_BPMs));
+            break;
+        case Col_Length:
+            sort_by(by_number(m_Lengths));
+            break;
+        case Col_SampleRate:
+            sort_by(by_number(m_SampleRates));
+            break;
+        case Col_Bitrate:
+            sort_by(by_number(m_Bitrates));
+            break;
+        case Col_Path:
+            sort_by([&](unsigned int a, unsigned int b)
+            {
+                return compare_text(m_PathOffsets[a], m_PathLengths[a], m_PathOffsets[b], m_PathLengths[b]);
+            });
+            break;
+        default:
+            return;
+    }
+
+    apply_order(m_IDs, order);
+    apply_order(m_Favorites, order);
+    apply_order(m_SamplePacks, order);
+    apply_order(m_Types, order);
+    apply_order(m_Channels, order);
+    apply_order(m_BPMs, order);
+    apply_order(m_Lengths, order);
+    apply_order(m_SampleRates, order);
+    apply_order(m_Bitrates, order);
+    apply_order(m_PathOffsets, order);
+    apply_order(m_PathLengths, order);
+
+    Reset(GetRowCount());
+}
+
+cSampleListModel::~cSampleListModel()
+{
+
+}
@@ -0,0 +1,128 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Utility/Sample.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <wx/bitmap.h>
+#include <wx/dataview.h>
+#include <wx/string.h>
+
+// Rows of the library list. Every column is kept in its own array and cells
+// are only formatted when the control asks for them, repeated sample pack and
+// type names are stored once and referred to by index.
+class cSampleListModel : public wxDataViewVirtualListModel
+{
+    public:
+        cSampleListModel();
+        ~cSampleListModel();
+
+    public:
+        // -------------------------------------------------------------------
+        enum Column
+        {
+            Col_Favorite = 0,
+            Col_Filename,
+            Col_SamplePack,
+            Col_Type,
+            Col_Channels,
+            Col_BPM,
+            Col_Length,
+            Col_SampleRate,
+            Col_Bitrate,
+            Col_Path,
+            Col_Max
+        };
+
+    public:
+        // -------------------------------------------------------------------
+        // wxDataViewVirtualListModel overrides
+        virtual unsigned int GetColumnCount() const override { return Col_Max; }
+        virtual wxString GetColumnType(unsigned int col) const override;
+        virtual void GetValueByRow(wxVariant& variant, unsigned int row, unsigned int col) const override;
+        virtual bool SetValueByRow(const wxVariant& variant, unsigned int row, unsigned int col) override;
+
+    public:
+        // -------------------------------------------------------------------
+        void AppendSample(const Sample& sample);
+        void AppendSamples(const std::vector<Sample>& samples);
+
+        // New analysis of samples already in the list, found by id
+        void UpdateSamples(const std::vector<Sample>& samples);
+        void DeleteRow(unsigned int row);
+        void DeleteAllRows();
+
+        // Reorder the rows by a column, the control does not sort virtual lists
+        void Sort(unsigned int col, bool ascending);
+
+        // -------------------------------------------------------------------
+        inline unsigned int GetRowCount() const { return static_cast<unsigned int>(m_IDs.size()); }
+        inline int64_t GetSampleID(unsigned int row) const { return m_IDs[row]; }
+        inline int GetLength(unsigned int row) const { return static_cast<int>(m_Lengths[row]); }
+        wxString GetPath(unsigned int row) const;
+        int GetRowFromSampleID(int64_t id) const;
+
+        wxString GetTextValue(unsigned int row, unsigned int col) const;
+
+        void SetFavorite(unsigned int row, bool favorite);
+
+        inline void SetShowExtension(bool show) { m_bShowExtension = show; }
+
+    private:
+        // -------------------------------------------------------------------
+        uint32_t InternString(const std::string& text);
+        wxString GetFilename(unsigned int row) const;
+
+        void PushRow(const Sample& sample);
+
+    private:
+        // -------------------------------------------------------------------
+        // One entry per row
+        std::vector<int64_t> m_IDs;
+        std::vector<uint8_t> m_Favorites;
+        std::vector<uint32_t> m_SamplePacks;
+        std::vector<uint32_t> m_Types;
+        std::vector<uint16_t> m_Channels;
+        std::vector<uint16_t> m_BPMs;
+        std::vector<uint32_t> m_Lengths;
+        std::vector<uint32_t> m_SampleRates;
+        std::vector<uint32_t> m_Bitrates;
+        std::vector<uint32_t> m_PathOffsets;
+        std::vector<uint32_t> m_PathLengths;
+
+        // -------------------------------------------------------------------
+        // UTF-8 paths back to back, space of deleted rows is reclaimed when
+        // the list is cleared
+        std::string m_PathData;
+
+        // -------------------------------------------------------------------
+        std::vector<std::string> m_Strings;
+        std::unordered_map<std::string, uint32_t> m_StringIndex;
+
+        // -------------------------------------------------------------------
+        mutable wxBitmap m_IconFilled, m_IconEmpty;
+        bool m_bShowExtension = false;
+};
@@ -23,16 +23,16 @@
 #include "Database/Database.hpp"
 #include "Utility/ControlIDs.hpp"
 #include "Utility/HiveData.hpp"
-#include "Utility/Serialize.hpp"
-#include "Utility/Paths.hpp"
 #include "Utility/Log.hpp"
+#include "Utility/Trace.hpp"
 
-#include <exception>
+// Delay after the last keystroke before a search is sent to the worker
+static const int s_SearchDebounceMs = 150;
 
 cSearchBar::cSearchBar(wxWindow* window)
     : wxSearchCtrl(window, SampleHive::ID::BC_Search, _("Search for samples.."),
                    wxDefaultPosition, wxDefaultSize, wxTE_PROCESS_ENTER),
-      m_pWindow(window)
+      m_pWindow(window), m_SearchWorker(*this)
 {
     // Set minimum and maximum size of m_SearchBox
     // so it doesn't expand too wide when resizing the main frame.
@@ -42,43 +42,62 @@ cSearchBar::cSearchBar(wxWindow* window)
     ShowSearchButton(true);
     ShowCancelButton(true);
 
+    m_pSearchTimer = new wxTimer(this);
+
     Bind(wxEVT_TEXT, &cSearchBar::OnDoSearch, this, SampleHive::ID::BC_Search);
     Bind(wxEVT_SEARCHCTRL_SEARCH_BTN, &cSearchBar::OnDoSearch, this, SampleHive::ID::BC_Search);
     Bind(wxEVT_SEARCHCTRL_CANCEL_BTN, &cSearchBar::OnCancelSearch, this, SampleHive::ID::BC_Search);
+    Bind(wxEVT_TIMER, &cSearchBar::OnSearchTimer, this, m_pSearchTimer->GetId());
+    Bind(SampleHive::SH_EVT_SEARCH_RESULTS, &cSearchBar::OnSearchResults, this);
 }
 
 void cSearchBar::OnDoSearch(wxCommandEvent& event)
 {
-    SampleHive::cSerializer serializer;
-    cDatabase db;
+    SH_TRACE_SCOPE("search.dispatch");
 
-    const auto search = this->GetValue().ToStdString();
+    // Whatever is running answers a query the user has moved past, and
+    // batches it already posted are dropped during the debounce too
+    m_SearchGeneration = m_SearchWorker.Cancel();
 
-    try
+    if (event.GetEventType() == wxEVT_SEARCHCTRL_SEARCH_BTN)
     {
-        const auto dataset = db.FilterDatabaseBySampleName(search, serializer.DeserializeShowFileExtension(),
-                                                           ICON_STAR_FILLED_16px, ICON_STAR_EMPTY_16px);
-
-        if (dataset.empty())
-        {
-            SH_LOG_INFO("Error! Database is empty.");
-        }
-        else
-        {
-            SampleHive::cHiveData::Get().ListCtrlDeleteAllItems();
-
-            std::cout << search << std::endl;
-
-            for (const auto& data : dataset)
-            {
-                SampleHive::cHiveData::Get().ListCtrlAppendItem(data);
-            }
-        }
+        m_pSearchTimer->Stop();
+        StartSearch();
+        return;
     }
-    catch (std::exception& e)
+
+    m_pSearchTimer->StartOnce(s_SearchDebounceMs);
+}
+
+void cSearchBar::OnSearchTimer(wxTimerEvent& event)
+{
+    StartSearch();
+}
+
+void cSearchBar::StartSearch()
+{
+    m_bResultsShown = false;
+
+    m_SearchGeneration = m_SearchWorker.Search(cDatabase::Get().GetPath(), this->GetValue().ToStdString());
+}
+
+void cSearchBar::OnSearchResults(SampleHive::cSearchResultsEvent& event)
+{
+    if (event.GetGeneration() != m_SearchGeneration)
+        return;
+
+    const auto& results = event.GetResults();
+
+    if (!results.empty() && !m_bResultsShown)
     {
-        SH_LOG_ERROR("Error loading data. {}", e.what());
+        SampleHive::cHiveData::Get().ListCtrlDeleteAllItems();
+        m_bResultsShown = true;
     }
+
+    SampleHive::cHiveData::Get().ListCtrlAppendSamples(results);
+
+    if (event.IsLastBatch() && !m_bResultsShown)
+        SH_LOG_INFO("No samples found for {}", this->GetValue());
 }
 
 void cSearchBar::OnCancelSearch(wxCommandEvent& event)
@@ -88,5 +107,6 @@ void cSearchBar::OnCancelSearch(wxCommandEvent& event)
 
 cSearchBar::~cSearchBar()
 {
-
+    m_pSearchTimer->Stop();
+    delete m_pSearchTimer;
 }
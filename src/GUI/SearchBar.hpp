@@ -20,8 +20,12 @@
 
 #pragma once
 
+#include "Database/SearchWorker.hpp"
+#include "Utility/Event.hpp"
+
 #include <wx/dataview.h>
 #include <wx/srchctrl.h>
+#include <wx/timer.h>
 
 class cSearchBar : public wxSearchCtrl
 {
@@ -37,8 +41,24 @@ class cSearchBar : public wxSearchCtrl
         // SearchCtrl event handlers
         void OnDoSearch(wxCommandEvent& event);
         void OnCancelSearch(wxCommandEvent& event);
+        void OnSearchTimer(wxTimerEvent& event);
+        void OnSearchResults(SampleHive::cSearchResultsEvent& event);
+
+        // -------------------------------------------------------------------
+        // Hand the current text to the search worker
+        void StartSearch();
 
     private:
         // -------------------------------------------------------------------
         wxWindow* m_pWindow = nullptr;
+
+        // -------------------------------------------------------------------
+        // Typing restarts the timer, the search runs once it goes quiet
+        wxTimer* m_pSearchTimer = nullptr;
+
+        cSearchWorker m_SearchWorker;
+
+        // Only results tagged with the latest generation reach the list
+        unsigned long m_SearchGeneration = 0;
+        bool m_bResultsShown = false;
 };
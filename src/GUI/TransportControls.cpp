@@ -32,9 +32,9 @@
 
 #include <wx/gdicmn.h>
 
-cTransportControls::cTransportControls(wxWindow* window, wxMediaCtrl& mediaCtrl)
+cTransportControls::cTransportControls(wxWindow* window, SampleHive::cAudioEngine& audioEngine)
     : wxPanel(window, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxTAB_TRAVERSAL | wxNO_BORDER),
-      m_MediaCtrl(mediaCtrl)
+      m_AudioEngine(audioEngine)
 {
     m_pMainSizer = new wxBoxSizer(wxHORIZONTAL);
 
@@ -171,7 +171,8 @@ void cTransportControls::OnClickPlay(wxCommandEvent& event)
     wxString selection = SampleHive::cHiveData::Get().GetListCtrlTextValue(selected_row, 1);
 
     // Send custom event to MainFrame to play the sample
-    SampleHive::cSignal::SendCallFunctionPlay(selection, false, *this);
+    SampleHive::cSignal::SendCallFunctionPlay(selection, SampleHive::cHiveData::Get().GetListCtrlSamplePath(selected_row),
+                                              false, *this);
 }
 
 void cTransportControls::OnClickLoop(wxCommandEvent& event)
@@ -180,12 +181,14 @@ void cTransportControls::OnClickLoop(wxCommandEvent& event)
 
     m_bLoop = m_pLoopButton->GetValue();
 
+    m_AudioEngine.SetLooping(m_bLoop);
+
     serializer.SerializeMediaOptions("loop", m_bLoop);
 }
 
 void cTransportControls::OnClickStop(wxCommandEvent& event)
 {
-    if (!m_MediaCtrl.Stop())
+    if (!m_AudioEngine.Stop())
         SH_LOG_ERROR("Error! Unable to stop media.");
 
     m_bStopped = true;
@@ -205,14 +208,14 @@ void cTransportControls::OnClickMute(wxCommandEvent& event)
 
     if (m_pMuteButton->GetValue())
     {
-        m_MediaCtrl.SetVolume(0.0);
+        m_AudioEngine.SetVolume(0.0);
         m_bMuted = true;
 
         serializer.SerializeMediaOptions("muted", m_bMuted);
     }
     else
     {
-        m_MediaCtrl.SetVolume(double(m_pVolumeSlider->GetValue()) / 100);
+        m_AudioEngine.SetVolume(double(m_pVolumeSlider->GetValue()) / 100);
         m_bMuted = false;
 
         serializer.SerializeMediaOptions("muted", m_bMuted);
@@ -239,7 +242,7 @@ void cTransportControls::OnCheckAutoplay(wxCommandEvent& event)
 
 void cTransportControls::OnSlideVolume(wxScrollEvent& event)
 {
-    m_MediaCtrl.SetVolume(double(m_pVolumeSlider->GetValue()) / 100);
+    m_AudioEngine.SetVolume(double(m_pVolumeSlider->GetValue()) / 100);
 
     // Send custom event to MainFrame to push status to statusbar
     SampleHive::cSignal::SendPushStatusBarStatus(wxString::Format(_("Volume: %d"), m_pVolumeSlider->GetValue()), 1, *this);
@@ -264,7 +267,7 @@ void cTransportControls::OnReleaseVolumeSlider(wxScrollEvent& event)
     // Send custom event to MainFrame to pop status from statusbar
     SampleHive::cSignal::SendPopStatusBarStatus(1, *this);
 
-    if (m_MediaCtrl.GetState() == wxMEDIASTATE_STOPPED)
+    if (!m_AudioEngine.IsPlaying())
         SampleHive::cSignal::SendSetStatusBarStatus(_("Stopped"), 1, *this);
     else
         SampleHive::cSignal::SendPushStatusBarStatus(wxString::Format(_("Now playing: %s"), selection), 1, *this);
@@ -286,10 +289,12 @@ void cTransportControls::LoadConfigFile()
 
     m_pVolumeSlider->SetValue(serializer.DeserializeMediaVolume());
 
+    m_AudioEngine.SetLooping(m_bLoop);
+
     if (!m_bMuted)
-        m_MediaCtrl.SetVolume(double(m_pVolumeSlider->GetValue()) / 100);
+        m_AudioEngine.SetVolume(double(m_pVolumeSlider->GetValue()) / 100);
     else
-        m_MediaCtrl.SetVolume(0.0);
+        m_AudioEngine.SetVolume(0.0);
 }
 
 cTransportControls::~cTransportControls()
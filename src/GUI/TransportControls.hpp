@@ -20,11 +20,12 @@
 
 #pragma once
 
+#include "Audio/AudioEngine.hpp"
+
 #include <wx/bmpbuttn.h>
 #include <wx/button.h>
 #include <wx/checkbox.h>
 #include <wx/event.h>
-#include <wx/mediactrl.h>
 #include <wx/settings.h>
 #include <wx/sizer.h>
 #include <wx/slider.h>
@@ -38,7 +39,7 @@ class cTransportControls : public wxPanel
 {
     public:
         // -------------------------------------------------------------------
-        cTransportControls(wxWindow* window, wxMediaCtrl& mediaCtrl);
+        cTransportControls(wxWindow* window, SampleHive::cAudioEngine& audioEngine);
         ~cTransportControls();
 
     public:
@@ -87,7 +88,7 @@ class cTransportControls : public wxPanel
 
     private:
         // -------------------------------------------------------------------
-        wxMediaCtrl& m_MediaCtrl;
+        SampleHive::cAudioEngine& m_AudioEngine;
 
     private:
         // -------------------------------------------------------------------
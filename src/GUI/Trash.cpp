@@ -75,68 +75,33 @@ cTrashPanel::cTrashPanel(wxWindow* window)
 
 void cTrashPanel::OnDragAndDropToTrash(wxDropFilesEvent& event)
 {
-    SampleHive::cSerializer serializer;
-    cDatabase db;
+    cDatabase& db = cDatabase::Get();
 
     if (event.GetNumberOfFiles() > 0)
     {
-        wxFileDataObject file_data;
-        wxArrayString files;
-
-        wxDataViewItemArray items;
-        int rows = SampleHive::cHiveData::Get().GetListCtrlSelections(items);
-
         wxString msg;
 
-        wxDataViewItem root = wxDataViewItem(wxNullPtr);
-        wxDataViewItem container, child;
-
-        for (int i = 0; i < rows; i++)
+        for (int item_row : SampleHive::cHiveData::Get().GetListCtrlSelectedRows())
         {
-            int item_row = SampleHive::cHiveData::Get().GetListCtrlRowFromItem(items, i);
 
             wxString text_value = SampleHive::cHiveData::Get().GetListCtrlTextValue(item_row, 1);
 
-            std::string multi_selection = serializer.DeserializeShowFileExtension() ?
-                SampleHive::cHiveData::Get().GetListCtrlTextValue(item_row, 1).BeforeLast('.').ToStdString() :
-                SampleHive::cHiveData::Get().GetListCtrlTextValue(item_row, 1).ToStdString() ;
-
-            file_data.AddFile(multi_selection);
+            int64_t id = SampleHive::cHiveData::Get().GetListCtrlSampleID(item_row);
 
-            files = file_data.GetFilenames();
-
-            if (db.GetFavoriteColumnValueByFilename(files[i].ToStdString()))
+            if (db.GetFavoriteColumnValueByID(id))
             {
-                SampleHive::cHiveData::Get().ListCtrlSetVariant(wxVariant(wxBitmap(ICON_STAR_EMPTY_16px, wxBITMAP_TYPE_PNG)), item_row, 0);
-
-                db.UpdateFavoriteColumn(files[i].ToStdString(), 0);
-
-                for (int j = 0; j < SampleHive::cHiveData::Get().GetHiveChildCount(root); j++)
-                {
-                    container = SampleHive::cHiveData::Get().GetHiveNthChild(root, j);
-
-                    for (int k = 0; k < SampleHive::cHiveData::Get().GetHiveChildCount(container); k++)
-                    {
-                        child = SampleHive::cHiveData::Get().GetHiveNthChild(container, k);
+                SampleHive::cHiveData::Get().ListCtrlSetFavorite(item_row, false);
 
-                        wxString child_text = serializer.DeserializeShowFileExtension() ?
-                            SampleHive::cHiveData::Get().GetHiveItemText(child).BeforeLast('.') :
-                            SampleHive::cHiveData::Get().GetHiveItemText(child);
+                db.UpdateFavoriteColumn(id, 0);
 
-                        if (child_text == files[i])
-                        {
-                            SampleHive::cHiveData::Get().HiveDeleteItem(child);
-                            break;
-                        }
-                    }
-                }
+                SampleHive::cHiveData::Get().HiveDeleteSampleItem(id);
             }
 
-            db.UpdateTrashColumn(files[i].ToStdString(), 1);
-            db.UpdateHiveName(files[i].ToStdString(),
+            db.UpdateTrashColumn(id, 1);
+            db.UpdateHiveName(id,
                               SampleHive::cHiveData::Get().GetHiveItemText(SampleHive::cHiveData::Get().GetFavoritesHive()).ToStdString());
 
-            m_pTrash->AppendItem(m_TrashRoot, text_value);
+            m_pTrash->AppendItem(m_TrashRoot, text_value, -1, -1, new SampleHive::cSampleItemData(id));
 
             SampleHive::cHiveData::Get().ListCtrlDeleteItem(item_row);
 
@@ -150,8 +115,7 @@ void cTrashPanel::OnDragAndDropToTrash(wxDropFilesEvent& event)
 
 void cTrashPanel::OnShowTrashContextMenu(wxTreeEvent& event)
 {
-    SampleHive::cSerializer serializer;
-    cDatabase db;
+    cDatabase& db = cDatabase::Get();
 
     wxTreeItemId selected_trashed_item = event.GetItem();
 
@@ -166,11 +130,9 @@ void cTrashPanel::OnShowTrashContextMenu(wxTreeEvent& event)
         {
             case SampleHive::ID::MN_DeleteTrash:
             {
-                wxString trashed_item_name = serializer.DeserializeShowFileExtension() ?
-                    m_pTrash->GetItemText(selected_trashed_item).BeforeLast('.') :
-                    m_pTrash->GetItemText(selected_trashed_item);
+                wxString trashed_item_name = m_pTrash->GetItemText(selected_trashed_item);
 
-                db.RemoveSampleFromDatabase(trashed_item_name.ToStdString());
+                db.RemoveSampleFromDatabase(SampleHive::cHiveData::Get().GetTrashItemSampleID(selected_trashed_item));
 
                 m_pTrash->Delete(selected_trashed_item);
 
@@ -182,41 +144,23 @@ void cTrashPanel::OnShowTrashContextMenu(wxTreeEvent& event)
                 wxArrayTreeItemIds selected_item_ids;
                 m_pTrash->GetSelections(selected_item_ids);
 
-                wxFileDataObject file_data;
-                wxArrayString files;
-
-                wxString selected_item_text;
-                std::string filename;
-
                 for (size_t i = 0; i < selected_item_ids.GetCount(); i++)
                 {
-                    selected_item_text = m_pTrash->GetItemText(selected_item_ids[i]);
-
-                    filename = SampleHive::cUtils::Get().GetFilenamePathAndExtension(selected_item_text).Filename;
-
-                    file_data.AddFile(filename);
+                    int64_t id = SampleHive::cHiveData::Get().GetTrashItemSampleID(selected_item_ids[i]);
 
-                    files = file_data.GetFilenames();
-
-                    db.UpdateTrashColumn(files[i].ToStdString(), 0);
+                    db.UpdateTrashColumn(id, 0);
 
                     try
                     {
-                        wxVector<wxVector<wxVariant>> dataset;
+                        std::vector<Sample> dataset;
 
-                        if (db.RestoreFromTrashByFilename(files[i].ToStdString(),
-                                                          dataset,
-                                                          serializer.DeserializeShowFileExtension(),
-                                                          ICON_STAR_FILLED_16px, ICON_STAR_EMPTY_16px).empty())
+                        if (db.RestoreFromTrashByID(id, dataset).empty())
                         {
                             SH_LOG_INFO("Error! Database is empty.");
                         }
                         else
                         {
-                            for (auto data : dataset)
-                            {
-                                SampleHive::cHiveData::Get().ListCtrlAppendItem(data);
-                            }
+                            SampleHive::cHiveData::Get().ListCtrlAppendSamples(dataset);
                         }
                     }
                     catch (std::exception& e)
@@ -224,9 +168,9 @@ void cTrashPanel::OnShowTrashContextMenu(wxTreeEvent& event)
                         SH_LOG_ERROR("Error loading data. {}", e.what());
                     }
 
-                    m_pTrash->Delete(selected_item_ids[i]);
+                    SH_LOG_INFO("{} restored from trash", m_pTrash->GetItemText(selected_item_ids[i]));
 
-                    SH_LOG_INFO("{} restored from trash", files[i]);
+                    m_pTrash->Delete(selected_item_ids[i]);
                 }
             }
             break;
@@ -238,18 +182,11 @@ void cTrashPanel::OnShowTrashContextMenu(wxTreeEvent& event)
 
 void cTrashPanel::OnClickRestoreTrashItem(wxCommandEvent& event)
 {
-    SampleHive::cSerializer serializer;
-    cDatabase db;
+    cDatabase& db = cDatabase::Get();
 
     wxArrayTreeItemIds selected_item_ids;
     m_pTrash->GetSelections(selected_item_ids);
 
-    wxFileDataObject file_data;
-    wxArrayString files;
-
-    wxString selected_item_text;
-    std::string filename;
-
     if (m_pTrash->GetChildrenCount(m_TrashRoot) == 0)
     {
         wxMessageBox(_("Trash is empty, nothing to restore!"), wxMessageBoxCaptionStr, wxOK | wxCENTRE, this);
@@ -264,32 +201,21 @@ void cTrashPanel::OnClickRestoreTrashItem(wxCommandEvent& event)
 
     for (size_t i = 0; i < selected_item_ids.GetCount(); i++)
     {
-        selected_item_text = m_pTrash->GetItemText(selected_item_ids[i]);
-
-        filename = SampleHive::cUtils::Get().GetFilenamePathAndExtension(selected_item_text).Filename;
-
-        file_data.AddFile(filename);
+        int64_t id = SampleHive::cHiveData::Get().GetTrashItemSampleID(selected_item_ids[i]);
 
-        files = file_data.GetFilenames();
-
-        db.UpdateTrashColumn(files[i].ToStdString(), 0);
+        db.UpdateTrashColumn(id, 0);
 
         try
         {
-            wxVector<wxVector<wxVariant>> dataset;
+            std::vector<Sample> dataset;
 
-            if (db.RestoreFromTrashByFilename(files[i].ToStdString(), dataset,
-                                              serializer.DeserializeShowFileExtension(),
-                                              ICON_STAR_FILLED_16px, ICON_STAR_EMPTY_16px).empty())
+            if (db.RestoreFromTrashByID(id, dataset).empty())
             {
                 SH_LOG_INFO("Error! Database is empty.");
             }
             else
             {
-                for (auto data : dataset)
-                {
-                    SampleHive::cHiveData::Get().ListCtrlAppendItem(data);
-                }
+                SampleHive::cHiveData::Get().ListCtrlAppendSamples(dataset);
             }
         }
         catch (std::exception& e)
@@ -26,8 +26,10 @@
 #include "Utility/Serialize.hpp"
 #include "Utility/Event.hpp"
 #include "Utility/Signal.hpp"
-#include "Utility/Tags.hpp"
+#include "Utility/Trace.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <exception>
 #include <vector>
@@ -39,13 +41,35 @@
 #include <wx/filefn.h>
 #include <wx/gdicmn.h>
 #include <wx/pen.h>
+#include <wx/region.h>
 
-#include <sndfile.h>
-#include <sndfile.hh>
+namespace {
 
-cWaveformViewer::cWaveformViewer(wxWindow* window, wxMediaCtrl& mediaCtrl)
+    // RMS of the frames from begin to end, false if they are not decoded yet
+    bool bar_rms(const SampleHive::cPeakPyramid::Level& level, uint64_t begin, uint64_t end, double& rms)
+    {
+        size_t first = static_cast<size_t>(begin / level.FramesPerPeak);
+        size_t last = std::max(first + 1, static_cast<size_t>((end + level.FramesPerPeak - 1) / level.FramesPerPeak));
+
+        if (last > level.Count)
+            return false;
+
+        // Combine the RMS of the peaks under this bar
+        double sum = 0;
+
+        for (size_t j = first; j < last; j++)
+            sum += level.Peaks[j].RMS * level.Peaks[j].RMS;
+
+        rms = std::sqrt(sum / (last - first));
+
+        return true;
+    }
+
+}
+
+cWaveformViewer::cWaveformViewer(wxWindow* window, SampleHive::cAudioEngine& audioEngine)
     : wxPanel(window, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxTAB_TRAVERSAL | wxNO_BORDER | wxFULL_REPAINT_ON_RESIZE),
-      m_Window(window), m_MediaCtrl(mediaCtrl)
+      m_Window(window), m_AudioEngine(audioEngine), m_WaveformWorker(*this)
 {
     this->SetDoubleBuffered(true);
 
@@ -55,6 +79,7 @@ cWaveformViewer::cWaveformViewer(wxWindow* window, wxMediaCtrl& mediaCtrl)
     Bind(wxEVT_LEFT_UP, &cWaveformViewer::OnMouseLeftButtonUp, this);
     // Bind(wxEVT_KEY_DOWN, &cWaveformViewer::OnControlKeyDown, this);
     Bind(wxEVT_KEY_UP, &cWaveformViewer::OnControlKeyUp, this);
+    Bind(SampleHive::SH_EVT_WAVEFORM_PEAKS, &cWaveformViewer::OnWaveformPeaks, this);
 
     m_Sizer = new wxBoxSizer(wxVERTICAL);
 
@@ -84,12 +109,23 @@ void cWaveformViewer::OnPaint(wxPaintEvent& event)
 
         m_WaveformBitmap = wxBitmap(wxImage(size.x, size.y), 32);
 
+        RequestPeaks();
         UpdateWaveformBitmap();
 
         bBitmapDirty = false;
     }
 
-    dc.DrawBitmap(m_WaveformBitmap, 0, 0, false);
+    // Most paints only move the playhead, copy back just the damaged strips
+    // of the cached waveform instead of the whole bitmap
+    wxMemoryDC mdc(m_WaveformBitmap);
+
+    for (wxRegionIterator it(GetUpdateRegion()); it; ++it)
+    {
+        const wxRect rect = it.GetRect();
+        dc.Blit(rect.x, rect.y, rect.width, rect.height, &mdc, rect.x, rect.y);
+    }
+
+    mdc.SelectObject(wxNullBitmap);
 
     RenderPlayhead(dc);
 
@@ -112,8 +148,6 @@ void cWaveformViewer::OnPaint(wxPaintEvent& event)
                                 this->GetSize().GetHeight() + 5));
 
         bAreaSelected = true;
-        // SendLoopPoints();
-        SampleHive::cSignal::SendLoopPoints(CalculateLoopPoints(), *this);
     }
     else
         bAreaSelected = false;
@@ -126,17 +160,9 @@ void cWaveformViewer::RenderPlayhead(wxDC& dc)
     if (selected_row < 0)
         return;
 
-    wxString selected = SampleHive::cHiveData::Get().GetListCtrlTextValue(selected_row, 1);
-    std::string path = SampleHive::cUtils::Get().GetFilenamePathAndExtension(selected).Path.ToStdString();
-
-    SampleHive::cTags tags(path);
+    double line_pos = GetPlayheadX();
 
-    int length = tags.GetAudioInfo().length;
-
-    double position = m_MediaCtrl.Tell();
-
-    int panel_width = this->GetSize().GetWidth();
-    double line_pos = panel_width * (position / length);
+    m_PlayheadX = static_cast<int>(line_pos);
 
     m_PlayheadColour = wxColor(255, 0, 0, 255);
 
@@ -152,109 +178,150 @@ void cWaveformViewer::RenderPlayhead(wxDC& dc)
     dc.DrawLine(line_pos, this->GetSize().GetHeight() - (this->GetSize().GetHeight() - 1), line_pos, this->GetSize().GetHeight() - 1);
 }
 
-void cWaveformViewer::UpdateWaveformBitmap()
+double cWaveformViewer::GetPlayheadX() const
 {
-    SampleHive::cSerializer serializer;
+    // One snapshot from the audio engine, position and length of the same sample
+    const SampleHive::cAudioEngine::PlaybackState state = m_AudioEngine.GetPlaybackState();
 
+    if (state.Length <= 0)
+        return 0.0;
+
+    return this->GetSize().GetWidth() * (static_cast<double>(state.Position) / state.Length);
+}
+
+void cWaveformViewer::UpdatePlayhead()
+{
+    // Wide enough for the triangle on top of the line
+    const int strip_margin = 10;
+
+    const int x = static_cast<int>(GetPlayheadX());
+
+    if (x == m_PlayheadX)
+        return;
+
+    const int height = this->GetSize().GetHeight();
+
+    if (m_PlayheadX >= 0)
+        RefreshRect(wxRect(m_PlayheadX - strip_margin, 0, strip_margin * 2 + 1, height), false);
+
+    RefreshRect(wxRect(x - strip_margin, 0, strip_margin * 2 + 1, height), false);
+
+    m_PlayheadX = x;
+}
+
+void cWaveformViewer::RequestPeaks()
+{
     int selected_row = SampleHive::cHiveData::Get().GetListCtrlSelectedRow();
 
     if (selected_row < 0)
         return;
 
-    wxString selection = SampleHive::cHiveData::Get().GetListCtrlTextValue(selected_row, 1);
+    std::string path = SampleHive::cHiveData::Get().GetListCtrlSamplePath(selected_row).ToStdString();
 
-    wxString path = SampleHive::cUtils::Get().GetFilenamePathAndExtension(selection).Path;
+    // Resizing or recolouring keeps the peaks of the same sample
+    if (path == m_PeaksPath)
+        return;
 
-    SndfileHandle snd_file(path.ToStdString().c_str());
+    m_pPeaks.reset();
+    m_pSketch.reset();
+    m_PeaksPath = path;
 
-    int channels = snd_file.channels();
-    double sample_rate = snd_file.samplerate();
-    sf_count_t frames = snd_file.frames();
+    // Supersedes the job of the previous selection if it is still running
+    m_PeaksGeneration = m_WaveformWorker.Render(path);
+}
 
-    std::vector<float> sample;
-    sample.resize(frames * channels);
+void cWaveformViewer::OnWaveformPeaks(SampleHive::cWaveformPeaksEvent& event)
+{
+    if (event.GetGeneration() != m_PeaksGeneration)
+        return;
 
-    std::vector<float> waveform;
+    if (event.IsSketch())
+        m_pSketch = event.GetPeaks();
+    else
+        m_pPeaks = event.GetPeaks();
 
-    try
-    {
-        // TODO, FIXME: Don't reload file on every window resize
-        snd_file.read(&sample.at(0), frames * channels);
+    if (event.IsComplete())
+        m_pSketch.reset();
 
-        float display_width = this->GetSize().GetWidth();
-        float display_height = this->GetSize().GetHeight();
+    bBitmapDirty = true;
+    Refresh();
+}
 
-        SH_LOG_INFO("Calculating Waveform bars RMS..");
+void cWaveformViewer::UpdateWaveformBitmap()
+{
+    SH_TRACE_SCOPE("waveform.render");
 
-        float chunk_size = (float)(frames) / (float)display_width;
-        int number_of_chunks = static_cast<int>(static_cast<float>(frames) / chunk_size);
+    SampleHive::cSerializer serializer;
 
-        // Start with low non-zero value
-        float normalize = 0.00001;
+    // Decoded peaks win, the sketch fills in the part not decoded yet
+    const SampleHive::cPeakPyramid* peaks = m_pPeaks ? m_pPeaks.get() : m_pSketch.get();
 
-        for (int i = 0; i < number_of_chunks; i++)
-        {
-            double sum = 0, mono = 0;
+    if (!peaks || peaks->GetFrames() == 0)
+        return;
 
-            int start_point = static_cast<int>(i * chunk_size * channels);
+    float display_width = this->GetSize().GetWidth();
+    float display_height = this->GetSize().GetHeight();
 
-            // Iterate on the chunk, get the square of sum of monos
-            for (int j = 0; j < chunk_size; j++)
-            {
-                if (channels == 2)
-                    mono = 0.5f * (sample[start_point + (2 * j)] + sample[start_point + (2 * j) + 1]);
-                else
-                    mono = sample[start_point + j];
+    int number_of_bars = static_cast<int>(display_width);
 
-                sum += mono * mono; // Square
-            }
+    if (number_of_bars <= 0)
+        return;
 
-            sum /= chunk_size;      // Mean
-            sum = pow(sum, 0.5);    // Root
+    const uint64_t frames = peaks->GetFrames();
 
-            // We might bleed a bit on the end and get some near infs, dunno
-            // what is causing astronomically big numbers from sample[]
-            if ((sum < 200.0) && (sum > normalize))
-                normalize = sum;
+    const SampleHive::cPeakPyramid::Level* level = m_pPeaks ? &m_pPeaks->GetLevelFor(number_of_bars) : nullptr;
+    const SampleHive::cPeakPyramid::Level* sketch = m_pSketch ? &m_pSketch->GetLevelFor(number_of_bars) : nullptr;
 
-            waveform.push_back(sum);
-        }
+    std::vector<float> waveform;
 
-        // Actually normalize
-        for (size_t i = 0; i < waveform.size(); i++)
-            waveform[i] /= normalize;
+    // Start with low non-zero value
+    float normalize = 0.00001;
 
-        // Draw code
-        wxMemoryDC mdc(m_WaveformBitmap);
+    for (int i = 0; i < number_of_bars; i++)
+    {
+        uint64_t begin = frames * i / number_of_bars;
+        uint64_t end = std::max(begin + 1, frames * (i + 1) / number_of_bars);
 
-        mdc.SetBackground(wxBrush(wxColour(0, 0, 0, 150), wxBRUSHSTYLE_SOLID));
-        mdc.Clear();
+        double sum = 0;
 
-        m_WaveformColour = serializer.DeserializeWaveformColour();
+        if (!(level && bar_rms(*level, begin, end, sum)) && !(sketch && bar_rms(*sketch, begin, end, sum)))
+            sum = 0;
 
-        mdc.SetPen(wxPen(wxColour(m_WaveformColour), 2, wxPENSTYLE_SOLID));
+        if ((sum < 200.0) && (sum > normalize))
+            normalize = sum;
 
-        SH_LOG_DEBUG("Drawing bitmap..");
+        waveform.push_back(sum);
+    }
 
-        for (size_t i = 0; i < waveform.size() - 1; i++)
-        {
-            float half_display_height = static_cast<float>(display_height) / 2.0f;
+    // Actually normalize
+    for (size_t i = 0; i < waveform.size(); i++)
+        waveform[i] /= normalize;
 
-            // X is percentage of i relative to waveform.size() multiplied by
-            // the width, Y is the half height times the value up or down
-            float X = display_width * ((float)i / waveform.size());
-            float Y = waveform[i] * half_display_height;
+    // Draw code
+    wxMemoryDC mdc(m_WaveformBitmap);
 
-            mdc.DrawLine(X, half_display_height + Y, X, half_display_height - Y);
-        }
+    mdc.SetBackground(wxBrush(wxColour(0, 0, 0, 150), wxBRUSHSTYLE_SOLID));
+    mdc.Clear();
 
-        SH_LOG_DEBUG("Done drawing bitmap..");
-    }
-    catch (std::exception& e)
+    m_WaveformColour = serializer.DeserializeWaveformColour();
+
+    mdc.SetPen(wxPen(wxColour(m_WaveformColour), 2, wxPENSTYLE_SOLID));
+
+    SH_LOG_DEBUG("Drawing bitmap..");
+
+    for (size_t i = 0; i < waveform.size() - 1; i++)
     {
-        SH_LOG_ERROR("Error! SNDFILE {}", e.what());
-        SH_LOG_ERROR("Error! SNDFILE {}", sf_strerror(snd_file.rawHandle()));
+        float half_display_height = static_cast<float>(display_height) / 2.0f;
+
+        // X is percentage of i relative to waveform.size() multiplied by
+        // the width, Y is the half height times the value up or down
+        float X = display_width * ((float)i / waveform.size());
+        float Y = waveform[i] * half_display_height;
+
+        mdc.DrawLine(X, half_display_height + Y, X, half_display_height - Y);
     }
+
+    SH_LOG_DEBUG("Done drawing bitmap..");
 }
 
 void cWaveformViewer::OnControlKeyDown(wxKeyEvent &event)
@@ -303,17 +370,10 @@ void cWaveformViewer::OnMouseMotion(wxMouseEvent& event)
     if (selected_row < 0)
         return;
 
-    wxString selected = SampleHive::cHiveData::Get().GetListCtrlTextValue(selected_row, 1);
-    std::string path = SampleHive::cUtils::Get().GetFilenamePathAndExtension(selected).Path.ToStdString();
-
-    SampleHive::cTags tags(path);
-
-    int length = tags.GetAudioInfo().length;
-
-    double position = m_MediaCtrl.Tell();
+    int length = SampleHive::cHiveData::Get().GetListCtrlSampleLength(selected_row);
 
     int panel_width = this->GetSize().GetWidth();
-    double line_pos = panel_width * (position / length);
+    double line_pos = GetPlayheadX();
 
     wxPoint pos = event.GetPosition();
 
@@ -343,17 +403,7 @@ void cWaveformViewer::OnMouseLeftButtonDown(wxMouseEvent& event)
     if (selected_row < 0)
         return;
 
-    wxString selected = SampleHive::cHiveData::Get().GetListCtrlTextValue(selected_row, 1);
-    std::string path = SampleHive::cUtils::Get().GetFilenamePathAndExtension(selected).Path.ToStdString();
-
-    SampleHive::cTags tags(path);
-
-    int length = tags.GetAudioInfo().length;
-
-    double position = m_MediaCtrl.Tell();
-
-    int panel_width = this->GetSize().GetWidth();
-    double line_pos = panel_width * (position / length);
+    double line_pos = GetPlayheadX();
 
     wxPoint pos = event.GetPosition();
 
@@ -393,16 +443,11 @@ void cWaveformViewer::OnMouseLeftButtonUp(wxMouseEvent& event)
         return;
 
     wxString selected = SampleHive::cHiveData::Get().GetListCtrlTextValue(selected_row, 1);
-    std::string path = SampleHive::cUtils::Get().GetFilenamePathAndExtension(selected).Path.ToStdString();
-
-    SampleHive::cTags tags(path);
 
-    int length = tags.GetAudioInfo().length;
-
-    double position = m_MediaCtrl.Tell();
+    int length = SampleHive::cHiveData::Get().GetListCtrlSampleLength(selected_row);
 
     int panel_width = this->GetSize().GetWidth();
-    double line_pos = panel_width * (position / length);
+    double line_pos = GetPlayheadX();
 
     wxPoint pos = event.GetPosition();
 
@@ -428,16 +473,22 @@ void cWaveformViewer::OnMouseLeftButtonUp(wxMouseEvent& event)
         bSelectRange = false;
 
         if (!bSelectRange)
+        {
             bDrawSelectedArea = true;
+
+            // Sent once per selection, paints only happen to redraw it
+            SampleHive::cSignal::SendLoopPoints(CalculateLoopPoints(), *this);
+        }
     }
     else
     {
         ReleaseMouse();
         SetCursor(wxCURSOR_ARROW);
 
-        m_MediaCtrl.Seek(seek_to, wxFromStart);
+        m_AudioEngine.Seek(static_cast<int64_t>(seek_to));
         SampleHive::cSignal::SendPushStatusBarStatus(wxString::Format(_("Now playing: %s"), selected), 1, *this);
-        SampleHive::cSignal::SendCallFunctionPlay(selected, false, *this);
+        SampleHive::cSignal::SendCallFunctionPlay(selected, SampleHive::cHiveData::Get().GetListCtrlSamplePath(selected_row),
+                                                  false, *this);
     }
 }
 
@@ -457,12 +508,7 @@ std::pair<double, double> cWaveformViewer::CalculateLoopPoints()
     if (selected_row < 0)
         return { 0.0, 0.0 };
 
-    wxString selected = SampleHive::cHiveData::Get().GetListCtrlTextValue(selected_row, 1);
-    std::string path = SampleHive::cUtils::Get().GetFilenamePathAndExtension(selected).Path.ToStdString();
-
-    SampleHive::cTags tags(path);
-
-    int length = tags.GetAudioInfo().length;
+    int length = SampleHive::cHiveData::Get().GetListCtrlSampleLength(selected_row);
 
     int panel_width = this->GetSize().GetWidth();
 
@@ -20,11 +20,18 @@
 
 #pragma once
 
+#include "Audio/AudioEngine.hpp"
+#include "GUI/WaveformWorker.hpp"
+#include "Utility/Event.hpp"
+#include "Utility/PeakPyramid.hpp"
+
+#include <memory>
+#include <string>
+
 #include <wx/bitmap.h>
 #include <wx/colour.h>
 #include <wx/dc.h>
 #include <wx/event.h>
-#include <wx/mediactrl.h>
 #include <wx/panel.h>
 #include <wx/sizer.h>
 #include <wx/statusbr.h>
@@ -33,7 +40,7 @@
 class cWaveformViewer : public wxPanel
 {
     public:
-        cWaveformViewer(wxWindow* window, wxMediaCtrl& mediaCtrl);
+        cWaveformViewer(wxWindow* window, SampleHive::cAudioEngine& audioEngine);
         ~cWaveformViewer();
 
     private:
@@ -43,12 +50,23 @@ class cWaveformViewer : public wxPanel
         wxBoxSizer* m_Sizer;
 
         // -------------------------------------------------------------------
-        wxMediaCtrl& m_MediaCtrl;
+        SampleHive::cAudioEngine& m_AudioEngine;
 
     private:
+        // -------------------------------------------------------------------
+        cWaveformWorker m_WaveformWorker;
+
+        std::shared_ptr<const SampleHive::cPeakPyramid> m_pPeaks;
+        std::shared_ptr<const SampleHive::cPeakPyramid> m_pSketch;
+        std::string m_PeaksPath;
+        unsigned long m_PeaksGeneration = 0;
+
         // -------------------------------------------------------------------
         wxBitmap m_WaveformBitmap;
         wxColour m_PlayheadColour;
+
+        // Column the playhead was last painted at, -1 if it was not
+        int m_PlayheadX = -1;
         wxColour m_WaveformColour;
 
         // -------------------------------------------------------------------
@@ -67,6 +85,9 @@ class cWaveformViewer : public wxPanel
         // -------------------------------------------------------------------
         void OnPaint(wxPaintEvent& event);
         void RenderPlayhead(wxDC& dc);
+        double GetPlayheadX() const;
+        void RequestPeaks();
+        void OnWaveformPeaks(SampleHive::cWaveformPeaksEvent& event);
         void UpdateWaveformBitmap();
 
         // -------------------------------------------------------------------
@@ -86,4 +107,8 @@ class cWaveformViewer : public wxPanel
     public:
         // -------------------------------------------------------------------
         void ResetBitmapDC();
+
+        // Repaint only the strips under the old and new playhead, nothing
+        // when it has not moved by a pixel
+        void UpdatePlayhead();
 };
@@ -0,0 +1,169 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "GUI/WaveformWorker.hpp"
+#include "Utility/AudioAnalysis.hpp"
+#include "Utility/Event.hpp"
+#include "Utility/Log.hpp"
+#include "Utility/Trace.hpp"
+
+#include <utility>
+
+constexpr std::chrono::milliseconds cWaveformWorker::s_PostInterval;
+
+cWaveformWorker::cWaveformWorker(wxEvtHandler& handler)
+    : m_Handler(handler), m_Generation(0)
+{
+    m_Thread = std::thread(&cWaveformWorker::Run, this);
+}
+
+unsigned long cWaveformWorker::Render(const std::string& path)
+{
+    unsigned long generation;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_PendingPath = path;
+        m_bPending = true;
+
+        generation = ++m_Generation;
+    }
+
+    m_Condition.notify_one();
+
+    return generation;
+}
+
+void cWaveformWorker::Cancel()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_bPending = false;
+    ++m_Generation;
+}
+
+void cWaveformWorker::Run()
+{
+    while (true)
+    {
+        std::string path;
+        unsigned long generation;
+
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+
+            m_Condition.wait(lock, [this] { return m_bPending || m_bStop; });
+
+            if (m_bStop)
+                break;
+
+            path = m_PendingPath;
+            generation = m_Generation.load();
+            m_bPending = false;
+        }
+
+        RunJob(path, generation);
+    }
+}
+
+void cWaveformWorker::RunJob(const std::string& path, unsigned long generation)
+{
+    SH_TRACE_SCOPE("waveform.peaks");
+
+    std::shared_ptr<const SampleHive::cPeakPyramid> stored = SampleHive::cPeakPyramid::Open(path);
+
+    if (stored)
+    {
+        PostPeaks(std::move(stored), generation, false, true);
+        return;
+    }
+
+    SH_LOG_INFO("Analysing {} for waveform peaks..", path);
+
+    SampleHive::AudioAnalysis sketch;
+
+    if (SampleHive::cAudioAnalyser::Sketch(path, s_SketchPeaks, sketch) && !IsStale(generation))
+        PostPeaks(SampleHive::cPeakPyramid::Build(sketch), generation, true, false);
+
+    auto last_post = std::chrono::steady_clock::now();
+
+    auto progress = [&](const SampleHive::AudioAnalysis& partial)
+    {
+        // A newer selection replaced this job
+        if (IsStale(generation))
+            return false;
+
+        const auto now = std::chrono::steady_clock::now();
+
+        if (now - last_post >= s_PostInterval)
+        {
+            PostPeaks(SampleHive::cPeakPyramid::Build(partial), generation, false, false);
+            last_post = now;
+        }
+
+        return true;
+    };
+
+    SampleHive::AudioAnalysis analysis;
+
+    if (!SampleHive::cAudioAnalyser::Analyse(path, analysis, progress))
+    {
+        if (!IsStale(generation))
+        {
+            SH_LOG_ERROR("Error! Cannot decode {}", path);
+            PostPeaks(nullptr, generation, false, true);
+        }
+
+        return;
+    }
+
+    std::unique_ptr<SampleHive::cPeakPyramid> peaks = SampleHive::cPeakPyramid::Build(analysis);
+
+    if (!peaks->Save(path))
+        SH_LOG_WARN("Cannot store waveform peaks for {}", path);
+
+    PostPeaks(std::move(peaks), generation, false, true);
+}
+
+void cWaveformWorker::PostPeaks(std::shared_ptr<const SampleHive::cPeakPyramid> peaks, unsigned long generation,
+                                bool sketch, bool complete)
+{
+    auto event = new SampleHive::cWaveformPeaksEvent(SampleHive::SH_EVT_WAVEFORM_PEAKS, wxID_ANY);
+    event->SetPeaks(std::move(peaks));
+    event->SetGeneration(generation);
+    event->SetSketch(sketch);
+    event->SetComplete(complete);
+
+    wxQueueEvent(&m_Handler, event);
+}
+
+cWaveformWorker::~cWaveformWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_bStop = true;
+        ++m_Generation;
+    }
+
+    m_Condition.notify_one();
+    m_Thread.join();
+}
@@ -0,0 +1,83 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Utility/PeakPyramid.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <wx/event.h>
+
+// Loads or computes the waveform peaks of a sample on its own thread. Stored
+// peaks are posted as they are, otherwise a quick sketch comes first and the
+// decode posts what it has every s_PostInterval until it completes.
+class cWaveformWorker
+{
+    public:
+        cWaveformWorker(wxEvtHandler& handler);
+        ~cWaveformWorker();
+
+    public:
+        // -------------------------------------------------------------------
+        cWaveformWorker(const cWaveformWorker&) = delete;
+        cWaveformWorker& operator=(const cWaveformWorker&) = delete;
+
+    public:
+        // -------------------------------------------------------------------
+        // Replace any pending job and stop the one running, returns the
+        // generation the peaks will be tagged with
+        unsigned long Render(const std::string& path);
+
+        void Cancel();
+
+    private:
+        // -------------------------------------------------------------------
+        void Run();
+        void RunJob(const std::string& path, unsigned long generation);
+        void PostPeaks(std::shared_ptr<const SampleHive::cPeakPyramid> peaks, unsigned long generation,
+                       bool sketch, bool complete);
+
+        bool IsStale(unsigned long generation) const { return generation != m_Generation.load(); }
+
+    private:
+        // -------------------------------------------------------------------
+        static constexpr size_t s_SketchPeaks = 512;
+        static constexpr std::chrono::milliseconds s_PostInterval{100};
+
+        wxEvtHandler& m_Handler;
+
+        // -------------------------------------------------------------------
+        std::thread m_Thread;
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+
+        std::string m_PendingPath;
+        bool m_bPending = false;
+        bool m_bStop = false;
+
+        std::atomic<unsigned long> m_Generation;
+};
@@ -0,0 +1,278 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Audio
+
+#include "Utility/AudioAnalysis.hpp"
+#include "Utility/Log.hpp"
+#include "Utility/PeakKernel.hpp"
+#include "Utility/Utils.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+#include <sys/stat.h>
+
+#include <sndfile.hh>
+
+#include <aubio/aubio.h>
+
+#include <xxhash.h>
+
+namespace SampleHive {
+
+    static_assert(cAudioAnalyser::s_BlockSize % cAudioAnalyser::s_FramesPerPeak == 0,
+                  "a block must hold a whole number of peaks");
+
+    // XXH3 over the format and the decoded samples, the container and the
+    // tags don't change it
+    class cFingerprint
+    {
+        public:
+            cFingerprint(int channels, int sampleRate, uint64_t frames)
+                : m_pState(XXH3_createState())
+            {
+                const uint64_t header[] = { static_cast<uint64_t>(channels),
+                                            static_cast<uint64_t>(sampleRate), frames };
+
+                if (m_pState && XXH3_64bits_reset(m_pState) == XXH_OK)
+                    Update(header, sizeof(header));
+            }
+
+            ~cFingerprint()
+            {
+                XXH3_freeState(m_pState);
+            }
+
+        public:
+            cFingerprint(const cFingerprint&) = delete;
+            cFingerprint& operator=(const cFingerprint&) = delete;
+
+        public:
+            void Update(const void* data, size_t size)
+            {
+                if (m_pState)
+                    XXH3_64bits_update(m_pState, data, size);
+            }
+
+            // 0 is kept for not fingerprinted
+            uint64_t Digest() const
+            {
+                if (!m_pState)
+                    return 0;
+
+                const uint64_t digest = XXH3_64bits_digest(m_pState);
+                return digest ? digest : 1;
+            }
+
+        private:
+            XXH3_state_t* m_pState;
+    };
+
+    bool cAudioAnalyser::Analyse(const std::string& path, AudioAnalysis& analysis, const Progress& progress)
+    {
+        SndfileHandle file(path.c_str());
+
+        if (!file || file.error() != SF_ERR_NO_ERROR || file.channels() <= 0 || file.samplerate() <= 0)
+            return false;
+
+        const int channels = file.channels();
+
+        analysis.Channels = channels;
+        analysis.SampleRate = file.samplerate();
+        analysis.Frames = static_cast<uint64_t>(std::max<sf_count_t>(file.frames(), 0));
+        analysis.Length = static_cast<int>(analysis.Frames * 1000 / analysis.SampleRate);
+        analysis.FramesPerPeak = s_FramesPerPeak;
+
+        analysis.Peaks.clear();
+        analysis.Peaks.reserve(analysis.Frames / s_FramesPerPeak + 1);
+
+        // Compressed formats report their own rate, otherwise estimate it
+        // from the size of the file like TagLib does for PCM
+        const int byterate = sf_current_byterate(file.rawHandle());
+
+        if (byterate > 0)
+            analysis.Bitrate = byterate * 8 / 1000;
+        else
+        {
+            struct stat info;
+
+            if (analysis.Length > 0 && stat(path.c_str(), &info) == 0)
+                analysis.Bitrate = static_cast<int>(static_cast<uint64_t>(info.st_size) * 8 / analysis.Length);
+        }
+
+        aubio_tempo_t* tempo = nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(cUtils::Get().GetAubioMutex());
+            tempo = new_aubio_tempo("default", s_BlockSize * 2, s_BlockSize, analysis.SampleRate);
+        }
+
+        fvec_t* in = new_fvec(s_BlockSize);
+        fvec_t* out = new_fvec(1);
+
+        std::vector<float> block(s_BlockSize * channels);
+
+        cFingerprint fingerprint(channels, analysis.SampleRate, analysis.Frames);
+
+        sf_count_t read = 0;
+        unsigned int blocks = 0;
+        bool stopped = false;
+
+        do
+        {
+            read = file.readf(block.data(), s_BlockSize);
+
+            if (read <= 0)
+                break;
+
+            fingerprint.Update(block.data(), read * channels * sizeof(float));
+
+            // Down mix to mono, the tempo tracker and the waveform both work
+            // on the average of all channels
+            cPeakKernel::Downmix(block.data(), read, channels, in->data);
+
+            // Blocks hold whole peaks, only the last one of the file can be short
+            const size_t peaks = analysis.Peaks.size();
+            analysis.Peaks.resize(peaks + (read + s_FramesPerPeak - 1) / s_FramesPerPeak);
+            cPeakKernel::Reduce(in->data, read, s_FramesPerPeak, analysis.Peaks.data() + peaks);
+
+            std::fill(in->data + read, in->data + s_BlockSize, 0.0f);
+
+            if (tempo)
+            {
+                aubio_tempo_do(tempo, in, out);
+                analysis.BPM = aubio_tempo_get_bpm(tempo);
+            }
+
+            if (progress && ++blocks % s_ProgressBlocks == 0 && !progress(analysis))
+            {
+                stopped = true;
+                break;
+            }
+        }
+        while (read == s_BlockSize);
+
+        del_fvec(in);
+        del_fvec(out);
+
+        if (tempo)
+        {
+            std::lock_guard<std::mutex> lock(cUtils::Get().GetAubioMutex());
+            del_aubio_tempo(tempo);
+        }
+
+        if (stopped)
+            return false;
+
+        if (file.error() != SF_ERR_NO_ERROR)
+        {
+            SH_LOG_ERROR("Error! SNDFILE {}: {}", path, file.strError());
+            return false;
+        }
+
+        analysis.Fingerprint = fingerprint.Digest();
+
+        return true;
+    }
+
+    bool cAudioAnalyser::Fingerprint(const std::string& path, uint64_t& fingerprint)
+    {
+        SndfileHandle file(path.c_str());
+
+        if (!file || file.error() != SF_ERR_NO_ERROR || file.channels() <= 0 || file.samplerate() <= 0)
+            return false;
+
+        const int channels = file.channels();
+        const uint64_t frames = static_cast<uint64_t>(std::max<sf_count_t>(file.frames(), 0));
+
+        cFingerprint state(channels, file.samplerate(), frames);
+
+        // Larger blocks than Analyse, nothing else is done with them
+        const sf_count_t block_size = s_BlockSize * 16;
+        std::vector<float> block(block_size * channels);
+
+        sf_count_t read = 0;
+
+        do
+        {
+            read = file.readf(block.data(), block_size);
+
+            if (read <= 0)
+                break;
+
+            state.Update(block.data(), read * channels * sizeof(float));
+        }
+        while (read == block_size);
+
+        if (file.error() != SF_ERR_NO_ERROR)
+        {
+            SH_LOG_ERROR("Error! SNDFILE {}: {}", path, file.strError());
+            return false;
+        }
+
+        fingerprint = state.Digest();
+
+        return fingerprint != 0;
+    }
+
+    bool cAudioAnalyser::Sketch(const std::string& path, size_t count, AudioAnalysis& analysis)
+    {
+        SndfileHandle file(path.c_str());
+
+        if (!file || file.error() != SF_ERR_NO_ERROR || file.channels() <= 0 || file.samplerate() <= 0 ||
+            !file.seekable() || count == 0)
+            return false;
+
+        const int channels = file.channels();
+        const uint64_t frames = static_cast<uint64_t>(std::max<sf_count_t>(file.frames(), 0));
+
+        // Not worth it when decoding the whole file is about as quick
+        if (frames < count * s_FramesPerPeak * 4)
+            return false;
+
+        analysis.Channels = channels;
+        analysis.SampleRate = file.samplerate();
+        analysis.Frames = frames;
+        analysis.Length = static_cast<int>(frames * 1000 / analysis.SampleRate);
+        analysis.FramesPerPeak = static_cast<uint32_t>((frames + count - 1) / count);
+        analysis.Peaks.resize(count);
+
+        std::vector<float> block(s_FramesPerPeak * channels);
+        std::vector<float> mono(s_FramesPerPeak);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            if (file.seek(static_cast<sf_count_t>(i * analysis.FramesPerPeak), SEEK_SET) < 0)
+                return false;
+
+            const sf_count_t read = file.readf(block.data(), s_FramesPerPeak);
+
+            if (read <= 0)
+                return false;
+
+            cPeakKernel::Downmix(block.data(), read, channels, mono.data());
+            cPeakKernel::Reduce(mono.data(), read, static_cast<uint32_t>(read), &analysis.Peaks[i]);
+        }
+
+        return true;
+    }
+
+}
@@ -0,0 +1,89 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace SampleHive {
+
+    // Mono summary of a run of frames, used to draw the waveform
+    struct Peak
+    {
+        float Min;
+        float Max;
+        float RMS;
+    };
+
+    struct AudioAnalysis
+    {
+        int Channels = 0;
+        int SampleRate = 0;
+        int Bitrate = 0;
+        int Length = 0;
+        float BPM = 0.0f;
+
+        // Identifies the decoded audio, same for the same sound in any
+        // container or under any name. 0 when it could not be computed.
+        uint64_t Fingerprint = 0;
+
+        uint64_t Frames = 0;
+        uint32_t FramesPerPeak = 0;
+        std::vector<Peak> Peaks;
+    };
+
+    // Decodes a file once through libsndfile and derives everything the
+    // library keeps about it from that single pass: the audio properties,
+    // the tempo, the waveform peaks and the content fingerprint.
+    class cAudioAnalyser
+    {
+        public:
+            // Frames read per block, also the hop size of the tempo tracker
+            static const unsigned int s_BlockSize = 512;
+
+            // Frames summarised by each peak
+            static const uint32_t s_FramesPerPeak = 256;
+
+            // Blocks decoded between progress calls
+            static const unsigned int s_ProgressBlocks = 128;
+
+        public:
+            // -------------------------------------------------------------------
+            // Called now and then with the peaks decoded so far, returning
+            // false stops the analysis
+            using Progress = std::function<bool(const AudioAnalysis& partial)>;
+
+            // Returns false if libsndfile cannot decode the file or the
+            // analysis was stopped
+            static bool Analyse(const std::string& path, AudioAnalysis& analysis,
+                                const Progress& progress = Progress());
+
+            // Only the fingerprint, for files imported before it was stored
+            static bool Fingerprint(const std::string& path, uint64_t& fingerprint);
+
+            // Quick outline from a short window at each of count evenly spaced
+            // points, no tempo. Returns false for short or unseekable files.
+            static bool Sketch(const std::string& path, size_t count, AudioAnalysis& analysis);
+    };
+
+}
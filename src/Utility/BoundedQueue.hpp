@@ -0,0 +1,139 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace SampleHive {
+
+    // Fixed capacity queue between threads, producers block while it is full
+    // so a fast stage cannot run ahead of a slow one.
+    template<typename T>
+    class cBoundedQueue
+    {
+        public:
+            cBoundedQueue(size_t capacity) : m_Capacity(capacity) {}
+
+        public:
+            // -------------------------------------------------------------------
+            cBoundedQueue(const cBoundedQueue&) = delete;
+            cBoundedQueue& operator=(const cBoundedQueue&) = delete;
+
+        public:
+            enum class ePop
+            {
+                Item,
+                Timeout,
+                Closed
+            };
+
+        public:
+            // -------------------------------------------------------------------
+            // Returns false once the queue is closed, the item is dropped
+            bool Push(T item)
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+
+                m_NotFull.wait(lock, [this] { return m_bClosed || m_Items.size() < m_Capacity; });
+
+                if (m_bClosed)
+                    return false;
+
+                m_Items.push_back(std::move(item));
+                m_NotEmpty.notify_one();
+
+                return true;
+            }
+
+            // Returns false once the queue is closed and drained
+            bool Pop(T& item)
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+
+                m_NotEmpty.wait(lock, [this] { return m_bClosed || !m_Items.empty(); });
+
+                return TakeFront(item);
+            }
+
+            template<typename Rep, typename Period>
+            ePop PopFor(T& item, const std::chrono::duration<Rep, Period>& timeout)
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+
+                if (!m_NotEmpty.wait_for(lock, timeout, [this] { return m_bClosed || !m_Items.empty(); }))
+                    return ePop::Timeout;
+
+                return TakeFront(item) ? ePop::Item : ePop::Closed;
+            }
+
+            // -------------------------------------------------------------------
+            // No more items will be pushed, consumers drain what is left
+            void Close()
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+
+                m_bClosed = true;
+                m_NotEmpty.notify_all();
+                m_NotFull.notify_all();
+            }
+
+            // Close and throw away whatever is still queued
+            void Abort()
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+
+                m_bClosed = true;
+                m_Items.clear();
+                m_NotEmpty.notify_all();
+                m_NotFull.notify_all();
+            }
+
+        private:
+            // -------------------------------------------------------------------
+            bool TakeFront(T& item)
+            {
+                if (m_Items.empty())
+                    return false;
+
+                item = std::move(m_Items.front());
+                m_Items.pop_front();
+                m_NotFull.notify_one();
+
+                return true;
+            }
+
+        private:
+            // -------------------------------------------------------------------
+            const size_t m_Capacity;
+
+            std::deque<T> m_Items;
+            std::mutex m_Mutex;
+            std::condition_variable m_NotEmpty;
+            std::condition_variable m_NotFull;
+
+            bool m_bClosed = false;
+    };
+
+}
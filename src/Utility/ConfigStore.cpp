@@ -0,0 +1,205 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Config
+
+#include "Utility/ConfigStore.hpp"
+#include "Utility/Log.hpp"
+#include "Utility/Paths.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <yaml-cpp/exceptions.h>
+
+namespace SampleHive {
+
+    cConfigStore::cConfigStore()
+    {
+
+    }
+
+    YAML::Node cConfigStore::GetConfig()
+    {
+        if (!m_bLoaded)
+            Load();
+
+        return m_Config;
+    }
+
+    bool cConfigStore::IsEmpty()
+    {
+        if (!m_bLoaded)
+            Load();
+
+        return !m_Config.IsMap();
+    }
+
+    void cConfigStore::Create(const std::string& contents)
+    {
+        // Write has logged why if it failed
+        Write(contents);
+
+        try
+        {
+            m_Config = YAML::Load(contents);
+        }
+        catch (const YAML::ParserException& ex)
+        {
+            SH_LOG_ERROR(ex.what());
+        }
+
+        m_bLoaded = true;
+        m_bDirty = false;
+    }
+
+    void cConfigStore::MarkDirty()
+    {
+        m_bDirty = true;
+
+        if (!m_pTimer)
+            m_pTimer = new cWriteTimer(*this);
+
+        m_pTimer->StartOnce(s_WriteDelay);
+    }
+
+    void cConfigStore::Flush()
+    {
+        if (m_pTimer)
+            m_pTimer->Stop();
+
+        if (!m_bDirty)
+            return;
+
+        YAML::Emitter out;
+        out << m_Config;
+
+        if (Write(out.c_str()))
+            m_bDirty = false;
+    }
+
+    void cConfigStore::Close()
+    {
+        Flush();
+
+        delete m_pTimer;
+        m_pTimer = nullptr;
+    }
+
+    void cConfigStore::Discard()
+    {
+        if (m_pTimer)
+            m_pTimer->Stop();
+
+        m_Config = YAML::Node();
+        m_bLoaded = false;
+        m_bDirty = false;
+    }
+
+    void cConfigStore::Load()
+    {
+        m_bLoaded = true;
+
+        try
+        {
+            m_Config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+        }
+        catch (const YAML::BadFile&)
+        {
+            // No config yet, cSerializer generates one
+            m_Config = YAML::Node();
+        }
+        catch (const YAML::ParserException& ex)
+        {
+            SH_LOG_ERROR(ex.what());
+            m_Config = YAML::Node();
+        }
+    }
+
+    bool cConfigStore::Write(const std::string& contents)
+    {
+        const std::string path = static_cast<std::string>(CONFIG_FILEPATH);
+        const std::string temp_path = path + ".tmp";
+
+        const int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+        if (fd < 0)
+        {
+            SH_LOG_ERROR("Error! Cannot open {}: {}", temp_path, std::strerror(errno));
+            return false;
+        }
+
+        size_t written = 0;
+
+        while (written < contents.size())
+        {
+            const ssize_t count = write(fd, contents.data() + written, contents.size() - written);
+
+            if (count < 0 && errno == EINTR)
+                continue;
+
+            if (count <= 0)
+                break;
+
+            written += static_cast<size_t>(count);
+        }
+
+        // The data has to be on disk before the rename is, or a crash right
+        // after can leave an empty config under the real name
+        if (written < contents.size() || fsync(fd) != 0)
+        {
+            SH_LOG_ERROR("Error! Cannot write {}: {}", temp_path, std::strerror(errno));
+            close(fd);
+            std::remove(temp_path.c_str());
+            return false;
+        }
+
+        close(fd);
+
+        if (std::rename(temp_path.c_str(), path.c_str()) != 0)
+        {
+            SH_LOG_ERROR("Error! Cannot replace {}: {}", path, std::strerror(errno));
+            std::remove(temp_path.c_str());
+            return false;
+        }
+
+        // Makes the rename itself survive a crash
+        const std::string directory = path.substr(0, path.find_last_of('/') + 1);
+        const int dir_fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+        if (dir_fd >= 0)
+        {
+            fsync(dir_fd);
+            close(dir_fd);
+        }
+
+        return true;
+    }
+
+    cConfigStore::~cConfigStore()
+    {
+        // Runs after wx is torn down, Close has been called by then
+    }
+
+}
@@ -0,0 +1,111 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+
+#include <wx/timer.h>
+
+#include <yaml-cpp/yaml.h>
+
+namespace SampleHive {
+
+    // The parsed config.yaml, shared by every cSerializer. The file is read
+    // once, changes are made to the node in memory and written back once
+    // they stop coming for s_WriteDelay, through a temporary file and a
+    // rename so a crash never leaves half a config behind. UI thread only.
+    class cConfigStore
+    {
+        private:
+            cConfigStore();
+
+        public:
+            ~cConfigStore();
+
+        public:
+            cConfigStore(const cConfigStore&) = delete;
+            cConfigStore& operator=(const cConfigStore&) = delete;
+
+        public:
+            static cConfigStore& Get()
+            {
+                static cConfigStore s_ConfigStore;
+                return s_ConfigStore;
+            }
+
+        public:
+            // -------------------------------------------------------------------
+            // The node is shared, changes made through it are seen by the next
+            // reader but only reach the disk after MarkDirty
+            YAML::Node GetConfig();
+
+            // True when there is no config file yet, or it could not be parsed
+            bool IsEmpty();
+
+            // Write a freshly generated file right away and use it
+            void Create(const std::string& contents);
+
+            // Schedule a write, restarting the delay if one is pending
+            void MarkDirty();
+
+            // Write a pending change now
+            void Flush();
+
+            // Flush and let go of the timer while wx is still up
+            void Close();
+
+            // Forget the config after the file was deleted, the next
+            // cSerializer generates a new one
+            void Discard();
+
+        private:
+            // -------------------------------------------------------------------
+            void Load();
+            // Logs why it failed
+            bool Write(const std::string& contents);
+
+        private:
+            // -------------------------------------------------------------------
+            class cWriteTimer : public wxTimer
+            {
+                public:
+                    cWriteTimer(cConfigStore& store) : m_Store(store) {}
+
+                public:
+                    void Notify() override { m_Store.Flush(); }
+
+                private:
+                    cConfigStore& m_Store;
+            };
+
+        private:
+            // -------------------------------------------------------------------
+            static const int s_WriteDelay = 500;
+
+            YAML::Node m_Config;
+            bool m_bLoaded = false;
+            bool m_bDirty = false;
+
+            // Created on the first change, wx is not up when the store is
+            cWriteTimer* m_pTimer = nullptr;
+    };
+
+}
@@ -46,11 +46,12 @@ namespace SampleHive { namespace ID {
         BC_DirCtrl,
         BC_Library,
         BC_Search,
-        BC_MediaCtrl,
         BC_Trash,
         BC_RestoreTrashedItem,
         BC_HiveAdd,
         BC_HiveRemove,
+        BC_ImportPause,
+        BC_ImportCancel,
 
         // -------------------------------------------------------------------
         // Setting dialog controls
@@ -75,6 +76,7 @@ namespace SampleHive { namespace ID {
         MN_ToggleExtension,
         MN_ToggleMenuBar,
         MN_ToggleStatusBar,
+        MN_FindDuplicates,
 
         // -------------------------------------------------------------------
         // Library Menu items
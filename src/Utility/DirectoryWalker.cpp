@@ -0,0 +1,443 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Import
+
+#include "Utility/DirectoryWalker.hpp"
+#include "Utility/Log.hpp"
+#include "Utility/Trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+    // Files are handed on this many at a time
+    const size_t s_BatchSize = 256;
+    const size_t s_BatchQueueSize = 64;
+
+    // Walking is bound by the disk more than the CPU, past this many
+    // threads the requests only queue up in the kernel
+    const unsigned int s_MaxThreads = 8;
+
+    const size_t s_DirentBufferSize = 32 * 1024;
+    const std::chrono::milliseconds s_IdleWait(1);
+
+    // What getdents64 fills the buffer with, glibc only declares it in newer releases
+    struct linux_dirent64
+    {
+        ino64_t d_ino;
+        off64_t d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+        char d_name[];
+    };
+
+    // Formats libsndfile or TagLib can read
+    const char* const s_AudioExtensions[] = {
+        "wav", "wave", "bwf", "rf64", "w64", "aif", "aiff", "aifc", "caf", "au", "snd", "voc",
+        "flac", "ogg", "oga", "opus", "spx", "mp3", "mp2", "m4a", "aac", "wv", "ape", "wma"
+    };
+
+    // Sets hasExtension when the name has one at all, dot files don't count
+    bool has_audio_extension(const char* name, bool& hasExtension)
+    {
+        const char* dot = std::strrchr(name, '.');
+
+        hasExtension = dot && dot != name && dot[1] != '\0';
+
+        if (!hasExtension)
+            return false;
+
+        return std::any_of(std::begin(s_AudioExtensions), std::end(s_AudioExtensions), [dot](const char* extension)
+        {
+            return strcasecmp(dot + 1, extension) == 0;
+        });
+    }
+
+    bool has_audio_header(int fd)
+    {
+        unsigned char header[12] = {};
+
+        const ssize_t size = pread(fd, header, sizeof(header), 0);
+
+        if (size < 4)
+            return false;
+
+        auto is = [&](size_t offset, const char* magic)
+        {
+            const size_t length = std::strlen(magic);
+
+            return offset + length <= static_cast<size_t>(size) && std::memcmp(header + offset, magic, length) == 0;
+        };
+
+        return ((is(0, "RIFF") || is(0, "RF64") || is(0, "BW64")) && is(8, "WAVE")) ||
+            (is(0, "FORM") && (is(8, "AIFF") || is(8, "AIFC"))) ||
+            is(0, "fLaC") || is(0, "OggS") || is(0, "caff") || is(0, ".snd") || is(0, "wvpk") ||
+            is(0, "MAC ") || is(4, "ftyp") || is(0, "ID3") ||
+            // MPEG audio frame sync
+            (header[0] == 0xFF && (header[1] & 0xE0) == 0xE0);
+    }
+
+    bool is_audio_file(int directory, const char* name)
+    {
+        bool has_extension = false;
+
+        if (has_audio_extension(name, has_extension))
+            return true;
+
+        if (has_extension)
+            return false;
+
+        const int fd = openat(directory, name, O_RDONLY | O_CLOEXEC | O_NOCTTY);
+
+        if (fd < 0)
+            return false;
+
+        const bool audio = has_audio_header(fd);
+
+        close(fd);
+
+        return audio;
+    }
+
+    std::string join(const std::string& directory, const char* name)
+    {
+        return directory == "/" ? directory + name : directory + '/' + name;
+    }
+
+}
+
+namespace SampleHive {
+
+    cDirectoryWalker::cDirectoryWalker(bool followSymLinks, bool recursive, unsigned int threads)
+        : m_bFollowSymLinks(followSymLinks), m_bRecursive(recursive),
+          m_ThreadCount(threads > 0 ? threads : std::max(1u, std::min(s_MaxThreads, std::thread::hardware_concurrency()))),
+          m_Pending(0), m_DirectoryCount(0), m_FileCount(0), m_IgnoredCount(0), m_bStopped(false)
+    {
+
+    }
+
+    bool cDirectoryWalker::IsAudioFile(const std::string& path)
+    {
+        const std::string name = path.substr(path.find_last_of('/') + 1);
+
+        bool has_extension = false;
+
+        if (has_audio_extension(name.c_str(), has_extension))
+            return true;
+
+        if (has_extension)
+            return false;
+
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC | O_NOCTTY);
+
+        if (fd < 0)
+            return false;
+
+        const bool audio = has_audio_header(fd);
+
+        close(fd);
+
+        return audio;
+    }
+
+    bool cDirectoryWalker::Walk(const std::vector<std::string>& roots,
+                                const std::function<bool(std::vector<std::string>&)>& onFiles,
+                                const std::atomic<bool>& cancelled)
+    {
+        SH_TRACE_SCOPE("walk");
+
+        m_Queues.clear();
+
+        for (unsigned int i = 0; i < m_ThreadCount; i++)
+            m_Queues.emplace_back(new WorkQueue());
+
+        m_Files.reset(new cBoundedQueue<std::vector<std::string>>(s_BatchQueueSize));
+        m_Visited.clear();
+
+        m_Pending = 0;
+        m_DirectoryCount = 0;
+        m_FileCount = 0;
+        m_IgnoredCount = 0;
+        m_bStopped = false;
+
+        // Roots were picked by hand, so links among them are always followed
+        std::vector<std::string> files;
+        unsigned int next = 0;
+
+        for (const auto& root : roots)
+        {
+            std::string path = root;
+
+            while (path.size() > 1 && path.back() == '/')
+                path.pop_back();
+
+            struct stat info;
+
+            if (stat(path.c_str(), &info) != 0)
+            {
+                SH_LOG_WARN("Cannot read {}, skipping", path);
+                continue;
+            }
+
+            if (S_ISDIR(info.st_mode))
+                Push(next++ % m_ThreadCount, std::move(path));
+            else if (S_ISREG(info.st_mode) && IsAudioFile(path))
+                files.push_back(std::move(path));
+            else
+                m_IgnoredCount++;
+        }
+
+        m_FileCount += files.size();
+
+        if (!files.empty() && !onFiles(files))
+            return false;
+
+        std::atomic<unsigned int> active(m_ThreadCount);
+        std::vector<std::thread> threads;
+
+        for (unsigned int i = 0; i < m_ThreadCount; i++)
+        {
+            threads.emplace_back([this, i, &active, &cancelled]()
+            {
+                Work(i, cancelled);
+
+                if (--active == 0)
+                    m_Files->Close();
+            });
+        }
+
+        bool completed = true;
+        std::vector<std::string> batch;
+
+        while (m_Files->Pop(batch))
+        {
+            if (cancelled || !onFiles(batch))
+            {
+                m_bStopped = true;
+                m_Files->Abort();
+
+                completed = false;
+                break;
+            }
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        SH_LOG_DEBUG("Walked {} directories with {} threads, {} audio files found, {} other files ignored",
+                     m_DirectoryCount.load(), m_ThreadCount, m_FileCount.load(), m_IgnoredCount.load());
+
+        return completed && !cancelled;
+    }
+
+    void cDirectoryWalker::Work(unsigned int index, const std::atomic<bool>& cancelled)
+    {
+        SH_TRACE_SCOPE("walk.worker");
+
+        std::string directory;
+
+        while (!m_bStopped && !cancelled)
+        {
+            if (Take(index, directory))
+            {
+                ReadDirectory(index, directory);
+
+                if (--m_Pending == 0)
+                    m_Idle.notify_all();
+
+                continue;
+            }
+
+            // Another thread may still be reading a directory that has
+            // subdirectories left to hand out
+            if (m_Pending == 0)
+                break;
+
+            std::unique_lock<std::mutex> lock(m_IdleMutex);
+            m_Idle.wait_for(lock, s_IdleWait);
+        }
+    }
+
+    void cDirectoryWalker::ReadDirectory(unsigned int index, const std::string& path)
+    {
+        const int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+        if (fd < 0)
+        {
+            SH_LOG_DEBUG("Cannot read {}, skipping", path);
+            return;
+        }
+
+        struct stat info;
+
+        if (fstat(fd, &info) != 0 || !Visit(info.st_dev, info.st_ino))
+        {
+            close(fd);
+            return;
+        }
+
+        m_DirectoryCount++;
+
+        std::vector<std::string> files;
+
+        auto flush = [&]()
+        {
+            if (files.empty())
+                return;
+
+            m_FileCount += files.size();
+
+            if (!m_Files->Push(std::move(files)))
+                m_bStopped = true;
+
+            files.clear();
+        };
+
+        alignas(linux_dirent64) char buffer[s_DirentBufferSize];
+
+        while (!m_bStopped)
+        {
+            const long size = syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+
+            if (size <= 0)
+                break;
+
+            for (long offset = 0; offset < size;)
+            {
+                const auto* entry = reinterpret_cast<const linux_dirent64*>(buffer + offset);
+                offset += entry->d_reclen;
+
+                const char* name = entry->d_name;
+
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                    continue;
+
+                unsigned char type = entry->d_type;
+
+                // Only links and file systems that leave d_type empty cost a stat
+                if (type == DT_LNK || type == DT_UNKNOWN)
+                {
+                    if (type == DT_LNK && !m_bFollowSymLinks)
+                    {
+                        m_IgnoredCount++;
+                        continue;
+                    }
+
+                    struct stat entry_info;
+
+                    if (fstatat(fd, name, &entry_info, m_bFollowSymLinks ? 0 : AT_SYMLINK_NOFOLLOW) != 0)
+                        continue;
+
+                    type = S_ISDIR(entry_info.st_mode) ? DT_DIR : S_ISREG(entry_info.st_mode) ? DT_REG : DT_UNKNOWN;
+                }
+
+                if (type == DT_DIR)
+                {
+                    if (m_bRecursive)
+                        Push(index, join(path, name));
+
+                    continue;
+                }
+
+                if (type != DT_REG)
+                    continue;
+
+                if (!is_audio_file(fd, name))
+                {
+                    m_IgnoredCount++;
+                    continue;
+                }
+
+                files.push_back(join(path, name));
+
+                if (files.size() >= s_BatchSize)
+                    flush();
+            }
+        }
+
+        close(fd);
+
+        flush();
+    }
+
+    void cDirectoryWalker::Push(unsigned int index, std::string directory)
+    {
+        m_Pending++;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Queues[index]->Mutex);
+            m_Queues[index]->Directories.push_back(std::move(directory));
+        }
+
+        m_Idle.notify_one();
+    }
+
+    bool cDirectoryWalker::Take(unsigned int index, std::string& directory)
+    {
+        // The own queue is worked depth first, which keeps the tree a thread
+        // is in small, others are robbed from the far end where the larger
+        // subtrees sit
+        {
+            WorkQueue& own = *m_Queues[index];
+            std::lock_guard<std::mutex> lock(own.Mutex);
+
+            if (!own.Directories.empty())
+            {
+                directory = std::move(own.Directories.back());
+                own.Directories.pop_back();
+                return true;
+            }
+        }
+
+        for (unsigned int i = 1; i < m_ThreadCount; i++)
+        {
+            WorkQueue& other = *m_Queues[(index + i) % m_ThreadCount];
+            std::lock_guard<std::mutex> lock(other.Mutex);
+
+            if (!other.Directories.empty())
+            {
+                directory = std::move(other.Directories.front());
+                other.Directories.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool cDirectoryWalker::Visit(dev_t device, ino_t inode)
+    {
+        std::lock_guard<std::mutex> lock(m_VisitedMutex);
+
+        return m_Visited.emplace(device, inode).second;
+    }
+
+}
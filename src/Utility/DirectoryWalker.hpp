@@ -0,0 +1,109 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Utility/BoundedQueue.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace SampleHive {
+
+    // Lists the audio files below a set of roots with a pool of threads. Each
+    // thread reads directories from its own queue and steals from the others
+    // once that runs dry. Entries are typed from getdents64 wherever the file
+    // system fills in d_type, so files are only stat'ed when it doesn't, and
+    // names are matched against the audio extensions before anything is opened.
+    class cDirectoryWalker
+    {
+        public:
+            cDirectoryWalker(bool followSymLinks, bool recursive = true, unsigned int threads = 0);
+            ~cDirectoryWalker() = default;
+
+        public:
+            // -------------------------------------------------------------------
+            cDirectoryWalker(const cDirectoryWalker&) = delete;
+            cDirectoryWalker& operator=(const cDirectoryWalker&) = delete;
+
+        public:
+            // -------------------------------------------------------------------
+            // Roots can be files or directories. Files are handed to onFiles in
+            // batches on the calling thread, the walk stops early when it
+            // returns false or cancelled is set. Returns true if it ran to the end.
+            bool Walk(const std::vector<std::string>& roots,
+                      const std::function<bool(std::vector<std::string>&)>& onFiles,
+                      const std::atomic<bool>& cancelled);
+
+            // Decides by the extension, a file without one is recognised by
+            // the first bytes of its header instead
+            static bool IsAudioFile(const std::string& path);
+
+        private:
+            // -------------------------------------------------------------------
+            struct WorkQueue
+            {
+                std::mutex Mutex;
+                std::deque<std::string> Directories;
+            };
+
+            void Work(unsigned int index, const std::atomic<bool>& cancelled);
+            void ReadDirectory(unsigned int index, const std::string& path);
+
+            void Push(unsigned int index, std::string directory);
+            bool Take(unsigned int index, std::string& directory);
+
+            bool Visit(dev_t device, ino_t inode);
+
+        private:
+            // -------------------------------------------------------------------
+            const bool m_bFollowSymLinks;
+            const bool m_bRecursive;
+            const unsigned int m_ThreadCount;
+
+            std::vector<std::unique_ptr<WorkQueue>> m_Queues;
+
+            // Directories queued or being read, the walk is over at zero
+            std::atomic<size_t> m_Pending;
+
+            std::mutex m_IdleMutex;
+            std::condition_variable m_Idle;
+
+            std::unique_ptr<cBoundedQueue<std::vector<std::string>>> m_Files;
+
+            // Directories already read, by device and inode, symbolic links
+            // can lead back up the tree
+            std::mutex m_VisitedMutex;
+            std::set<std::pair<dev_t, ino_t>> m_Visited;
+
+            std::atomic<size_t> m_DirectoryCount, m_FileCount, m_IgnoredCount;
+            std::atomic<bool> m_bStopped;
+    };
+
+}
@@ -0,0 +1,145 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Import
+
+#include "Utility/DuplicateFinder.hpp"
+#include "Database/Database.hpp"
+#include "Database/QueryProfiler.hpp"
+#include "Utility/AudioAnalysis.hpp"
+#include "Utility/Log.hpp"
+#include "Utility/Trace.hpp"
+
+#include <algorithm>
+#include <exception>
+
+#include <sqlite3.h>
+
+namespace SampleHive {
+
+    cDuplicateFinder::cDuplicateFinder(const std::string& databasePath, unsigned int workers)
+        : m_DatabasePath(databasePath),
+          m_WorkerCount(workers > 0 ? workers : std::max(1u, std::thread::hardware_concurrency())),
+          m_Next(0), m_Total(0), m_Done(0), m_Failed(0), m_bCancelled(false), m_bDone(false)
+    {
+
+    }
+
+    cDuplicateFinder::~cDuplicateFinder()
+    {
+        if (!m_bDone)
+            Cancel();
+
+        Wait();
+    }
+
+    void cDuplicateFinder::Start()
+    {
+        m_Thread = std::thread(&cDuplicateFinder::Run, this);
+    }
+
+    void cDuplicateFinder::Cancel()
+    {
+        m_bCancelled = true;
+    }
+
+    void cDuplicateFinder::Wait()
+    {
+        if (m_Thread.joinable())
+            m_Thread.join();
+    }
+
+    cDuplicateFinder::Progress cDuplicateFinder::GetProgress() const
+    {
+        return { m_Total.load(), m_Done.load(), m_Failed.load() };
+    }
+
+    void cDuplicateFinder::Run()
+    {
+        SH_TRACE_SCOPE("duplicates.find");
+
+        sqlite3* database = nullptr;
+
+        if (sqlite3_open_v2(m_DatabasePath.c_str(), &database, SQLITE_OPEN_READWRITE, NULL) != SQLITE_OK)
+        {
+            SH_LOG_ERROR("Error! Cannot open {} to find duplicates: {}", m_DatabasePath, sqlite3_errmsg(database));
+
+            sqlite3_close(database);
+            m_bDone = true;
+            return;
+        }
+
+        // The UI thread still reads and writes through the main connection
+        sqlite3_busy_timeout(database, 5000);
+
+        cQueryProfiler::Get().Attach(database);
+
+        try
+        {
+            m_Samples = cDatabase::GetSamplesWithoutFingerprint(database);
+            m_Fingerprints.assign(m_Samples.size(), 0);
+            m_Total = m_Samples.size();
+
+            std::vector<std::thread> workers;
+
+            for (unsigned int i = 0; i < std::min<size_t>(m_WorkerCount, m_Samples.size()); i++)
+                workers.emplace_back(&cDuplicateFinder::Fingerprint, this);
+
+            for (auto& worker : workers)
+                worker.join();
+
+            std::vector<std::pair<int64_t, uint64_t>> fingerprints;
+            fingerprints.reserve(m_Samples.size());
+
+            for (size_t i = 0; i < m_Samples.size(); i++)
+            {
+                if (m_Fingerprints[i] != 0)
+                    fingerprints.emplace_back(m_Samples[i].first, m_Fingerprints[i]);
+            }
+
+            cDatabase::UpdateFingerprints(database, fingerprints);
+
+            SH_LOG_INFO("Fingerprinted {} of {} samples, {} failed", fingerprints.size(), m_Samples.size(),
+                        m_Failed.load());
+        }
+        catch (const std::exception& e)
+        {
+            SH_LOG_ERROR("Error! Cannot store sample fingerprints: {}", e.what());
+        }
+
+        sqlite3_close(database);
+
+        m_bDone = true;
+    }
+
+    void cDuplicateFinder::Fingerprint()
+    {
+        size_t index;
+
+        while (!m_bCancelled && (index = m_Next++) < m_Samples.size())
+        {
+            if (!cAudioAnalyser::Fingerprint(m_Samples[index].second, m_Fingerprints[index]))
+                m_Failed++;
+
+            m_Done++;
+        }
+    }
+
+}
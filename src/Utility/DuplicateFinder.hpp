@@ -0,0 +1,88 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace SampleHive {
+
+    // Fingerprints the library samples that don't have one yet, on a pool
+    // of workers, and stores the results in one transaction at the end.
+    // Afterwards cDatabase::GetDuplicateGroups() sees the whole library.
+    class cDuplicateFinder
+    {
+        public:
+            cDuplicateFinder(const std::string& databasePath, unsigned int workers = 0);
+            ~cDuplicateFinder();
+
+        public:
+            // -------------------------------------------------------------------
+            cDuplicateFinder(const cDuplicateFinder&) = delete;
+            cDuplicateFinder& operator=(const cDuplicateFinder&) = delete;
+
+        public:
+            // -------------------------------------------------------------------
+            struct Progress
+            {
+                size_t Total;
+                size_t Done;
+                size_t Failed;
+            };
+
+        public:
+            // -------------------------------------------------------------------
+            void Start();
+
+            // Whatever was fingerprinted so far is still stored
+            void Cancel();
+            void Wait();
+
+            bool IsDone() const { return m_bDone.load(); }
+            Progress GetProgress() const;
+
+        private:
+            // -------------------------------------------------------------------
+            void Run();
+            void Fingerprint();
+
+        private:
+            // -------------------------------------------------------------------
+            const std::string m_DatabasePath;
+            const unsigned int m_WorkerCount;
+
+            std::thread m_Thread;
+
+            // Workers claim samples by index and write only their own slots
+            std::vector<std::pair<int64_t, std::string>> m_Samples;
+            std::vector<uint64_t> m_Fingerprints;
+            std::atomic<size_t> m_Next;
+
+            // -------------------------------------------------------------------
+            std::atomic<size_t> m_Total, m_Done, m_Failed;
+            std::atomic<bool> m_bCancelled, m_bDone;
+    };
+
+}
@@ -0,0 +1,148 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Import
+
+#include "Utility/DuplicateJob.hpp"
+#include "Database/Database.hpp"
+#include "Utility/Log.hpp"
+#include "Utility/Signal.hpp"
+
+#include <wx/intl.h>
+#include <wx/string.h>
+
+namespace SampleHive {
+
+    void cDuplicateJob::Start(wxWindow* parent, Finished finished)
+    {
+        if (m_pFinder)
+            return;
+
+        m_pParent = parent;
+        m_Finished = std::move(finished);
+        m_bCancelling = false;
+
+        if (!m_pTimer)
+            m_pTimer = new cUpdateTimer(*this);
+
+        // Only samples imported before fingerprints were stored need decoding
+        m_pFinder.reset(new cDuplicateFinder(cDatabase::Get().GetPath()));
+        m_pFinder->Start();
+
+        m_pTimer->Start(s_UpdateInterval);
+
+        SampleHive::cSignal::SendSetStatusBarStatus(_("Finding duplicates.."), 0, *m_pParent);
+    }
+
+    void cDuplicateJob::Cancel()
+    {
+        if (!m_pFinder)
+            return;
+
+        m_pFinder->Cancel();
+        m_bCancelling = true;
+
+        SampleHive::cSignal::SendSetStatusBarStatus(_("Cancelling finding duplicates.."), 0, *m_pParent);
+    }
+
+    void cDuplicateJob::CancelAndWait()
+    {
+        if (!m_pFinder)
+            return;
+
+        Cancel();
+        Finish();
+    }
+
+    void cDuplicateJob::Close()
+    {
+        m_Finished = nullptr;
+
+        // The frame may already be going away, the fingerprints stored so
+        // far are kept
+        if (m_pFinder)
+        {
+            m_pFinder->Cancel();
+            m_pFinder->Wait();
+            m_pFinder.reset();
+        }
+
+        delete m_pTimer;
+        m_pTimer = nullptr;
+    }
+
+    void cDuplicateJob::Update()
+    {
+        if (!m_pFinder)
+        {
+            m_pTimer->Stop();
+            return;
+        }
+
+        if (m_pFinder->IsDone())
+        {
+            Finish();
+            return;
+        }
+
+        if (m_bCancelling)
+            return;
+
+        const auto progress = m_pFinder->GetProgress();
+
+        SampleHive::cSignal::SendSetStatusBarStatus(wxString::Format(_("Fingerprinting %lu of %lu samples"),
+                                                                     static_cast<unsigned long>(progress.Done),
+                                                                     static_cast<unsigned long>(progress.Total)),
+                                                    0, *m_pParent);
+    }
+
+    void cDuplicateJob::Finish()
+    {
+        m_pTimer->Stop();
+        m_pFinder->Wait();
+
+        const auto progress = m_pFinder->GetProgress();
+        const bool cancelled = m_bCancelling;
+
+        m_pFinder.reset();
+        m_bCancelling = false;
+
+        if (cancelled)
+            SampleHive::cSignal::SendSetStatusBarStatus(_("Finding duplicates cancelled"), 0, *m_pParent);
+        else
+            SampleHive::cSignal::SendSetStatusBarStatus(wxString::Format(_("Fingerprinted %lu samples, %lu failed"),
+                                                                         static_cast<unsigned long>(progress.Done - progress.Failed),
+                                                                         static_cast<unsigned long>(progress.Failed)),
+                                                        0, *m_pParent);
+
+        // May open a modal dialog, which runs the event loop again
+        Finished finished = std::move(m_Finished);
+        m_Finished = nullptr;
+
+        if (finished)
+            finished(cancelled);
+    }
+
+    cDuplicateJob::~cDuplicateJob()
+    {
+        // Runs after wx is torn down, Close has been called by then
+    }
+
+}
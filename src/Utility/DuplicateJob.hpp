@@ -0,0 +1,112 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Utility/DuplicateFinder.hpp"
+
+#include <functional>
+#include <memory>
+
+#include <wx/timer.h>
+#include <wx/window.h>
+
+namespace SampleHive {
+
+    // Runs the find duplicates job in the background like cImportJobs runs
+    // imports. Every s_UpdateInterval the progress goes to the first
+    // statusbar section, the library stays usable meanwhile. UI thread only.
+    class cDuplicateJob
+    {
+        private:
+            cDuplicateJob() = default;
+
+        public:
+            ~cDuplicateJob();
+
+        public:
+            // -------------------------------------------------------------------
+            cDuplicateJob(const cDuplicateJob&) = delete;
+            cDuplicateJob& operator=(const cDuplicateJob&) = delete;
+
+        public:
+            // -------------------------------------------------------------------
+            static cDuplicateJob& Get()
+            {
+                static cDuplicateJob s_DuplicateJob;
+                return s_DuplicateJob;
+            }
+
+        public:
+            // -------------------------------------------------------------------
+            // Called on the UI thread once the job is over and the fingerprints
+            // it made are stored
+            using Finished = std::function<void(bool cancelled)>;
+
+            // Does nothing while a job is running
+            void Start(wxWindow* parent, Finished finished);
+
+            // Returns right away, the job is finished from the timer once
+            // its threads are out
+            void Cancel();
+
+            // Cancel and return once the job has let go of the database, for
+            // when the database is about to go away
+            void CancelAndWait();
+
+            bool IsBusy() const { return m_pFinder != nullptr; }
+
+            // Cancel and let go of the timer while wx and the database are still up
+            void Close();
+
+        private:
+            // -------------------------------------------------------------------
+            void Update();
+            void Finish();
+
+        private:
+            // -------------------------------------------------------------------
+            class cUpdateTimer : public wxTimer
+            {
+                public:
+                    cUpdateTimer(cDuplicateJob& job) : m_Job(job) {}
+
+                public:
+                    void Notify() override { m_Job.Update(); }
+
+                private:
+                    cDuplicateJob& m_Job;
+            };
+
+        private:
+            // -------------------------------------------------------------------
+            static const int s_UpdateInterval = 250;
+
+            std::unique_ptr<cDuplicateFinder> m_pFinder;
+
+            wxWindow* m_pParent = nullptr;
+            Finished m_Finished;
+            bool m_bCancelling = false;
+
+            // Created with the first job, wx is not up when the job is
+            cUpdateTimer* m_pTimer = nullptr;
+    };
+
+}
@@ -116,4 +116,30 @@ namespace SampleHive
     }
 
     wxDEFINE_EVENT(SH_EVT_UPDATE_WAVEFORM, cWaveformUpdateEvent);
+
+    cSearchResultsEvent::cSearchResultsEvent(wxEventType eventType, int winId)
+        : wxCommandEvent(eventType, winId)
+    {
+
+    }
+
+    cSearchResultsEvent::~cSearchResultsEvent()
+    {
+
+    }
+
+    wxDEFINE_EVENT(SH_EVT_SEARCH_RESULTS, cSearchResultsEvent);
+
+    cWaveformPeaksEvent::cWaveformPeaksEvent(wxEventType eventType, int winId)
+        : wxCommandEvent(eventType, winId)
+    {
+
+    }
+
+    cWaveformPeaksEvent::~cWaveformPeaksEvent()
+    {
+
+    }
+
+    wxDEFINE_EVENT(SH_EVT_WAVEFORM_PEAKS, cWaveformPeaksEvent);
 }
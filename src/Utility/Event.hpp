@@ -20,12 +20,18 @@
 
 #pragma once
 
+#include "Utility/Sample.hpp"
+
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include <wx/event.h>
 
 namespace SampleHive
 {
+    class cPeakPyramid;
+
     class cLoopPointsEvent : public wxCommandEvent
     {
         public:
@@ -145,8 +151,13 @@ namespace SampleHive
             void SetSelection(const wxString& selection) { m_Selection = selection; }
             void SetAutoplayValue(bool autoplay) { m_bCheckAutoplay = autoplay; }
 
+            // The file behind the row, the text shown is not unique
+            wxString GetPath() const { return m_Path; }
+            void SetPath(const wxString& path) { m_Path = path; }
+
         private:
             wxString m_Selection;
+            wxString m_Path;
             bool m_bCheckAutoplay;
     };
 
@@ -164,4 +175,63 @@ namespace SampleHive
 
     wxDECLARE_EVENT(SH_EVT_UPDATE_WAVEFORM, cWaveformUpdateEvent);
 
+    class cSearchResultsEvent : public wxCommandEvent
+    {
+        public:
+            cSearchResultsEvent(wxEventType eventType, int winId);
+            ~cSearchResultsEvent();
+
+        public:
+            virtual wxEvent* Clone() const { return new cSearchResultsEvent(*this); }
+
+        public:
+            const std::vector<Sample>& GetResults() const { return m_Results; }
+            void SetResults(std::vector<Sample>&& results) { m_Results = std::move(results); }
+
+            unsigned long GetGeneration() const { return m_Generation; }
+            void SetGeneration(unsigned long generation) { m_Generation = generation; }
+
+            bool IsLastBatch() const { return m_bLastBatch; }
+            void SetLastBatch(bool last) { m_bLastBatch = last; }
+
+        private:
+            std::vector<Sample> m_Results;
+            unsigned long m_Generation = 0;
+            bool m_bLastBatch = false;
+    };
+
+    wxDECLARE_EVENT(SH_EVT_SEARCH_RESULTS, cSearchResultsEvent);
+
+    class cWaveformPeaksEvent : public wxCommandEvent
+    {
+        public:
+            cWaveformPeaksEvent(wxEventType eventType, int winId);
+            ~cWaveformPeaksEvent();
+
+        public:
+            virtual wxEvent* Clone() const { return new cWaveformPeaksEvent(*this); }
+
+        public:
+            const std::shared_ptr<const cPeakPyramid>& GetPeaks() const { return m_pPeaks; }
+            void SetPeaks(std::shared_ptr<const cPeakPyramid> peaks) { m_pPeaks = std::move(peaks); }
+
+            unsigned long GetGeneration() const { return m_Generation; }
+            void SetGeneration(unsigned long generation) { m_Generation = generation; }
+
+            // A rough outline to show until the decode catches up
+            bool IsSketch() const { return m_bSketch; }
+            void SetSketch(bool sketch) { m_bSketch = sketch; }
+
+            bool IsComplete() const { return m_bComplete; }
+            void SetComplete(bool complete) { m_bComplete = complete; }
+
+        private:
+            std::shared_ptr<const cPeakPyramid> m_pPeaks;
+            unsigned long m_Generation = 0;
+            bool m_bSketch = false;
+            bool m_bComplete = false;
+    };
+
+    wxDECLARE_EVENT(SH_EVT_WAVEFORM_PEAKS, cWaveformPeaksEvent);
+
 }
@@ -18,6 +18,9 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include "GUI/ListCtrl.hpp"
+#include "Utility/Sample.hpp"
+
 #include "wx/dataview.h"
 #include "wx/string.h"
 #include "wx/treectrl.h"
@@ -25,10 +28,26 @@
 #include "wx/variant.h"
 #include "wx/vector.h"
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace SampleHive {
 
+    // Id of the sample a hive or trash item refers to, wxTreeItemData is also
+    // a wxClientData so the same type works for both trees.
+    class cSampleItemData : public wxTreeItemData
+    {
+        public:
+            cSampleItemData(int64_t id) : m_ID(id) {}
+
+        public:
+            inline int64_t GetID() const { return m_ID; }
+
+        private:
+            int64_t m_ID = -1;
+    };
+
     class cHiveData
     {
         private:
@@ -36,7 +55,7 @@ namespace SampleHive {
 
         public:
             cHiveData(const cHiveData&) = delete;
-            cHiveData& operator=(const cHiveData) = delete;
+            cHiveData& operator=(const cHiveData&) = delete;
 
         public:
             static cHiveData& Get()
@@ -48,7 +67,7 @@ namespace SampleHive {
         public:
             // ===============================================================
             // HivesPanel functions
-            void InitHiveData(wxDataViewListCtrl& listCtrl, wxDataViewTreeCtrl& hives, wxDataViewItem favoriteHive,
+            void InitHiveData(cListCtrl& listCtrl, wxDataViewTreeCtrl& hives, wxDataViewItem favoriteHive,
                               wxTreeCtrl& trash, wxTreeItemId trashRoot)
             {
                 m_pListCtrl = &listCtrl;
@@ -77,27 +96,92 @@ namespace SampleHive {
             inline bool IsHiveItemContainer(wxDataViewItem& hiveItem) { return m_pHives->IsContainer(hiveItem); }
             inline int GetHiveChildCount(wxDataViewItem& root) { return m_pHives->GetChildCount(root); }
             inline wxDataViewItem GetHiveNthChild(wxDataViewItem& root, int pos) { return m_pHives->GetNthChild(root, pos); }
-            inline void HiveAppendItem(wxDataViewItem& hiveItem, wxString name) { m_pHives->AppendItem(hiveItem, name); }
+            inline void HiveAppendItem(wxDataViewItem& hiveItem, wxString name, int64_t id)
+                                     { m_pHives->AppendItem(hiveItem, name, -1, new cSampleItemData(id)); }
             inline void HiveDeleteItem(wxDataViewItem& hiveItem) { m_pHives->DeleteItem(hiveItem); }
 
+            int64_t GetHiveItemSampleID(const wxDataViewItem& hiveItem)
+            {
+                cSampleItemData* data = static_cast<cSampleItemData*>(m_pHives->GetItemData(hiveItem));
+
+                return data ? data->GetID() : -1;
+            }
+
+            // Remove the hive item referring to the sample id, if any
+            void HiveDeleteSampleItem(int64_t id)
+            {
+                wxDataViewItem root = wxDataViewItem(wxNullPtr);
+
+                for (int i = 0; i < m_pHives->GetChildCount(root); i++)
+                {
+                    wxDataViewItem container = m_pHives->GetNthChild(root, i);
+
+                    for (int j = 0; j < m_pHives->GetChildCount(container); j++)
+                    {
+                        wxDataViewItem child = m_pHives->GetNthChild(container, j);
+
+                        if (GetHiveItemSampleID(child) == id)
+                        {
+                            m_pHives->DeleteItem(child);
+                            return;
+                        }
+                    }
+                }
+            }
+
             // ===============================================================
             // TrashPanel functions
             inline wxTreeCtrl& GetTrashObj() { return *m_pTrash; }
             inline wxTreeItemId& GetTrashRoot() { return m_TrashRoot; }
-            inline void TrashAppendItem(const wxTreeItemId& parent, const wxString& text) { m_pTrash->AppendItem(parent, text); }
+            inline void TrashAppendItem(const wxTreeItemId& parent, const wxString& text, int64_t id)
+                                      { m_pTrash->AppendItem(parent, text, -1, -1, new cSampleItemData(id)); }
+
+            int64_t GetTrashItemSampleID(const wxTreeItemId& trashItem)
+            {
+                cSampleItemData* data = static_cast<cSampleItemData*>(m_pTrash->GetItemData(trashItem));
+
+                return data ? data->GetID() : -1;
+            }
+
+            // Remove the trash item referring to the sample id, if any
+            void TrashDeleteSampleItem(int64_t id)
+            {
+                wxTreeItemIdValue cookie;
+
+                for (wxTreeItemId child = m_pTrash->GetFirstChild(m_TrashRoot, cookie); child.IsOk();
+                     child = m_pTrash->GetNextChild(m_TrashRoot, cookie))
+                {
+                    if (GetTrashItemSampleID(child) == id)
+                    {
+                        m_pTrash->Delete(child);
+                        return;
+                    }
+                }
+            }
 
             // ===============================================================
             // ListCtrl functions
-            inline wxDataViewListCtrl& GetListCtrlObj() { return *m_pListCtrl; }
+            inline cListCtrl& GetListCtrlObj() { return *m_pListCtrl; }
             inline int GetListCtrlSelections(wxDataViewItemArray& items) { return m_pListCtrl->GetSelections(items); }
             inline int GetListCtrlRowFromItem(wxDataViewItemArray& items, int index) { return m_pListCtrl->ItemToRow(items[index]); }
+            inline std::vector<int> GetListCtrlSelectedRows() { return m_pListCtrl->GetSelectedRows(); }
             inline int GetListCtrlSelectedRow() { return m_pListCtrl->GetSelectedRow(); }
             inline wxDataViewItem GetListCtrlItemFromRow(int row) { return m_pListCtrl->RowToItem(row); }
             inline wxString GetListCtrlTextValue(unsigned int row, unsigned int col) { return m_pListCtrl->GetTextValue(row, col); }
             inline int GetListCtrlItemCount() { return m_pListCtrl->GetItemCount(); }
-            inline void ListCtrlAppendItem(const wxVector<wxVariant>& values) { m_pListCtrl->AppendItem(values); }
-            inline void ListCtrlSetVariant(const wxVariant& variant, unsigned int row, unsigned int col)
-                                     { m_pListCtrl->SetValue(variant, row, col); }
+            inline void ListCtrlAppendSample(const Sample& sample) { m_pListCtrl->GetSampleModel()->AppendSample(sample); }
+            inline void ListCtrlAppendSamples(const std::vector<Sample>& samples)
+                                     { m_pListCtrl->GetSampleModel()->AppendSamples(samples); }
+            inline void ListCtrlUpdateSamples(const std::vector<Sample>& samples)
+                                     { m_pListCtrl->GetSampleModel()->UpdateSamples(samples); }
+            inline int64_t GetListCtrlSampleID(unsigned int row) { return m_pListCtrl->GetSampleModel()->GetSampleID(row); }
+            inline int GetListCtrlSampleLength(unsigned int row) { return m_pListCtrl->GetSampleModel()->GetLength(row); }
+            inline wxString GetListCtrlSamplePath(unsigned int row) { return m_pListCtrl->GetSampleModel()->GetPath(row); }
+
+            // Row showing the sample id, or wxNOT_FOUND
+            inline int GetListCtrlRowFromSampleID(int64_t id) { return m_pListCtrl->GetSampleModel()->GetRowFromSampleID(id); }
+            inline void ListCtrlSetFavorite(unsigned int row, bool favorite)
+                                     { m_pListCtrl->GetSampleModel()->SetFavorite(row, favorite); }
             inline void ListCtrlUnselectAllItems() { m_pListCtrl->UnselectAll(); }
             inline void ListCtrlSelectRow(int row) { m_pListCtrl->SelectRow(row); }
             inline void ListCtrlEnsureVisible(const wxDataViewItem& item) { m_pListCtrl->EnsureVisible(item); }
@@ -105,7 +189,7 @@ namespace SampleHive {
             inline void ListCtrlDeleteAllItems() { m_pListCtrl->DeleteAllItems(); }
 
         private:
-            wxDataViewListCtrl* m_pListCtrl = nullptr;
+            cListCtrl* m_pListCtrl = nullptr;
             wxDataViewItem m_FavoriteHive;
             wxDataViewTreeCtrl* m_pHives = nullptr;
             wxTreeCtrl* m_pTrash = nullptr;
@@ -0,0 +1,254 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Import
+
+#include "Utility/ImportJobs.hpp"
+#include "Database/Database.hpp"
+#include "Utility/HiveData.hpp"
+#include "Utility/Log.hpp"
+#include "Utility/Serialize.hpp"
+#include "Utility/Signal.hpp"
+#include "Utility/Trace.hpp"
+
+#include <wx/intl.h>
+#include <wx/string.h>
+
+namespace SampleHive {
+
+    void cImportJobs::Add(const std::vector<std::string>& paths, bool incremental, wxWindow* parent)
+    {
+        if (paths.empty())
+            return;
+
+        m_Queued.push_back({ paths, incremental, parent });
+
+        if (!m_pTimer)
+            m_pTimer = new cUpdateTimer(*this);
+
+        if (!m_pPipeline)
+            StartNext();
+
+        NotifyStatus();
+    }
+
+    void cImportJobs::Pause()
+    {
+        m_bPaused = true;
+
+        if (m_pPipeline)
+            m_pPipeline->Pause();
+
+        NotifyStatus();
+    }
+
+    void cImportJobs::Resume()
+    {
+        m_bPaused = false;
+
+        if (m_pPipeline)
+            m_pPipeline->Resume();
+
+        NotifyStatus();
+    }
+
+    void cImportJobs::Cancel()
+    {
+        m_Queued.clear();
+
+        // The threads stop at the next file, joining them here would hold
+        // the UI for as long as that file takes
+        if (m_pPipeline)
+        {
+            m_pPipeline->Cancel();
+            m_bCancelling = true;
+        }
+
+        // The next import should not start out held
+        m_bPaused = false;
+
+        NotifyStatus();
+    }
+
+    void cImportJobs::CancelAndWait()
+    {
+        Cancel();
+
+        if (m_pPipeline)
+            Finish();
+
+        if (m_pTimer)
+            m_pTimer->Stop();
+
+        NotifyStatus();
+    }
+
+    cImportJobs::Status cImportJobs::GetStatus() const
+    {
+        Status status = { m_pPipeline != nullptr, m_bPaused, m_bCancelling, m_Queued.size(), {} };
+
+        if (m_pPipeline)
+            status.Progress = m_pPipeline->GetProgress();
+
+        return status;
+    }
+
+    void cImportJobs::SetStatusHandler(std::function<void(const Status&)> handler)
+    {
+        m_StatusHandler = std::move(handler);
+    }
+
+    void cImportJobs::Close()
+    {
+        m_StatusHandler = nullptr;
+        m_Queued.clear();
+
+        // The list and the info bar may already be going away, whatever was
+        // stored is picked up from the database next time
+        if (m_pPipeline)
+        {
+            m_pPipeline->Cancel();
+            m_pPipeline->Wait();
+            m_pPipeline.reset();
+        }
+
+        delete m_pTimer;
+        m_pTimer = nullptr;
+    }
+
+    void cImportJobs::Update()
+    {
+        SH_TRACE_SCOPE("import.update");
+
+        if (!m_pPipeline)
+        {
+            m_pTimer->Stop();
+            return;
+        }
+
+        // Rows show up in one batch per tick, as the writer commits them
+        SampleHive::cHiveData::Get().ListCtrlAppendSamples(m_pPipeline->TakeInsertedSamples());
+        SampleHive::cHiveData::Get().ListCtrlUpdateSamples(m_pPipeline->TakeRefreshedSamples());
+
+        if (m_pPipeline->IsDone())
+        {
+            Finish();
+            StartNext();
+        }
+
+        NotifyStatus();
+    }
+
+    void cImportJobs::StartNext()
+    {
+        if (m_Queued.empty())
+        {
+            m_pTimer->Stop();
+            return;
+        }
+
+        m_Current = std::move(m_Queued.front());
+        m_Queued.pop_front();
+
+        SampleHive::cSerializer serializer;
+
+        const bool demo_mode = serializer.DeserializeDemoMode();
+
+        m_pPipeline.reset(new cImportPipeline(cDatabase::Get().GetPath()));
+
+        if (m_bPaused)
+            m_pPipeline->Pause();
+
+        m_pPipeline->Start(m_Current.Paths, !demo_mode, m_Current.bIncremental && !demo_mode,
+                           serializer.DeserializeFollowSymLink());
+
+        m_pTimer->Start(s_UpdateInterval);
+
+        SH_LOG_INFO("Importing {} paths in the background, {} more imports queued",
+                    m_Current.Paths.size(), m_Queued.size());
+    }
+
+    void cImportJobs::Finish()
+    {
+        m_pPipeline->Wait();
+
+        SampleHive::cHiveData::Get().ListCtrlAppendSamples(m_pPipeline->TakeInsertedSamples());
+        SampleHive::cHiveData::Get().ListCtrlUpdateSamples(m_pPipeline->TakeRefreshedSamples());
+
+        // Files deleted from disk since the last scan leave the library too
+        for (const auto& path : m_pPipeline->TakeRemovedPaths())
+        {
+            const int64_t id = cDatabase::Get().GetSampleIDByPath(path);
+
+            if (id == -1)
+                continue;
+
+            cDatabase::Get().RemoveSampleFromDatabase(id);
+
+            const int row = SampleHive::cHiveData::Get().GetListCtrlRowFromSampleID(id);
+
+            if (row != wxNOT_FOUND)
+                SampleHive::cHiveData::Get().ListCtrlDeleteItem(row);
+
+            SampleHive::cHiveData::Get().HiveDeleteSampleItem(id);
+            SampleHive::cHiveData::Get().TrashDeleteSampleItem(id);
+
+            SH_LOG_INFO("Removed {} from the library, it is gone from disk", path);
+        }
+
+        const auto progress = m_pPipeline->GetProgress();
+        const bool cancelled = m_bCancelling;
+
+        m_pPipeline.reset();
+        m_bCancelling = false;
+
+        SH_LOG_INFO("Imported {} samples, {} already in the library, {} updated, {} failed{}",
+                    progress.Inserted, progress.Skipped, progress.Refreshed, progress.Failed,
+                    cancelled ? ", cancelled" : "");
+
+        if (!m_Current.pParent)
+            return;
+
+        const wxString status = cancelled ? _("Import cancelled, imported %lu samples") : _("Imported %lu samples");
+
+        SampleHive::cSignal::SendSetStatusBarStatus(wxString::Format(status, static_cast<unsigned long>(progress.Inserted)),
+                                                    0, *m_Current.pParent);
+
+        if (progress.Failed > 0)
+        {
+            wxString msg = wxString::Format(_("Error! Could not add %lu files, Invalid file type."),
+                                            static_cast<unsigned long>(progress.Failed));
+
+            SampleHive::cSignal::SendInfoBarMessage(msg, wxICON_ERROR, *m_Current.pParent);
+        }
+    }
+
+    void cImportJobs::NotifyStatus()
+    {
+        if (m_StatusHandler)
+            m_StatusHandler(GetStatus());
+    }
+
+    cImportJobs::~cImportJobs()
+    {
+        // Runs after wx is torn down, Close has been called by then
+    }
+
+}
@@ -0,0 +1,147 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Utility/ImportPipeline.hpp"
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <wx/timer.h>
+#include <wx/window.h>
+
+namespace SampleHive {
+
+    // Runs imports in the background, one at a time in the order they were
+    // asked for. Every s_UpdateInterval the rows written since the last tick
+    // are added to the list in one go and the status handler is told how far
+    // the import got, so the library can be browsed and played while a large
+    // pack comes in. UI thread only.
+    class cImportJobs
+    {
+        private:
+            cImportJobs() = default;
+
+        public:
+            ~cImportJobs();
+
+        public:
+            // -------------------------------------------------------------------
+            cImportJobs(const cImportJobs&) = delete;
+            cImportJobs& operator=(const cImportJobs&) = delete;
+
+        public:
+            // -------------------------------------------------------------------
+            static cImportJobs& Get()
+            {
+                static cImportJobs s_ImportJobs;
+                return s_ImportJobs;
+            }
+
+        public:
+            // -------------------------------------------------------------------
+            struct Status
+            {
+                bool bActive;
+                bool bPaused;
+                bool bCancelling;
+                size_t Queued;
+                cImportPipeline::Progress Progress;
+            };
+
+        public:
+            // -------------------------------------------------------------------
+            // Messages about the job go to the info bar through parent
+            void Add(const std::vector<std::string>& paths, bool incremental, wxWindow* parent);
+
+            // Pausing holds the running job and any job started after it
+            void Pause();
+            void Resume();
+            bool IsPaused() const { return m_bPaused; }
+
+            // Stop the running job and drop the queued ones, what it stored
+            // stays. Returns right away, the job is finished from the timer
+            // once its threads are out.
+            void Cancel();
+
+            // Cancel and return once the job has let go of the database, for
+            // when the database is about to go away
+            void CancelAndWait();
+
+            bool IsBusy() const { return m_pPipeline != nullptr; }
+            Status GetStatus() const;
+
+            void SetStatusHandler(std::function<void(const Status&)> handler);
+
+            // Cancel and let go of the timer while wx and the database are still up
+            void Close();
+
+        private:
+            // -------------------------------------------------------------------
+            void Update();
+            void StartNext();
+            void Finish();
+
+            void NotifyStatus();
+
+        private:
+            // -------------------------------------------------------------------
+            class cUpdateTimer : public wxTimer
+            {
+                public:
+                    cUpdateTimer(cImportJobs& jobs) : m_Jobs(jobs) {}
+
+                public:
+                    void Notify() override { m_Jobs.Update(); }
+
+                private:
+                    cImportJobs& m_Jobs;
+            };
+
+            struct Job
+            {
+                std::vector<std::string> Paths;
+                bool bIncremental;
+                wxWindow* pParent;
+            };
+
+        private:
+            // -------------------------------------------------------------------
+            static const int s_UpdateInterval = 250;
+
+            std::deque<Job> m_Queued;
+
+            Job m_Current = { {}, false, nullptr };
+            std::unique_ptr<cImportPipeline> m_pPipeline;
+
+            bool m_bPaused = false;
+            bool m_bCancelling = false;
+
+            // Created with the first job, wx is not up when the jobs are
+            cUpdateTimer* m_pTimer = nullptr;
+
+            std::function<void(const Status&)> m_StatusHandler;
+    };
+
+}
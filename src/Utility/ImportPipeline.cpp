@@ -0,0 +1,522 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Import
+
+#include "Utility/ImportPipeline.hpp"
+#include "Database/Database.hpp"
+#include "Database/QueryProfiler.hpp"
+#include "Utility/AudioAnalysis.hpp"
+#include "Utility/DirectoryWalker.hpp"
+#include "Utility/Log.hpp"
+#include "Utility/MetadataCache.hpp"
+#include "Utility/PeakPyramid.hpp"
+#include "Utility/Tags.hpp"
+#include "Utility/Trace.hpp"
+#include "Utility/Utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iterator>
+
+#include <sys/stat.h>
+
+#include <sqlite3.h>
+
+namespace {
+
+    // Paths are checked against the library this many at a time
+    const size_t s_WalkBatchSize = 256;
+
+    // Rows are written in one transaction once this many are ready, or when
+    // the oldest pending row has waited s_WriteInterval
+    const size_t s_WriteBatchSize = 256;
+    const std::chrono::milliseconds s_WriteInterval(250);
+
+    const size_t s_PathQueueSize = 1024;
+    const size_t s_SampleQueueSize = 512;
+
+}
+
+namespace SampleHive {
+
+    cImportPipeline::cImportPipeline(const std::string& databasePath, unsigned int workers)
+        : m_DatabasePath(databasePath),
+          m_WorkerCount(workers > 0 ? workers : std::max(1u, std::thread::hardware_concurrency())),
+          m_Paths(s_PathQueueSize), m_Samples(s_SampleQueueSize),
+          m_Found(0), m_Skipped(0), m_Analysed(0), m_Failed(0), m_InsertedCount(0), m_Refreshed(0),
+          m_ActiveWorkers(0), m_bWalking(false), m_bCancelled(false), m_bDone(false), m_bPaused(false)
+    {
+
+    }
+
+    cImportPipeline::~cImportPipeline()
+    {
+        if (!m_bDone)
+            Cancel();
+
+        Wait();
+    }
+
+    void cImportPipeline::Start(const std::vector<std::string>& paths, bool skipKnownPaths, bool incremental,
+                                bool followSymLinks)
+    {
+        m_bWalking = true;
+        m_bIncremental = incremental;
+        m_bFollowSymLinks = followSymLinks;
+        m_ActiveWorkers = m_WorkerCount;
+
+        m_Threads.emplace_back(&cImportPipeline::Walk, this, paths, skipKnownPaths || incremental, incremental);
+
+        for (unsigned int i = 0; i < m_WorkerCount; i++)
+            m_Threads.emplace_back(&cImportPipeline::Analyse, this);
+
+        m_Threads.emplace_back(&cImportPipeline::Write, this);
+    }
+
+    void cImportPipeline::Cancel()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_PauseMutex);
+            m_bCancelled = true;
+        }
+
+        m_Resumed.notify_all();
+
+        m_Paths.Abort();
+        m_Samples.Abort();
+    }
+
+    void cImportPipeline::Pause()
+    {
+        m_bPaused = true;
+    }
+
+    void cImportPipeline::Resume()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_PauseMutex);
+            m_bPaused = false;
+        }
+
+        m_Resumed.notify_all();
+    }
+
+    bool cImportPipeline::WaitWhilePaused()
+    {
+        if (m_bPaused)
+        {
+            std::unique_lock<std::mutex> lock(m_PauseMutex);
+            m_Resumed.wait(lock, [this] { return !m_bPaused || m_bCancelled; });
+        }
+
+        return !m_bCancelled;
+    }
+
+    void cImportPipeline::Wait()
+    {
+        for (auto& thread : m_Threads)
+        {
+            if (thread.joinable())
+                thread.join();
+        }
+    }
+
+    cImportPipeline::Progress cImportPipeline::GetProgress() const
+    {
+        return { m_Found.load(), m_Skipped.load(), m_Analysed.load(), m_Failed.load(),
+                 m_InsertedCount.load(), m_Refreshed.load(), m_bWalking.load() };
+    }
+
+    std::vector<std::string> cImportPipeline::TakeRemovedPaths()
+    {
+        std::lock_guard<std::mutex> lock(m_ChangesMutex);
+
+        std::vector<std::string> paths;
+        paths.swap(m_Removed);
+
+        return paths;
+    }
+
+    std::vector<Sample> cImportPipeline::TakeInsertedSamples()
+    {
+        std::lock_guard<std::mutex> lock(m_InsertedMutex);
+
+        std::vector<Sample> samples;
+        samples.swap(m_Inserted);
+
+        return samples;
+    }
+
+    std::vector<Sample> cImportPipeline::TakeRefreshedSamples()
+    {
+        std::lock_guard<std::mutex> lock(m_InsertedMutex);
+
+        std::vector<Sample> samples;
+        samples.swap(m_RefreshedSamples);
+
+        return samples;
+    }
+
+    void cImportPipeline::Walk(std::vector<std::string> paths, bool skipKnownPaths, bool incremental)
+    {
+        SH_TRACE_SCOPE("import.walk");
+
+        sqlite3* database = nullptr;
+
+        if (skipKnownPaths &&
+            sqlite3_open_v2(m_DatabasePath.c_str(), &database, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK)
+        {
+            SH_LOG_ERROR("Error! Cannot open {} to check for duplicates: {}", m_DatabasePath,
+                         sqlite3_errmsg(database));
+
+            sqlite3_close(database);
+            database = nullptr;
+        }
+
+        if (database)
+        {
+            sqlite3_busy_timeout(database, 5000);
+            cQueryProfiler::Get().Attach(database);
+        }
+
+        std::vector<std::string> batch;
+        batch.reserve(s_WalkBatchSize);
+
+        auto flush = [&]()
+        {
+            const size_t count = batch.size();
+
+            if (database)
+            {
+                try
+                {
+                    cDatabase::RemoveKnownPaths(database, batch);
+                }
+                catch (const std::exception& e)
+                {
+                    SH_LOG_ERROR("Error! Cannot check duplicates: {}", e.what());
+                }
+            }
+
+            m_Skipped += count - batch.size();
+
+            for (auto& path : batch)
+            {
+                if (!m_Paths.Push(std::move(path)))
+                    return false;
+
+                m_Found++;
+            }
+
+            batch.clear();
+
+            return true;
+        };
+
+        auto add = [&](std::string path)
+        {
+            if (!WaitWhilePaused())
+                return false;
+
+            batch.push_back(std::move(path));
+
+            return batch.size() < s_WalkBatchSize || flush();
+        };
+
+        // Changed files are already in the library, they skip the duplicate
+        // check and are analysed again
+        auto scan = [&](const std::string& path)
+        {
+            cLibraryScanner::Changes changes;
+
+            if (!m_Scanner.Scan(database, path, changes, m_bFollowSymLinks, m_bCancelled))
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock(m_ChangesMutex);
+
+                m_Modified.insert(changes.Modified.begin(), changes.Modified.end());
+                m_Removed.insert(m_Removed.end(), changes.Removed.begin(), changes.Removed.end());
+            }
+
+            for (auto& added : changes.Added)
+            {
+                if (!add(std::move(added)))
+                    return;
+            }
+
+            for (auto& modified : changes.Modified)
+            {
+                cMetadataCache::Get().Invalidate(modified);
+
+                if (m_bCancelled || !m_Paths.Push(std::move(modified)))
+                    return;
+
+                m_Found++;
+            }
+        };
+
+        std::vector<std::string> roots;
+
+        for (const auto& path : paths)
+        {
+            if (m_bCancelled)
+                break;
+
+            struct stat info;
+
+            if (incremental && database && stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode))
+                scan(path);
+            else
+                roots.push_back(path);
+        }
+
+        cDirectoryWalker walker(m_bFollowSymLinks);
+
+        walker.Walk(roots, [&](std::vector<std::string>& files)
+        {
+            for (auto& file : files)
+            {
+                if (!add(std::move(file)))
+                    return false;
+            }
+
+            return true;
+        }, m_bCancelled);
+
+        if (!m_bCancelled)
+            flush();
+
+        sqlite3_close(database);
+
+        m_bWalking = false;
+        m_Paths.Close();
+    }
+
+    void cImportPipeline::Analyse()
+    {
+        std::string path;
+
+        while (WaitWhilePaused() && m_Paths.Pop(path))
+        {
+            Sample sample;
+
+            if (ReadSample(path, sample))
+            {
+                if (!m_Samples.Push(std::move(sample)))
+                    break;
+            }
+            else
+            {
+                SH_LOG_ERROR("Error! Cannot open {}, Invalid file type.", path);
+                m_Failed++;
+            }
+
+            m_Analysed++;
+        }
+
+        // The writer stops once every worker has handed over its last sample
+        if (--m_ActiveWorkers == 0)
+            m_Samples.Close();
+    }
+
+    void cImportPipeline::Write()
+    {
+        sqlite3* database = nullptr;
+        sqlite3_stmt* statement = nullptr;
+
+        if (sqlite3_open_v2(m_DatabasePath.c_str(), &database, SQLITE_OPEN_READWRITE, NULL) != SQLITE_OK ||
+            sqlite3_prepare_v2(database, cDatabase::GetInsertSampleQuery(), -1, &statement, NULL) != SQLITE_OK)
+        {
+            SH_LOG_ERROR("Error! Cannot open {} for importing: {}", m_DatabasePath, sqlite3_errmsg(database));
+
+            sqlite3_close(database);
+
+            // Nothing can be stored, so there is no point analysing further
+            Cancel();
+            m_bDone = true;
+            return;
+        }
+
+        // The UI thread still reads and writes through the main connection
+        sqlite3_busy_timeout(database, 5000);
+        sqlite3_exec(database, "PRAGMA synchronous = NORMAL;", NULL, NULL, NULL);
+
+        cQueryProfiler::Get().Attach(database);
+
+        std::vector<Sample> batch;
+        batch.reserve(s_WriteBatchSize);
+
+        auto first_pending = std::chrono::steady_clock::now();
+        bool write_failed = false;
+
+        auto flush = [&]()
+        {
+            if (batch.empty())
+                return;
+
+            SH_TRACE_SCOPE("import.commit");
+
+            try
+            {
+                std::vector<Sample> modified;
+
+                {
+                    std::lock_guard<std::mutex> lock(m_ChangesMutex);
+
+                    if (!m_Modified.empty())
+                    {
+                        auto changed = std::stable_partition(batch.begin(), batch.end(), [this](const Sample& sample)
+                        {
+                            return m_Modified.count(sample.GetPath()) == 0;
+                        });
+
+                        std::move(changed, batch.end(), std::back_inserter(modified));
+                        batch.erase(changed, batch.end());
+                    }
+                }
+
+                // Files no longer in the library are inserted after all
+                if (!modified.empty())
+                {
+                    std::vector<Sample> updated = cDatabase::RefreshSamples(database, modified);
+                    m_Refreshed += updated.size();
+
+                    {
+                        std::lock_guard<std::mutex> lock(m_InsertedMutex);
+                        std::move(updated.begin(), updated.end(), std::back_inserter(m_RefreshedSamples));
+                    }
+
+                    std::move(modified.begin(), modified.end(), std::back_inserter(batch));
+                }
+
+                cDatabase::InsertSamples(database, statement, batch);
+
+                // Tags read by the workers go out with their rows
+                cMetadataCache::Get().Flush(database);
+            }
+            catch (const std::exception& e)
+            {
+                SH_LOG_ERROR("Error! Cannot insert {} samples: {}", batch.size(), e.what());
+                m_Failed += batch.size();
+                write_failed = true;
+            }
+
+            std::lock_guard<std::mutex> lock(m_InsertedMutex);
+
+            for (auto& sample : batch)
+            {
+                if (sample.GetID() == -1)
+                    continue;
+
+                m_Inserted.push_back(std::move(sample));
+                m_InsertedCount++;
+            }
+
+            batch.clear();
+        };
+
+        Sample sample;
+
+        while (true)
+        {
+            const auto status = m_Samples.PopFor(sample, s_WriteInterval);
+
+            if (status == cBoundedQueue<Sample>::ePop::Closed)
+                break;
+
+            if (status == cBoundedQueue<Sample>::ePop::Item)
+            {
+                if (batch.empty())
+                    first_pending = std::chrono::steady_clock::now();
+
+                batch.push_back(std::move(sample));
+            }
+
+            if (batch.size() >= s_WriteBatchSize ||
+                std::chrono::steady_clock::now() - first_pending >= s_WriteInterval)
+                flush();
+        }
+
+        if (!m_bCancelled)
+            flush();
+
+        // Files that failed to import are still worth remembering
+        cMetadataCache::Get().Flush(database);
+
+        // The next incremental import starts from what was stored now, unless
+        // some of it never made it into the library
+        if (m_bIncremental && !m_bCancelled && !write_failed)
+            m_Scanner.Commit(database);
+
+        sqlite3_finalize(statement);
+        sqlite3_close(database);
+
+        m_bDone = true;
+    }
+
+    bool cImportPipeline::ReadSample(const std::string& path, Sample& sample)
+    {
+        SH_TRACE_SCOPE("import.read");
+
+        // Re-imports of an unchanged file are answered by the METADATA table
+        const auto info = cMetadataCache::Get().GetAudioInfo(path);
+
+        // One decode gives the properties, the tempo and the waveform peaks,
+        // formats libsndfile cannot read fall back to TagLib and aubio
+        AudioAnalysis analysis;
+
+        if (cAudioAnalyser::Analyse(path, analysis))
+        {
+            if (!cPeakPyramid::Build(analysis)->Save(path))
+                SH_LOG_WARN("Cannot store waveform peaks for {}", path);
+        }
+        else if (info.valid)
+        {
+            analysis.Channels = info.channels;
+            analysis.SampleRate = info.sample_rate;
+            analysis.Bitrate = info.bitrate;
+            analysis.Length = info.length;
+            analysis.BPM = cUtils::Get().GetBPM(path);
+        }
+        else
+            return false;
+
+        const wxString filename = wxString(path).AfterLast('/');
+
+        sample.SetPath(path);
+        sample.SetFilename(filename.BeforeLast('.').ToStdString());
+        sample.SetFileExtension(filename.AfterLast('.').ToStdString());
+        sample.SetSamplePack(info.artist.ToStdString());
+        sample.SetChannels(analysis.Channels);
+        sample.SetBPM(static_cast<int>(analysis.BPM));
+        sample.SetLength(analysis.Length);
+        sample.SetSampleRate(analysis.SampleRate);
+        sample.SetBitrate(analysis.Bitrate);
+        sample.SetFingerprint(analysis.Fingerprint);
+
+        SH_LOG_INFO("Adding file: {}, Extension: {}", sample.GetFilename(), sample.GetFileExtension());
+
+        return true;
+    }
+
+}
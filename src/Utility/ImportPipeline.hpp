@@ -0,0 +1,141 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Utility/BoundedQueue.hpp"
+#include "Utility/LibraryScanner.hpp"
+#include "Utility/Sample.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace SampleHive {
+
+    // Imports files and directories in three stages connected by bounded
+    // queues: one thread walks the inputs and drops paths already in the
+    // library, a pool of workers reads tags and detects the tempo, and one
+    // thread writes the results to the database in batches.
+    class cImportPipeline
+    {
+        public:
+            cImportPipeline(const std::string& databasePath, unsigned int workers = 0);
+            ~cImportPipeline();
+
+        public:
+            // -------------------------------------------------------------------
+            cImportPipeline(const cImportPipeline&) = delete;
+            cImportPipeline& operator=(const cImportPipeline&) = delete;
+
+        public:
+            // -------------------------------------------------------------------
+            struct Progress
+            {
+                size_t Found;
+                size_t Skipped;
+                size_t Analysed;
+                size_t Failed;
+                size_t Inserted;
+                size_t Refreshed;
+                bool bWalking;
+            };
+
+        public:
+            // -------------------------------------------------------------------
+            // Paths can be files or directories, directories are walked recursively
+            // and only audio files are picked up. An incremental import only
+            // looks at what changed in the directories since they were last
+            // imported this way.
+            void Start(const std::vector<std::string>& paths, bool skipKnownPaths = true,
+                       bool incremental = false, bool followSymLinks = false);
+            void Cancel();
+            void Wait();
+
+            // Holds the walker and the workers after the file they are on,
+            // what is already analysed is still written
+            void Pause();
+            void Resume();
+            bool IsPaused() const { return m_bPaused.load(); }
+
+            bool IsDone() const { return m_bDone.load(); }
+            Progress GetProgress() const;
+
+            // Samples written since the last call, with their new ids
+            std::vector<Sample> TakeInsertedSamples();
+
+            // Library samples rewritten since the last call because their files changed
+            std::vector<Sample> TakeRefreshedSamples();
+
+            // Library files an incremental import found gone from disk
+            std::vector<std::string> TakeRemovedPaths();
+
+        private:
+            // -------------------------------------------------------------------
+            void Walk(std::vector<std::string> paths, bool skipKnownPaths, bool incremental);
+            void Analyse();
+            void Write();
+
+            bool ReadSample(const std::string& path, Sample& sample);
+
+            // Returns false once the import was cancelled
+            bool WaitWhilePaused();
+
+        private:
+            // -------------------------------------------------------------------
+            const std::string m_DatabasePath;
+            const unsigned int m_WorkerCount;
+
+            cBoundedQueue<std::string> m_Paths;
+            cBoundedQueue<Sample> m_Samples;
+
+            std::vector<std::thread> m_Threads;
+
+            std::mutex m_PauseMutex;
+            std::condition_variable m_Resumed;
+
+            bool m_bFollowSymLinks = false;
+
+            // -------------------------------------------------------------------
+            // Incremental imports, the walker fills these before handing the
+            // paths on and the writer commits the scan once all are stored
+            cLibraryScanner m_Scanner;
+            bool m_bIncremental = false;
+
+            std::mutex m_ChangesMutex;
+            std::unordered_set<std::string> m_Modified;
+            std::vector<std::string> m_Removed;
+
+            // -------------------------------------------------------------------
+            std::mutex m_InsertedMutex;
+            std::vector<Sample> m_Inserted;
+            std::vector<Sample> m_RefreshedSamples;
+
+            // -------------------------------------------------------------------
+            std::atomic<size_t> m_Found, m_Skipped, m_Analysed, m_Failed, m_InsertedCount, m_Refreshed;
+            std::atomic<unsigned int> m_ActiveWorkers;
+            std::atomic<bool> m_bWalking, m_bCancelled, m_bDone, m_bPaused;
+    };
+
+}
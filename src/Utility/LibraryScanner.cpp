@@ -0,0 +1,384 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Import
+
+#include "Utility/LibraryScanner.hpp"
+#include "Utility/DirectoryWalker.hpp"
+#include "Utility/Log.hpp"
+#include "Utility/Trace.hpp"
+
+#include <set>
+#include <unordered_set>
+#include <stdexcept>
+#include <utility>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace {
+
+    int64_t to_nanoseconds(const struct timespec& time)
+    {
+        return static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+    }
+
+    std::string column_text(sqlite3_stmt* statement, int column)
+    {
+        const unsigned char* text = sqlite3_column_text(statement, column);
+
+        return text ? reinterpret_cast<const char*>(text) : std::string();
+    }
+
+    void check(sqlite3* connection, int rc)
+    {
+        if (rc != SQLITE_OK && rc != SQLITE_DONE && rc != SQLITE_ROW)
+            throw std::runtime_error(sqlite3_errmsg(connection));
+    }
+
+    // Everything stored below root sorts between these two, '0' follows '/'
+    std::pair<std::string, std::string> path_range(const std::string& root)
+    {
+        return { root + '/', root + '0' };
+    }
+
+}
+
+namespace SampleHive {
+
+    void cLibraryScanner::Load(sqlite3* connection, const std::string& root,
+                               std::unordered_map<std::string, FileState>& files,
+                               std::unordered_map<std::string, DirectoryState>& directories)
+    {
+        const auto range = path_range(root);
+
+        sqlite3_stmt* statement = nullptr;
+
+        check(connection, sqlite3_prepare_v2(connection, "SELECT PATH, DIRECTORY, SIZE, MTIME, INODE FROM SCAN_FILES "
+                                             "WHERE PATH > ?1 AND PATH < ?2;", -1, &statement, NULL));
+
+        sqlite3_bind_text(statement, 1, range.first.c_str(), range.first.size(), SQLITE_STATIC);
+        sqlite3_bind_text(statement, 2, range.second.c_str(), range.second.size(), SQLITE_STATIC);
+
+        while (sqlite3_step(statement) == SQLITE_ROW)
+            files[column_text(statement, 0)] = { column_text(statement, 1), sqlite3_column_int64(statement, 2),
+                                                 sqlite3_column_int64(statement, 3), sqlite3_column_int64(statement, 4) };
+
+        sqlite3_finalize(statement);
+
+        check(connection, sqlite3_prepare_v2(connection, "SELECT PATH, PARENT, MTIME FROM SCAN_DIRECTORIES "
+                                             "WHERE PATH = ?3 OR (PATH > ?1 AND PATH < ?2);", -1, &statement, NULL));
+
+        sqlite3_bind_text(statement, 1, range.first.c_str(), range.first.size(), SQLITE_STATIC);
+        sqlite3_bind_text(statement, 2, range.second.c_str(), range.second.size(), SQLITE_STATIC);
+        sqlite3_bind_text(statement, 3, root.c_str(), root.size(), SQLITE_STATIC);
+
+        while (sqlite3_step(statement) == SQLITE_ROW)
+            directories[column_text(statement, 0)] = { column_text(statement, 1), sqlite3_column_int64(statement, 2) };
+
+        sqlite3_finalize(statement);
+    }
+
+    bool cLibraryScanner::Scan(sqlite3* connection, const std::string& path, Changes& changes,
+                               bool followSymLinks, const std::atomic<bool>& cancelled)
+    {
+        SH_TRACE_SCOPE("import.scan");
+
+        std::string root = path;
+
+        while (root.size() > 1 && root.back() == '/')
+            root.pop_back();
+
+        struct stat info;
+
+        if (stat(root.c_str(), &info) != 0 || !S_ISDIR(info.st_mode))
+        {
+            SH_LOG_WARN("Cannot scan {}, skipping", root);
+            return false;
+        }
+
+        std::unordered_map<std::string, FileState> stored_files;
+        std::unordered_map<std::string, DirectoryState> stored_directories;
+
+        try
+        {
+            Load(connection, root, stored_files, stored_directories);
+        }
+        catch (const std::exception& e)
+        {
+            SH_LOG_ERROR("Error! Cannot load scan state for {}: {}", root, e.what());
+            return false;
+        }
+
+        // Listings of unchanged directories come from the stored state
+        std::unordered_map<std::string, std::vector<std::string>> stored_listing;
+
+        for (const auto& file : stored_files)
+            stored_listing[file.second.Directory].push_back(file.first);
+
+        for (const auto& directory : stored_directories)
+        {
+            if (directory.first != root)
+                stored_listing[directory.second.Parent].push_back(directory.first);
+        }
+
+        std::unordered_set<std::string> seen_files;
+        std::unordered_set<std::string> seen_directories;
+        std::set<std::pair<dev_t, ino_t>> visited;
+
+        // Whatever cannot be read right now is kept as it was, not reported
+        // as removed
+        auto keep = [&](const std::string& path)
+        {
+            const auto range = path_range(path);
+
+            seen_files.insert(path);
+            seen_directories.insert(path);
+
+            for (const auto& file : stored_files)
+            {
+                if (file.first > range.first && file.first < range.second)
+                    seen_files.insert(file.first);
+            }
+
+            for (const auto& directory : stored_directories)
+            {
+                if (directory.first > range.first && directory.first < range.second)
+                    seen_directories.insert(directory.first);
+            }
+        };
+
+        std::vector<std::pair<std::string, std::string>> pending = { { root, std::string() } };
+
+        while (!pending.empty())
+        {
+            if (cancelled)
+                return false;
+
+            const std::string directory = std::move(pending.back().first);
+            const std::string parent = std::move(pending.back().second);
+            pending.pop_back();
+
+            if (stat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode))
+            {
+                if (stored_directories.count(directory))
+                    keep(directory);
+
+                continue;
+            }
+
+            // Symbolic links can lead back up the tree
+            if (!visited.emplace(info.st_dev, info.st_ino).second)
+                continue;
+
+            seen_directories.insert(directory);
+
+            const int64_t time = to_nanoseconds(info.st_mtim);
+            const auto stored = stored_directories.find(directory);
+
+            std::vector<std::string> entries;
+
+            if (stored != stored_directories.end() && stored->second.Time == time)
+            {
+                entries = stored_listing[directory];
+                changes.SkippedDirectories++;
+            }
+            else
+            {
+                DIR* handle = opendir(directory.c_str());
+
+                if (!handle)
+                {
+                    keep(directory);
+                    continue;
+                }
+
+                while (dirent* entry = readdir(handle))
+                {
+                    const std::string name = entry->d_name;
+
+                    if (name == "." || name == "..")
+                        continue;
+
+                    entries.push_back(directory + '/' + name);
+                }
+
+                closedir(handle);
+
+                m_StoreDirectories.push_back({ directory, { parent, time } });
+            }
+
+            for (auto& entry : entries)
+            {
+                struct stat entry_info;
+
+                const int result = followSymLinks ? stat(entry.c_str(), &entry_info) :
+                                                    lstat(entry.c_str(), &entry_info);
+
+                if (result != 0)
+                {
+                    if (stored_files.count(entry))
+                        seen_files.insert(entry);
+                    else if (stored_directories.count(entry))
+                        keep(entry);
+
+                    continue;
+                }
+
+                if (S_ISDIR(entry_info.st_mode))
+                {
+                    pending.emplace_back(std::move(entry), directory);
+                    continue;
+                }
+
+                if (!S_ISREG(entry_info.st_mode))
+                    continue;
+
+                const auto known = stored_files.find(entry);
+
+                // Only audio files ever make it into the stored state
+                if (known == stored_files.end() && !cDirectoryWalker::IsAudioFile(entry))
+                    continue;
+
+                seen_files.insert(entry);
+
+                FileState state = { directory, static_cast<int64_t>(entry_info.st_size),
+                                    to_nanoseconds(entry_info.st_mtim), static_cast<int64_t>(entry_info.st_ino) };
+
+                if (known == stored_files.end())
+                    changes.Added.push_back(entry);
+                else if (known->second.Size != state.Size || known->second.Time != state.Time ||
+                         known->second.Inode != state.Inode)
+                    changes.Modified.push_back(entry);
+                else
+                {
+                    changes.Unchanged++;
+                    continue;
+                }
+
+                m_StoreFiles.emplace_back(std::move(entry), std::move(state));
+            }
+        }
+
+        for (const auto& file : stored_files)
+        {
+            if (!seen_files.count(file.first))
+            {
+                changes.Removed.push_back(file.first);
+                m_RemoveFiles.push_back(file.first);
+            }
+        }
+
+        for (const auto& directory : stored_directories)
+        {
+            if (!seen_directories.count(directory.first))
+                m_RemoveDirectories.push_back(directory.first);
+        }
+
+        SH_LOG_INFO("Scanned {}: {} added, {} modified, {} removed, {} unchanged, {} directories unchanged",
+                    root, changes.Added.size(), changes.Modified.size(), changes.Removed.size(),
+                    changes.Unchanged, changes.SkippedDirectories);
+
+        return true;
+    }
+
+    void cLibraryScanner::Commit(sqlite3* connection)
+    {
+        sqlite3_stmt* store_file = nullptr;
+        sqlite3_stmt* store_directory = nullptr;
+        sqlite3_stmt* remove_file = nullptr;
+        sqlite3_stmt* remove_directory = nullptr;
+
+        try
+        {
+            check(connection, sqlite3_prepare_v2(connection, "INSERT OR REPLACE INTO SCAN_FILES "
+                                                 "(PATH, DIRECTORY, SIZE, MTIME, INODE) VALUES (?, ?, ?, ?, ?);",
+                                                 -1, &store_file, NULL));
+            check(connection, sqlite3_prepare_v2(connection, "INSERT OR REPLACE INTO SCAN_DIRECTORIES "
+                                                 "(PATH, PARENT, MTIME) VALUES (?, ?, ?);",
+                                                 -1, &store_directory, NULL));
+            check(connection, sqlite3_prepare_v2(connection, "DELETE FROM SCAN_FILES WHERE PATH = ?;",
+                                                 -1, &remove_file, NULL));
+            check(connection, sqlite3_prepare_v2(connection, "DELETE FROM SCAN_DIRECTORIES WHERE PATH = ?;",
+                                                 -1, &remove_directory, NULL));
+
+            check(connection, sqlite3_exec(connection, "BEGIN TRANSACTION", NULL, NULL, NULL));
+
+            for (const auto& file : m_StoreFiles)
+            {
+                sqlite3_bind_text(store_file, 1, file.first.c_str(), file.first.size(), SQLITE_STATIC);
+                sqlite3_bind_text(store_file, 2, file.second.Directory.c_str(), file.second.Directory.size(), SQLITE_STATIC);
+                sqlite3_bind_int64(store_file, 3, file.second.Size);
+                sqlite3_bind_int64(store_file, 4, file.second.Time);
+                sqlite3_bind_int64(store_file, 5, file.second.Inode);
+
+                check(connection, sqlite3_step(store_file));
+                sqlite3_reset(store_file);
+            }
+
+            for (const auto& directory : m_StoreDirectories)
+            {
+                sqlite3_bind_text(store_directory, 1, directory.first.c_str(), directory.first.size(), SQLITE_STATIC);
+                sqlite3_bind_text(store_directory, 2, directory.second.Parent.c_str(),
+                                  directory.second.Parent.size(), SQLITE_STATIC);
+                sqlite3_bind_int64(store_directory, 3, directory.second.Time);
+
+                check(connection, sqlite3_step(store_directory));
+                sqlite3_reset(store_directory);
+            }
+
+            for (const auto& path : m_RemoveFiles)
+            {
+                sqlite3_bind_text(remove_file, 1, path.c_str(), path.size(), SQLITE_STATIC);
+
+                check(connection, sqlite3_step(remove_file));
+                sqlite3_reset(remove_file);
+            }
+
+            for (const auto& path : m_RemoveDirectories)
+            {
+                sqlite3_bind_text(remove_directory, 1, path.c_str(), path.size(), SQLITE_STATIC);
+
+                check(connection, sqlite3_step(remove_directory));
+                sqlite3_reset(remove_directory);
+            }
+
+            check(connection, sqlite3_exec(connection, "END TRANSACTION", NULL, NULL, NULL));
+        }
+        catch (const std::exception& e)
+        {
+            if (!sqlite3_get_autocommit(connection))
+                sqlite3_exec(connection, "ROLLBACK", NULL, NULL, NULL);
+
+            SH_LOG_ERROR("Error! Cannot store scan state: {}", e.what());
+        }
+
+        sqlite3_finalize(store_file);
+        sqlite3_finalize(store_directory);
+        sqlite3_finalize(remove_file);
+        sqlite3_finalize(remove_directory);
+
+        m_StoreFiles.clear();
+        m_StoreDirectories.clear();
+        m_RemoveFiles.clear();
+        m_RemoveDirectories.clear();
+    }
+
+}
@@ -0,0 +1,101 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sqlite3.h>
+
+namespace SampleHive {
+
+    // Compares directory trees against the SCAN_FILES and SCAN_DIRECTORIES
+    // tables and reports only what changed since the last scan. A directory
+    // whose mtime is unchanged has had no entries added or removed, so its
+    // stored listing is used instead of reading it again. Files are still
+    // stat'ed, an edit in place doesn't touch the directory.
+    class cLibraryScanner
+    {
+        public:
+            cLibraryScanner() = default;
+            ~cLibraryScanner() = default;
+
+        public:
+            // -------------------------------------------------------------------
+            cLibraryScanner(const cLibraryScanner&) = delete;
+            cLibraryScanner& operator=(const cLibraryScanner&) = delete;
+
+        public:
+            // -------------------------------------------------------------------
+            struct Changes
+            {
+                std::vector<std::string> Added;
+                std::vector<std::string> Modified;
+                std::vector<std::string> Removed;
+
+                size_t Unchanged = 0;
+                size_t SkippedDirectories = 0;
+            };
+
+        public:
+            // -------------------------------------------------------------------
+            // Adds the changes to the audio files under root to changes. Nothing
+            // is reported for a root that cannot be read, an unmounted drive is
+            // not an empty one.
+            bool Scan(sqlite3* connection, const std::string& root, Changes& changes,
+                      bool followSymLinks, const std::atomic<bool>& cancelled);
+
+            // Store what the scans saw, once the changes have been imported
+            void Commit(sqlite3* connection);
+
+        private:
+            // -------------------------------------------------------------------
+            struct FileState
+            {
+                std::string Directory;
+                int64_t Size;
+                int64_t Time;
+                int64_t Inode;
+            };
+
+            struct DirectoryState
+            {
+                std::string Parent;
+                int64_t Time;
+            };
+
+            void Load(sqlite3* connection, const std::string& root,
+                      std::unordered_map<std::string, FileState>& files,
+                      std::unordered_map<std::string, DirectoryState>& directories);
+
+        private:
+            // -------------------------------------------------------------------
+            // Written by Commit()
+            std::vector<std::pair<std::string, FileState>> m_StoreFiles;
+            std::vector<std::pair<std::string, DirectoryState>> m_StoreDirectories;
+            std::vector<std::string> m_RemoveFiles;
+            std::vector<std::string> m_RemoveDirectories;
+    };
+
+}
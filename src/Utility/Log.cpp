@@ -19,23 +19,68 @@
  */
 
 #include "Log.hpp"
+#include "Utility/Paths.hpp"
 
 #include <iostream>
+#include <vector>
 
+#include "spdlog/async.h"
+#include "spdlog/cfg/env.h"
+#include "spdlog/sinks/rotating_file_sink.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
 
+#include <wx/utils.h>
+
 namespace SampleHive {
 
-    std::shared_ptr<spdlog::logger> cLog::s_pLogger;
+    const size_t cLog::s_QueueSize;
+    const size_t cLog::s_MaxFileSize;
+    const size_t cLog::s_MaxFiles;
+
+    std::shared_ptr<spdlog::logger> cLog::s_pLoggers[cLog::SubsystemCount];
 
     void cLog::InitLogger(const std::string& logger)
     {
-        spdlog::set_pattern("%^[%-T] [%-n] [%l]: %v %@%$");
-
         try
         {
-            s_pLogger = spdlog::stdout_color_mt(logger);
-            s_pLogger->set_level(spdlog::level::trace);
+            spdlog::init_thread_pool(s_QueueSize, 1);
+
+            std::vector<spdlog::sink_ptr> sinks;
+            sinks.push_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+
+            try
+            {
+                sinks.push_back(std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
+                    static_cast<std::string>(LOG_FILEPATH), s_MaxFileSize, s_MaxFiles));
+            }
+            catch (const spdlog::spdlog_ex& ex)
+            {
+                std::cout << "Cannot open log file, logging to console only: " << ex.what() << std::endl;
+            }
+
+            const char* names[SubsystemCount] = { logger.c_str(), "Database", "Audio", "Import", "Config" };
+
+            for (int i = 0; i < SubsystemCount; i++)
+            {
+                s_pLoggers[i] = std::make_shared<spdlog::async_logger>(names[i], sinks.begin(), sinks.end(),
+                                                                       spdlog::thread_pool(),
+                                                                       spdlog::async_overflow_policy::overrun_oldest);
+                s_pLoggers[i]->set_pattern("%^[%-T] [%-n] [%l]: %v %@%$");
+
+            #ifdef SH_BUILD_DEBUG
+                s_pLoggers[i]->set_level(spdlog::level::debug);
+            #else
+                s_pLoggers[i]->set_level(spdlog::level::info);
+            #endif
+
+                // Keep what led up to a crash in the file
+                s_pLoggers[i]->flush_on(spdlog::level::warn);
+
+                spdlog::register_logger(s_pLoggers[i]);
+            }
+
+            // Per subsystem overrides from SPDLOG_LEVEL
+            spdlog::cfg::load_env_levels();
         }
         catch (const spdlog::spdlog_ex& ex)
         {
@@ -43,4 +88,10 @@ namespace SampleHive {
         }
     }
 
+    void cLog::SetLevel(eSubsystem subsystem, spdlog::level::level_enum level)
+    {
+        if (s_pLoggers[subsystem])
+            s_pLoggers[subsystem]->set_level(level);
+    }
+
 }
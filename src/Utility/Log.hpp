@@ -21,37 +21,71 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include <SampleHiveConfig.hpp>
 
 #ifdef SH_BUILD_DEBUG
     #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
 #else
-    #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_OFF
+    #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_INFO
 #endif
 
 #include <spdlog/spdlog.h>
 
 namespace SampleHive {
 
+    // One async logger per subsystem, all writing to the console and to a
+    // rotating file from a single background thread. Messages go through a
+    // bounded queue that drops the oldest entry rather than block the caller.
     class cLog
     {
         public:
+            enum eSubsystem
+            {
+                General,
+                Database,
+                Audio,
+                Import,
+                Config,
+                SubsystemCount
+            };
+
+        public:
+            // Levels can be set per subsystem at startup through SPDLOG_LEVEL,
+            // e.g. SPDLOG_LEVEL=warn,Database=trace
             static void InitLogger(const std::string& logger);
 
+            static void SetLevel(eSubsystem subsystem, spdlog::level::level_enum level);
+
         public:
-            inline static std::shared_ptr<spdlog::logger>& GetLogger() { return s_pLogger; }
+            inline static std::shared_ptr<spdlog::logger>& GetLogger(eSubsystem subsystem = General)
+            {
+                return s_pLoggers[subsystem];
+            }
 
         private:
-            static std::shared_ptr<spdlog::logger> s_pLogger;
+            static const size_t s_QueueSize = 8192;
+            static const size_t s_MaxFileSize = 5 * 1024 * 1024;
+            static const size_t s_MaxFiles = 3;
+
+            static std::shared_ptr<spdlog::logger> s_pLoggers[SubsystemCount];
     };
 
-    // Log macros
-    #define SH_LOG_TRACE(...)    SPDLOG_LOGGER_TRACE(::SampleHive::cLog::GetLogger(), __VA_ARGS__)
-    #define SH_LOG_INFO(...)     SPDLOG_LOGGER_INFO(::SampleHive::cLog::GetLogger(), __VA_ARGS__)
-    #define SH_LOG_WARN(...)     SPDLOG_LOGGER_WARN(::SampleHive::cLog::GetLogger(), __VA_ARGS__)
-    #define SH_LOG_DEBUG(...)    SPDLOG_LOGGER_DEBUG(::SampleHive::cLog::GetLogger(), __VA_ARGS__)
-    #define SH_LOG_ERROR(...)    SPDLOG_LOGGER_ERROR(::SampleHive::cLog::GetLogger(), __VA_ARGS__)
-    #define SH_LOG_CRITICAL(...) SPDLOG_LOGGER_CRITICAL(::SampleHive::cLog::GetLogger(), __VA_ARGS__)
+    // A source file picks its subsystem by defining SH_LOG_SUBSYSTEM before
+    // its first include
+    #ifndef SH_LOG_SUBSYSTEM
+        #define SH_LOG_SUBSYSTEM General
+    #endif
+
+    #define SH_LOGGER ::SampleHive::cLog::GetLogger(::SampleHive::cLog::SH_LOG_SUBSYSTEM)
+
+    // Log macros, the level check comes before any formatting
+    #define SH_LOG_TRACE(...)    SPDLOG_LOGGER_TRACE(SH_LOGGER, __VA_ARGS__)
+    #define SH_LOG_INFO(...)     SPDLOG_LOGGER_INFO(SH_LOGGER, __VA_ARGS__)
+    #define SH_LOG_WARN(...)     SPDLOG_LOGGER_WARN(SH_LOGGER, __VA_ARGS__)
+    #define SH_LOG_DEBUG(...)    SPDLOG_LOGGER_DEBUG(SH_LOGGER, __VA_ARGS__)
+    #define SH_LOG_ERROR(...)    SPDLOG_LOGGER_ERROR(SH_LOGGER, __VA_ARGS__)
+    #define SH_LOG_CRITICAL(...) SPDLOG_LOGGER_CRITICAL(SH_LOGGER, __VA_ARGS__)
 
 }
@@ -0,0 +1,306 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Database
+
+#include "Utility/MetadataCache.hpp"
+#include "Database/QueryProfiler.hpp"
+#include "Utility/Log.hpp"
+
+#include <algorithm>
+
+#include <sys/stat.h>
+
+namespace {
+
+    const char* s_SelectMetadata = "SELECT SIZE, MTIME, VALID, TITLE, ARTIST, ALBUM, GENRE, COMMENT, "
+                                   "CHANNELS, LENGTH, SAMPLERATE, BITRATE FROM METADATA WHERE PATH = ?;";
+
+    const char* s_UpsertMetadata = "INSERT OR REPLACE INTO METADATA (PATH, SIZE, MTIME, VALID, TITLE, ARTIST, "
+                                   "ALBUM, GENRE, COMMENT, CHANNELS, LENGTH, SAMPLERATE, BITRATE) "
+                                   "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
+
+    const char* s_DeleteMetadata = "DELETE FROM METADATA WHERE PATH = ?;";
+
+    bool stat_file(const std::string& path, uint64_t& size, int64_t& mtime)
+    {
+        struct stat info;
+
+        if (stat(path.c_str(), &info) != 0)
+            return false;
+
+        size = static_cast<uint64_t>(info.st_size);
+        mtime = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+
+        return true;
+    }
+
+    wxString column_string(sqlite3_stmt* statement, int column)
+    {
+        const unsigned char* text = sqlite3_column_text(statement, column);
+
+        return text ? wxString::FromUTF8(reinterpret_cast<const char*>(text)) : wxString();
+    }
+
+    void bind_string(sqlite3_stmt* statement, int index, const wxString& value)
+    {
+        sqlite3_bind_text(statement, index, value.ToUTF8().data(), -1, SQLITE_TRANSIENT);
+    }
+
+    bool store(sqlite3_stmt* statement, const std::string& path, uint64_t size, int64_t mtime,
+               const SampleHive::cTags::AudioInfo& info)
+    {
+        sqlite3_bind_text(statement, 1, path.c_str(), static_cast<int>(path.size()), SQLITE_STATIC);
+        sqlite3_bind_int64(statement, 2, static_cast<sqlite3_int64>(size));
+        sqlite3_bind_int64(statement, 3, mtime);
+        sqlite3_bind_int(statement, 4, info.valid ? 1 : 0);
+        bind_string(statement, 5, info.title);
+        bind_string(statement, 6, info.artist);
+        bind_string(statement, 7, info.album);
+        bind_string(statement, 8, info.genre);
+        bind_string(statement, 9, info.comment);
+        sqlite3_bind_int(statement, 10, info.channels);
+        sqlite3_bind_int(statement, 11, info.length);
+        sqlite3_bind_int(statement, 12, info.sample_rate);
+        sqlite3_bind_int(statement, 13, info.bitrate);
+
+        const bool stored = sqlite3_step(statement) == SQLITE_DONE;
+
+        sqlite3_reset(statement);
+        sqlite3_clear_bindings(statement);
+
+        return stored;
+    }
+
+}
+
+namespace SampleHive {
+
+    cMetadataCache::cMetadataCache()
+        : m_MemoryHits(0), m_DatabaseHits(0), m_Misses(0)
+    {
+
+    }
+
+    void cMetadataCache::Open(const std::string& databasePath)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (m_pDatabase)
+            return;
+
+        if (sqlite3_open_v2(databasePath.c_str(), &m_pDatabase, SQLITE_OPEN_READWRITE, NULL) != SQLITE_OK ||
+            sqlite3_prepare_v2(m_pDatabase, s_SelectMetadata, -1, &m_pSelect, NULL) != SQLITE_OK ||
+            sqlite3_prepare_v2(m_pDatabase, s_DeleteMetadata, -1, &m_pDelete, NULL) != SQLITE_OK)
+        {
+            SH_LOG_WARN("Metadata cache stays in memory, {}", sqlite3_errmsg(m_pDatabase));
+
+            sqlite3_finalize(m_pSelect);
+            sqlite3_finalize(m_pDelete);
+            sqlite3_close(m_pDatabase);
+
+            m_pSelect = nullptr;
+            m_pDelete = nullptr;
+            m_pDatabase = nullptr;
+
+            return;
+        }
+
+        // The import writer may hold the write lock for a batch. NORMAL sync
+        // is safe in WAL mode and spares a fsync per commit.
+        sqlite3_busy_timeout(m_pDatabase, 5000);
+        sqlite3_exec(m_pDatabase, "PRAGMA synchronous = NORMAL;", NULL, NULL, NULL);
+
+        cQueryProfiler::Get().Attach(m_pDatabase);
+    }
+
+    void cMetadataCache::Close()
+    {
+        // Whatever was read outside an import, the tag editor for one
+        Flush(m_pDatabase);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        sqlite3_finalize(m_pSelect);
+        sqlite3_finalize(m_pDelete);
+        sqlite3_close(m_pDatabase);
+
+        m_pSelect = nullptr;
+        m_pDelete = nullptr;
+        m_pDatabase = nullptr;
+    }
+
+    cTags::AudioInfo cMetadataCache::GetAudioInfo(const std::string& path)
+    {
+        Entry entry;
+
+        // A file that cannot be stat'ed cannot be validated, read it straight
+        if (!stat_file(path, entry.FileSize, entry.FileTime))
+        {
+            m_Misses++;
+            return cTags(path).GetAudioInfo();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            auto it = m_Entries.find(path);
+
+            if (it != m_Entries.end() && it->second.FileSize == entry.FileSize && it->second.FileTime == entry.FileTime)
+            {
+                m_MemoryHits++;
+                return it->second.Info;
+            }
+
+            if (FindInDatabase(path, entry.FileSize, entry.FileTime, entry.Info))
+            {
+                m_DatabaseHits++;
+
+                if (m_Entries.size() >= s_MaxEntries)
+                    m_Entries.clear();
+
+                m_Entries[path] = entry;
+
+                return entry.Info;
+            }
+        }
+
+        m_Misses++;
+
+        // TagLib runs unlocked so the import workers read files in parallel
+        entry.Info = cTags(path).GetAudioInfo();
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (m_Entries.size() >= s_MaxEntries)
+            m_Entries.clear();
+
+        m_Entries[path] = entry;
+        m_Pending.emplace_back(path, entry);
+
+        return entry.Info;
+    }
+
+    void cMetadataCache::Flush(sqlite3* connection)
+    {
+        std::vector<std::pair<std::string, Entry>> pending;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            pending.swap(m_Pending);
+        }
+
+        if (pending.empty() || !connection)
+            return;
+
+        sqlite3_stmt* upsert = nullptr;
+
+        // A savepoint nests inside a transaction the caller may have open
+        if (sqlite3_prepare_v2(connection, s_UpsertMetadata, -1, &upsert, NULL) != SQLITE_OK ||
+            sqlite3_exec(connection, "SAVEPOINT metadata;", NULL, NULL, NULL) != SQLITE_OK)
+        {
+            SH_LOG_WARN("Cannot store metadata of {} files, {}", pending.size(), sqlite3_errmsg(connection));
+            sqlite3_finalize(upsert);
+            return;
+        }
+
+        for (const auto& file : pending)
+        {
+            if (!store(upsert, file.first, file.second.FileSize, file.second.FileTime, file.second.Info))
+                SH_LOG_WARN("Cannot store metadata of {}, {}", file.first, sqlite3_errmsg(connection));
+        }
+
+        if (sqlite3_exec(connection, "RELEASE metadata;", NULL, NULL, NULL) != SQLITE_OK)
+        {
+            SH_LOG_WARN("Cannot store metadata of {} files, {}", pending.size(), sqlite3_errmsg(connection));
+
+            sqlite3_exec(connection, "ROLLBACK TO metadata;", NULL, NULL, NULL);
+            sqlite3_exec(connection, "RELEASE metadata;", NULL, NULL, NULL);
+        }
+
+        sqlite3_finalize(upsert);
+
+        SH_LOG_TRACE("Stored metadata of {} files", pending.size());
+    }
+
+    void cMetadataCache::Invalidate(const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_Entries.erase(path);
+
+        m_Pending.erase(std::remove_if(m_Pending.begin(), m_Pending.end(),
+                                       [&path](const std::pair<std::string, Entry>& file)
+                                       {
+                                           return file.first == path;
+                                       }), m_Pending.end());
+
+        if (!m_pDelete)
+            return;
+
+        sqlite3_bind_text(m_pDelete, 1, path.c_str(), static_cast<int>(path.size()), SQLITE_STATIC);
+
+        if (sqlite3_step(m_pDelete) != SQLITE_DONE)
+            SH_LOG_WARN("Cannot forget metadata of {}, {}", path, sqlite3_errmsg(m_pDatabase));
+
+        sqlite3_reset(m_pDelete);
+        sqlite3_clear_bindings(m_pDelete);
+    }
+
+    bool cMetadataCache::FindInDatabase(const std::string& path, uint64_t size, int64_t mtime,
+                                        cTags::AudioInfo& info)
+    {
+        if (!m_pSelect)
+            return false;
+
+        sqlite3_bind_text(m_pSelect, 1, path.c_str(), static_cast<int>(path.size()), SQLITE_STATIC);
+
+        bool found = false;
+
+        if (sqlite3_step(m_pSelect) == SQLITE_ROW &&
+            static_cast<uint64_t>(sqlite3_column_int64(m_pSelect, 0)) == size &&
+            sqlite3_column_int64(m_pSelect, 1) == mtime)
+        {
+            info.valid = sqlite3_column_int(m_pSelect, 2) != 0;
+            info.title = column_string(m_pSelect, 3);
+            info.artist = column_string(m_pSelect, 4);
+            info.album = column_string(m_pSelect, 5);
+            info.genre = column_string(m_pSelect, 6);
+            info.comment = column_string(m_pSelect, 7);
+            info.channels = sqlite3_column_int(m_pSelect, 8);
+            info.length = sqlite3_column_int(m_pSelect, 9);
+            info.sample_rate = sqlite3_column_int(m_pSelect, 10);
+            info.bitrate = sqlite3_column_int(m_pSelect, 11);
+
+            found = true;
+        }
+
+        sqlite3_reset(m_pSelect);
+        sqlite3_clear_bindings(m_pSelect);
+
+        return found;
+    }
+
+    cMetadataCache::~cMetadataCache()
+    {
+        Close();
+    }
+
+}
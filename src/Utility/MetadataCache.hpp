@@ -0,0 +1,117 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Utility/Tags.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <sqlite3.h>
+
+namespace SampleHive {
+
+    // Tags and audio properties of files, so TagLib opens each file once.
+    // Answers from memory, then from the METADATA table, and only reads the
+    // file when neither has it for the file's current size and mtime. Safe
+    // to use from the import workers, it keeps its own sqlite connection.
+    // Files read are written to the table in batches by Flush, so a worker
+    // never waits on the database's write lock.
+    class cMetadataCache
+    {
+        private:
+            cMetadataCache();
+
+        public:
+            ~cMetadataCache();
+
+        public:
+            cMetadataCache(const cMetadataCache&) = delete;
+            cMetadataCache& operator=(const cMetadataCache&) = delete;
+
+        public:
+            static cMetadataCache& Get()
+            {
+                static cMetadataCache s_MetadataCache;
+                return s_MetadataCache;
+            }
+
+        public:
+            // -------------------------------------------------------------------
+            // Persist to and read from the METADATA table of this database,
+            // without it the cache only lives in memory
+            void Open(const std::string& databasePath);
+            void Close();
+
+            cTags::AudioInfo GetAudioInfo(const std::string& path);
+
+            // Store what was read since the last call in one transaction on
+            // connection, the import writer passes its own
+            void Flush(sqlite3* connection);
+
+            // Forget a file after writing its tags, coarse mtimes may not
+            // tell the edit apart
+            void Invalidate(const std::string& path);
+
+            // -------------------------------------------------------------------
+            uint64_t GetMemoryHits() const { return m_MemoryHits.load(); }
+            uint64_t GetDatabaseHits() const { return m_DatabaseHits.load(); }
+            uint64_t GetMisses() const { return m_Misses.load(); }
+
+        private:
+            // -------------------------------------------------------------------
+            struct Entry
+            {
+                uint64_t FileSize;
+                int64_t FileTime;
+                cTags::AudioInfo Info;
+            };
+
+            // Expects m_Mutex to be held
+            bool FindInDatabase(const std::string& path, uint64_t size, int64_t mtime, cTags::AudioInfo& info);
+
+        private:
+            // -------------------------------------------------------------------
+            // The table backs everything up, memory is simply dropped when full
+            static const size_t s_MaxEntries = 65536;
+
+            std::mutex m_Mutex;
+            std::unordered_map<std::string, Entry> m_Entries;
+
+            // Read from the files but not in the table yet
+            std::vector<std::pair<std::string, Entry>> m_Pending;
+
+            sqlite3* m_pDatabase = nullptr;
+            sqlite3_stmt* m_pSelect = nullptr;
+            sqlite3_stmt* m_pDelete = nullptr;
+
+            // -------------------------------------------------------------------
+            std::atomic<uint64_t> m_MemoryHits;
+            std::atomic<uint64_t> m_DatabaseHits;
+            std::atomic<uint64_t> m_Misses;
+    };
+
+}
@@ -51,5 +51,8 @@ namespace SampleHive {
     #define APP_DATA_DIR USER_HOME_DIR + "/.local/share/SampleHive"
     #define CONFIG_FILEPATH APP_CONFIG_DIR + "/config.yaml"
     #define DATABASE_FILEPATH APP_DATA_DIR "/sample.hive"
+    #define APP_PEAKS_DIR APP_DATA_DIR + "/peaks"
+    #define LOG_FILEPATH APP_DATA_DIR + "/SampleHive.log"
+    #define TRACE_FILEPATH APP_DATA_DIR + "/trace.json"
 
 }
@@ -0,0 +1,270 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Utility/PeakKernel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define SH_PEAK_KERNEL_X86 1
+    #include <immintrin.h>
+#endif
+
+namespace {
+
+    // -------------------------------------------------------------------
+    // Scalar
+
+    void downmix_scalar(const float* interleaved, size_t frames, int channels, float* mono)
+    {
+        const float scale = 1.0f / channels;
+
+        for (size_t i = 0; i < frames; i++)
+        {
+            float sum = 0.0f;
+
+            for (int c = 0; c < channels; c++)
+                sum += interleaved[i * channels + c];
+
+            mono[i] = sum * scale;
+        }
+    }
+
+    SampleHive::Peak reduce_scalar(const float* mono, size_t count)
+    {
+        float min = std::numeric_limits<float>::max();
+        float max = std::numeric_limits<float>::lowest();
+        float sum_of_squares = 0.0f;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            min = std::min(min, mono[i]);
+            max = std::max(max, mono[i]);
+            sum_of_squares += mono[i] * mono[i];
+        }
+
+        return { min, max, std::sqrt(sum_of_squares / count) };
+    }
+
+#ifdef SH_PEAK_KERNEL_X86
+
+    // -------------------------------------------------------------------
+    // SSE2, always there on x86_64
+
+    __attribute__((target("sse2")))
+    void downmix_sse2(const float* interleaved, size_t frames, int channels, float* mono)
+    {
+        size_t i = 0;
+
+        if (channels == 2)
+        {
+            const __m128 half = _mm_set1_ps(0.5f);
+
+            for (; i + 4 <= frames; i += 4)
+            {
+                const __m128 a = _mm_loadu_ps(interleaved + i * 2);
+                const __m128 b = _mm_loadu_ps(interleaved + i * 2 + 4);
+
+                const __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                const __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+                _mm_storeu_ps(mono + i, _mm_mul_ps(_mm_add_ps(left, right), half));
+            }
+        }
+        else if (channels == 1)
+        {
+            std::copy(interleaved, interleaved + frames, mono);
+            return;
+        }
+
+        downmix_scalar(interleaved + i * channels, frames - i, channels, mono + i);
+    }
+
+    __attribute__((target("sse2")))
+    SampleHive::Peak reduce_sse2(const float* mono, size_t count)
+    {
+        __m128 min = _mm_set1_ps(std::numeric_limits<float>::max());
+        __m128 max = _mm_set1_ps(std::numeric_limits<float>::lowest());
+        __m128 sum = _mm_setzero_ps();
+
+        size_t i = 0;
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 v = _mm_loadu_ps(mono + i);
+
+            min = _mm_min_ps(min, v);
+            max = _mm_max_ps(max, v);
+            sum = _mm_add_ps(sum, _mm_mul_ps(v, v));
+        }
+
+        alignas(16) float mins[4], maxs[4], sums[4];
+        _mm_store_ps(mins, min);
+        _mm_store_ps(maxs, max);
+        _mm_store_ps(sums, sum);
+
+        float lo = std::min(std::min(mins[0], mins[1]), std::min(mins[2], mins[3]));
+        float hi = std::max(std::max(maxs[0], maxs[1]), std::max(maxs[2], maxs[3]));
+        float sum_of_squares = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+
+        for (; i < count; i++)
+        {
+            lo = std::min(lo, mono[i]);
+            hi = std::max(hi, mono[i]);
+            sum_of_squares += mono[i] * mono[i];
+        }
+
+        return { lo, hi, std::sqrt(sum_of_squares / count) };
+    }
+
+    // -------------------------------------------------------------------
+    // AVX2
+
+    __attribute__((target("avx2")))
+    void downmix_avx2(const float* interleaved, size_t frames, int channels, float* mono)
+    {
+        if (channels != 2)
+        {
+            downmix_sse2(interleaved, frames, channels, mono);
+            return;
+        }
+
+        const __m256 half = _mm256_set1_ps(0.5f);
+
+        size_t i = 0;
+
+        for (; i + 8 <= frames; i += 8)
+        {
+            // Shuffles work within 128 bit lanes, so the pairs come out in
+            // the order 0 1 4 5 2 3 6 7 and are put back with a permute
+            const __m256 a = _mm256_loadu_ps(interleaved + i * 2);
+            const __m256 b = _mm256_loadu_ps(interleaved + i * 2 + 8);
+
+            const __m256 left = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            const __m256 right = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+            const __m256 sum = _mm256_mul_ps(_mm256_add_ps(left, right), half);
+            const __m256 ordered = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(sum),
+                                                                         _MM_SHUFFLE(3, 1, 2, 0)));
+
+            _mm256_storeu_ps(mono + i, ordered);
+        }
+
+        downmix_sse2(interleaved + i * 2, frames - i, 2, mono + i);
+    }
+
+    __attribute__((target("avx2")))
+    SampleHive::Peak reduce_avx2(const float* mono, size_t count)
+    {
+        __m256 min = _mm256_set1_ps(std::numeric_limits<float>::max());
+        __m256 max = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+        __m256 sum = _mm256_setzero_ps();
+
+        size_t i = 0;
+
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 v = _mm256_loadu_ps(mono + i);
+
+            min = _mm256_min_ps(min, v);
+            max = _mm256_max_ps(max, v);
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(v, v));
+        }
+
+        alignas(32) float mins[8], maxs[8], sums[8];
+        _mm256_store_ps(mins, min);
+        _mm256_store_ps(maxs, max);
+        _mm256_store_ps(sums, sum);
+
+        float lo = *std::min_element(mins, mins + 8);
+        float hi = *std::max_element(maxs, maxs + 8);
+        float sum_of_squares = 0.0f;
+
+        for (float s : sums)
+            sum_of_squares += s;
+
+        for (; i < count; i++)
+        {
+            lo = std::min(lo, mono[i]);
+            hi = std::max(hi, mono[i]);
+            sum_of_squares += mono[i] * mono[i];
+        }
+
+        return { lo, hi, std::sqrt(sum_of_squares / count) };
+    }
+
+#endif
+
+    // -------------------------------------------------------------------
+    using Kernel = SampleHive::cPeakKernel::Implementation;
+
+    std::vector<Kernel> supported_kernels()
+    {
+        std::vector<Kernel> kernels;
+
+    #ifdef SH_PEAK_KERNEL_X86
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx2"))
+            kernels.push_back({ "AVX2", downmix_avx2, reduce_avx2 });
+
+        if (__builtin_cpu_supports("sse2"))
+            kernels.push_back({ "SSE2", downmix_sse2, reduce_sse2 });
+    #endif
+
+        kernels.push_back({ "scalar", downmix_scalar, reduce_scalar });
+
+        return kernels;
+    }
+
+    const Kernel s_Kernel = supported_kernels().front();
+
+}
+
+namespace SampleHive {
+
+    void cPeakKernel::Downmix(const float* interleaved, size_t frames, int channels, float* mono)
+    {
+        s_Kernel.Downmix(interleaved, frames, channels, mono);
+    }
+
+    size_t cPeakKernel::Reduce(const float* mono, size_t count, uint32_t framesPerPeak, Peak* peaks)
+    {
+        size_t written = 0;
+
+        for (size_t i = 0; i < count; i += framesPerPeak)
+            peaks[written++] = s_Kernel.Reduce(mono + i, std::min<size_t>(framesPerPeak, count - i));
+
+        return written;
+    }
+
+    const char* cPeakKernel::GetName()
+    {
+        return s_Kernel.Name;
+    }
+
+    std::vector<cPeakKernel::Implementation> cPeakKernel::GetImplementations()
+    {
+        return supported_kernels();
+    }
+
+}
@@ -0,0 +1,62 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Utility/AudioAnalysis.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SampleHive {
+
+    // Inner loops of the waveform analysis. On x86 the best of AVX2 and SSE2
+    // the CPU supports is picked once at startup, anything else runs the
+    // scalar version.
+    class cPeakKernel
+    {
+        public:
+            // Average interleaved frames of any channel count down to mono
+            static void Downmix(const float* interleaved, size_t frames, int channels, float* mono);
+
+            // Min, max and RMS of every framesPerPeak samples, the last peak
+            // covers whatever is left. Returns the number of peaks written.
+            static size_t Reduce(const float* mono, size_t count, uint32_t framesPerPeak, Peak* peaks);
+
+            // Name of the implementation in use, for the log
+            static const char* GetName();
+
+        public:
+            // -------------------------------------------------------------------
+            // One version of both loops, Reduce here makes a single peak
+            struct Implementation
+            {
+                const char* Name;
+                void (*Downmix)(const float* interleaved, size_t frames, int channels, float* mono);
+                Peak (*Reduce)(const float* mono, size_t count);
+            };
+
+            // Every version this CPU can run, the one in use first. Only the
+            // benchmark calls them directly.
+            static std::vector<Implementation> GetImplementations();
+    };
+
+}
@@ -0,0 +1,294 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define SH_LOG_SUBSYSTEM Audio
+
+#include "Utility/PeakPyramid.hpp"
+#include "Utility/Log.hpp"
+#include "Utility/Paths.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <wx/utils.h>
+
+namespace {
+
+    const char s_Magic[4] = { 'S', 'H', 'P', 'K' };
+    const uint32_t s_Version = 2;
+
+    struct PeakFileLevel
+    {
+        uint32_t FramesPerPeak;
+        uint32_t Count;
+        uint64_t Offset;
+    };
+
+    struct PeakFileHeader
+    {
+        char Magic[4];
+        uint32_t Version;
+        uint64_t SourceSize;
+        int64_t SourceMTime;
+        uint64_t Frames;
+        uint32_t SampleRate;
+        uint32_t Channels;
+        uint32_t LevelCount;
+        uint32_t Reserved;
+        PeakFileLevel Levels[SampleHive::cPeakPyramid::s_MaxLevels];
+    };
+
+    bool stat_source(const std::string& path, uint64_t& size, int64_t& mtime)
+    {
+        struct stat info;
+
+        if (stat(path.c_str(), &info) != 0)
+            return false;
+
+        size = static_cast<uint64_t>(info.st_size);
+        mtime = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+
+        return true;
+    }
+
+    // FNV-1a, stable across runs and builds unlike std::hash
+    uint64_t hash_path(const std::string& path)
+    {
+        uint64_t hash = 14695981039346656037ull;
+
+        for (unsigned char c : path)
+        {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    // Merge every factor peaks of the level below into one
+    std::vector<SampleHive::Peak> merge_level(const SampleHive::Peak* peaks, size_t count, uint32_t factor)
+    {
+        std::vector<SampleHive::Peak> merged;
+        merged.reserve(count / factor + 1);
+
+        for (size_t i = 0; i < count; i += factor)
+        {
+            const size_t end = std::min(count, i + factor);
+
+            SampleHive::Peak peak = { std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest(), 0.0f };
+            double sum_of_squares = 0.0;
+
+            for (size_t j = i; j < end; j++)
+            {
+                peak.Min = std::min(peak.Min, peaks[j].Min);
+                peak.Max = std::max(peak.Max, peaks[j].Max);
+                sum_of_squares += static_cast<double>(peaks[j].RMS) * peaks[j].RMS;
+            }
+
+            peak.RMS = static_cast<float>(std::sqrt(sum_of_squares / (end - i)));
+            merged.push_back(peak);
+        }
+
+        return merged;
+    }
+
+}
+
+namespace SampleHive {
+
+    cPeakPyramid::~cPeakPyramid()
+    {
+        if (m_pMapping)
+            munmap(m_pMapping, m_MappingSize);
+    }
+
+    std::string cPeakPyramid::GetPeakFilePath(const std::string& samplePath)
+    {
+        static const std::string s_Directory = static_cast<std::string>(APP_PEAKS_DIR);
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "/%016llx.peaks", static_cast<unsigned long long>(hash_path(samplePath)));
+
+        return s_Directory + name;
+    }
+
+    std::unique_ptr<cPeakPyramid> cPeakPyramid::Build(const AudioAnalysis& analysis)
+    {
+        std::unique_ptr<cPeakPyramid> pyramid(new cPeakPyramid());
+
+        pyramid->m_Frames = analysis.Frames;
+        pyramid->m_SampleRate = analysis.SampleRate;
+        pyramid->m_Channels = analysis.Channels;
+
+        pyramid->m_Storage.reserve(s_MaxLevels);
+        pyramid->m_Storage.push_back(analysis.Peaks);
+
+        uint32_t frames_per_peak = analysis.FramesPerPeak;
+
+        // Stop once a level would fit in a handful of pixels
+        while (pyramid->m_Storage.size() < s_MaxLevels && pyramid->m_Storage.back().size() > s_LevelFactor)
+        {
+            const auto& below = pyramid->m_Storage.back();
+            pyramid->m_Storage.push_back(merge_level(below.data(), below.size(), s_LevelFactor));
+        }
+
+        for (const auto& peaks : pyramid->m_Storage)
+        {
+            pyramid->m_Levels.push_back({ frames_per_peak, static_cast<uint32_t>(peaks.size()), peaks.data() });
+            frames_per_peak *= s_LevelFactor;
+        }
+
+        return pyramid;
+    }
+
+    bool cPeakPyramid::Save(const std::string& samplePath) const
+    {
+        PeakFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.Magic, s_Magic, sizeof(s_Magic));
+        header.Version = s_Version;
+
+        if (!stat_source(samplePath, header.SourceSize, header.SourceMTime))
+            return false;
+
+        header.Frames = m_Frames;
+        header.SampleRate = static_cast<uint32_t>(m_SampleRate);
+        header.Channels = static_cast<uint32_t>(m_Channels);
+        header.LevelCount = static_cast<uint32_t>(m_Levels.size());
+
+        uint64_t offset = sizeof(header);
+
+        for (size_t i = 0; i < m_Levels.size(); i++)
+        {
+            header.Levels[i] = { m_Levels[i].FramesPerPeak, m_Levels[i].Count, offset };
+            offset += m_Levels[i].Count * sizeof(Peak);
+        }
+
+        const std::string path = GetPeakFilePath(samplePath);
+        const std::string temp_path = path + ".tmp" + std::to_string(wxGetProcessId()) + "-" +
+            std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+        {
+            std::ofstream ofstrm(temp_path, std::ios::binary | std::ios::trunc);
+
+            ofstrm.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            for (const auto& level : m_Levels)
+                ofstrm.write(reinterpret_cast<const char*>(level.Peaks), level.Count * sizeof(Peak));
+
+            if (!ofstrm)
+            {
+                SH_LOG_ERROR("Error! Cannot write peaks for {} to {}", samplePath, temp_path);
+                std::remove(temp_path.c_str());
+                return false;
+            }
+        }
+
+        // Readers never map a half written file
+        if (std::rename(temp_path.c_str(), path.c_str()) != 0)
+        {
+            std::remove(temp_path.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    std::unique_ptr<cPeakPyramid> cPeakPyramid::Open(const std::string& samplePath)
+    {
+        const int fd = open(GetPeakFilePath(samplePath).c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (fd < 0)
+            return nullptr;
+
+        struct stat info;
+        void* mapping = MAP_FAILED;
+
+        if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(PeakFileHeader))
+            mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        // The mapping stays valid after the descriptor is closed
+        close(fd);
+
+        if (mapping == MAP_FAILED)
+            return nullptr;
+
+        std::unique_ptr<cPeakPyramid> pyramid(new cPeakPyramid());
+        pyramid->m_pMapping = mapping;
+        pyramid->m_MappingSize = static_cast<size_t>(info.st_size);
+
+        const auto* header = static_cast<const PeakFileHeader*>(mapping);
+
+        if (std::memcmp(header->Magic, s_Magic, sizeof(s_Magic)) != 0 || header->Version != s_Version ||
+            header->LevelCount == 0 || header->LevelCount > s_MaxLevels)
+            return nullptr;
+
+        uint64_t size = 0;
+        int64_t mtime = 0;
+
+        if (!stat_source(samplePath, size, mtime) || size != header->SourceSize || mtime != header->SourceMTime)
+        {
+            SH_LOG_DEBUG("Peaks for {} are out of date", samplePath);
+            return nullptr;
+        }
+
+        for (uint32_t i = 0; i < header->LevelCount; i++)
+        {
+            const PeakFileLevel& level = header->Levels[i];
+
+            if (level.Offset % alignof(Peak) != 0 ||
+                level.Offset + static_cast<uint64_t>(level.Count) * sizeof(Peak) > pyramid->m_MappingSize)
+                return nullptr;
+
+            pyramid->m_Levels.push_back({ level.FramesPerPeak, level.Count,
+                                          reinterpret_cast<const Peak*>(static_cast<const char*>(mapping) + level.Offset) });
+        }
+
+        pyramid->m_Frames = header->Frames;
+        pyramid->m_SampleRate = static_cast<int>(header->SampleRate);
+        pyramid->m_Channels = static_cast<int>(header->Channels);
+
+        return pyramid;
+    }
+
+    const cPeakPyramid::Level& cPeakPyramid::GetLevelFor(size_t bins) const
+    {
+        const uint64_t frames_per_bin = m_Frames / std::max<size_t>(bins, 1);
+
+        for (size_t i = m_Levels.size(); i-- > 1;)
+        {
+            if (m_Levels[i].FramesPerPeak <= frames_per_bin)
+                return m_Levels[i];
+        }
+
+        return m_Levels.front();
+    }
+
+}
@@ -0,0 +1,99 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Utility/AudioAnalysis.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SampleHive {
+
+    // Waveform peaks of one sample at several resolutions, each level merges
+    // s_LevelFactor peaks of the one below. Pyramids are kept on disk under
+    // APP_PEAKS_DIR, one file per sample named after a hash of its path, and
+    // mapped into memory when opened. A file is only used while the size and
+    // modification time of the sample still match what it was built from.
+    class cPeakPyramid
+    {
+        public:
+            static const uint32_t s_LevelFactor = 4;
+            static const size_t s_MaxLevels = 4;
+
+            struct Level
+            {
+                uint32_t FramesPerPeak;
+                uint32_t Count;
+                const Peak* Peaks;
+            };
+
+        public:
+            ~cPeakPyramid();
+
+        public:
+            // -------------------------------------------------------------------
+            cPeakPyramid(const cPeakPyramid&) = delete;
+            cPeakPyramid& operator=(const cPeakPyramid&) = delete;
+
+        public:
+            // -------------------------------------------------------------------
+            // Builds the coarser levels in memory from the analysed peaks
+            static std::unique_ptr<cPeakPyramid> Build(const AudioAnalysis& analysis);
+
+            // Returns nullptr if there is no usable file for the sample
+            static std::unique_ptr<cPeakPyramid> Open(const std::string& samplePath);
+
+            bool Save(const std::string& samplePath) const;
+
+        public:
+            // -------------------------------------------------------------------
+            // Coarsest level with at least one peak for each of bins spread
+            // over the whole sample, also for pyramids of a partial decode
+            const Level& GetLevelFor(size_t bins) const;
+
+            inline uint64_t GetFrames() const { return m_Frames; }
+            inline int GetSampleRate() const { return m_SampleRate; }
+            inline size_t GetLevelCount() const { return m_Levels.size(); }
+
+        private:
+            // -------------------------------------------------------------------
+            cPeakPyramid() = default;
+
+            static std::string GetPeakFilePath(const std::string& samplePath);
+
+        private:
+            // -------------------------------------------------------------------
+            uint64_t m_Frames = 0;
+            int m_SampleRate = 0;
+            int m_Channels = 0;
+
+            std::vector<Level> m_Levels;
+
+            // Backing for the levels, either built here or a mapped file
+            std::vector<std::vector<Peak>> m_Storage;
+            void* m_pMapping = nullptr;
+            size_t m_MappingSize = 0;
+    };
+
+}
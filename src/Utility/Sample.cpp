@@ -45,6 +45,7 @@ Sample::Sample(int favorite, const std::string& filename, const std::string& fil
 ///Clears all sample data
 void Sample::Clear() 
 {
+    m_ID = -1;
     m_Favorite = 0;
     m_Channels = 0;
     m_BPM = 0;
@@ -52,6 +53,7 @@ void Sample::Clear()
     m_SampleRate = 0;
     m_Bitrate = 0;
     m_Trashed = 0;
+    m_Fingerprint = 0;
     m_Filename = "";
     m_FileExtension = "";
     m_SamplePack = "";
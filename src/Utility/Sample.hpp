@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 /**
@@ -45,6 +46,7 @@ class Sample
 
     private:
         // -------------------------------------------------------------------
+        int64_t m_ID = -1;
         int m_Favorite = 0;
         int m_Channels = 0;
         int m_BPM = 0;
@@ -52,6 +54,7 @@ class Sample
         int m_SampleRate = 0;
         int m_Bitrate = 0;
         int m_Trashed = 0;
+        uint64_t m_Fingerprint = 0;
         std::string m_Filename;
         std::string m_FileExtension;
         std::string m_SamplePack;
@@ -61,6 +64,7 @@ class Sample
     public:
         // -------------------------------------------------------------------
         // Getters
+        int64_t GetID() const { return m_ID; }
         int GetFavorite() const { return m_Favorite; }
         int GetChannels() const { return m_Channels; }
         int GetBPM() const { return m_BPM; }
@@ -68,6 +72,7 @@ class Sample
         int GetSampleRate() const { return m_SampleRate; }
         int GetBitrate() const { return m_Bitrate; }
         int GetTrashed() const { return m_Trashed; }
+        uint64_t GetFingerprint() const { return m_Fingerprint; }
         std::string GetFilename() const { return m_Filename; }
         std::string GetFileExtension() const { return m_FileExtension; }
         std::string GetSamplePack() const { return m_SamplePack; }
@@ -80,6 +85,7 @@ class Sample
                  const std::string& samplePack, const std::string& type, int channels, int bpm,
                  int length, int sampleRate, int bitrate, const std::string& path, int trashed);
 
+        void SetID(int64_t id) { m_ID = id; }
         void SetFavorite(int favorite) { m_Favorite = favorite; }
         void SetChannels(int channels) { m_Channels = channels; }
         void SetBPM(int bpm) { m_BPM = bpm; }
@@ -87,6 +93,7 @@ class Sample
         void SetSampleRate(int sampleRate) { m_SampleRate = sampleRate; }
         void SetBitrate(int bitrate) { m_Bitrate = bitrate; }
         void SetTrashed(int trashed) { m_Trashed = trashed; }
+        void SetFingerprint(uint64_t fingerprint) { m_Fingerprint = fingerprint; }
         void SetFilename(const std::string& filename) { m_Filename = filename; }
         void SetFileExtension(const std::string& fileExtension) { m_FileExtension = fileExtension; }
         void SetSamplePack(const std::string& samplePack) { m_SamplePack = samplePack; }
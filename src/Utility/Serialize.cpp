@@ -18,11 +18,13 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#define SH_LOG_SUBSYSTEM Config
+
 #include "Utility/Serialize.hpp"
+#include "Utility/ConfigStore.hpp"
 #include "Utility/Log.hpp"
 #include "Utility/Paths.hpp"
 
-#include <fstream>
 #include <sstream>
 
 #include <wx/colour.h>
@@ -36,8 +38,6 @@ namespace SampleHive {
 
     cSerializer::cSerializer()
     {
-        std::ifstream ifstrm(static_cast<std::string>(CONFIG_FILEPATH));
-
         wxFont font = wxSystemSettings::GetFont(wxSYS_DEFAULT_GUI_FONT);
         std::string system_font_face = font.GetFaceName().ToStdString();
         int system_font_size = font.GetPointSize();
@@ -49,7 +49,8 @@ namespace SampleHive {
         // Initialize the logger
         // SampleHive::Log::InitLogger("Serializer");
 
-        if (!ifstrm)
+        // Parsed once for the whole app, every later cSerializer only checks the store
+        if (cConfigStore::Get().IsEmpty())
         {
             SH_LOG_INFO("Genrating configuration file..");
 
@@ -111,8 +112,7 @@ namespace SampleHive {
 
             m_Emitter << YAML::EndMap;
 
-            std::ofstream ofstrm(static_cast<std::string>(CONFIG_FILEPATH));
-            ofstrm << m_Emitter.c_str();
+            cConfigStore::Get().Create(m_Emitter.c_str());
 
             SH_LOG_INFO("Generated {} successfully!", static_cast<std::string>(CONFIG_FILEPATH));
         }
@@ -125,21 +125,16 @@ namespace SampleHive {
 
     void cSerializer::SerializeWinSize(int w, int h)
     {
-        YAML::Emitter out;
-
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto win = config["Window"])
             {
                 win["Width"] = w;
                 win["Height"] = h;
 
-                out << config;
-
-                std::ofstream ofstrm(static_cast<std::string>(CONFIG_FILEPATH));
-                ofstrm << out.c_str();
+                cConfigStore::Get().MarkDirty();
             }
             else
             {
@@ -158,7 +153,7 @@ namespace SampleHive {
 
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (!config["Window"])
             {
@@ -183,11 +178,9 @@ namespace SampleHive {
 
     void cSerializer::SerializeShowMenuAndStatusBar(std::string key, bool value)
     {
-        YAML::Emitter out;
-
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto bar = config["Window"])
             {
@@ -197,10 +190,7 @@ namespace SampleHive {
                 if (key == "statusbar")
                      bar["ShowStatusBar"] = value;
 
-                out << config;
-
-                std::ofstream ofstrm(static_cast<std::string>(CONFIG_FILEPATH));
-                ofstrm << out.c_str();
+                cConfigStore::Get().MarkDirty();
             }
             else
                 SH_LOG_ERROR("Error! Cannot store show bar values.");
@@ -217,7 +207,7 @@ namespace SampleHive {
 
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto bar = config["Window"])
             {
@@ -242,11 +232,9 @@ namespace SampleHive {
 
     void cSerializer::SerializeSplitterSashPos(std::string key, int pos)
     {
-        YAML::Emitter out;
-
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto sash = config["Window"])
             {
@@ -256,10 +244,7 @@ namespace SampleHive {
                 if (key == "bottom")
                     sash["BottomSplitterSashPos"] = pos;
 
-                out << config;
-
-                std::ofstream ofstrm(static_cast<std::string>(CONFIG_FILEPATH));
-                ofstrm << out.c_str();
+                cConfigStore::Get().MarkDirty();
             }
             else
                 SH_LOG_ERROR("Error! Cannot store sash pos values.");
@@ -276,7 +261,7 @@ namespace SampleHive {
 
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto bar = config["Window"])
             {
@@ -301,11 +286,9 @@ namespace SampleHive {
 
     void cSerializer::SerializeMediaOptions(std::string key, bool value)
     {
-        YAML::Emitter out;
-
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto media = config["Media"])
             {
@@ -318,10 +301,7 @@ namespace SampleHive {
                 if (key == "muted")
                     media["Muted"] = value;
 
-                out << config;
-
-                std::ofstream ofstrm(static_cast<std::string>(CONFIG_FILEPATH));
-                ofstrm << out.c_str();
+                cConfigStore::Get().MarkDirty();
             }
             else
                 SH_LOG_ERROR("Error! Cannot store media values.");
@@ -338,7 +318,7 @@ namespace SampleHive {
 
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto media = config["Media"])
             {
@@ -366,20 +346,15 @@ namespace SampleHive {
 
     void cSerializer::SerializeMediaVolume(int volume)
     {
-        YAML::Emitter out;
-
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto media = config["Media"])
             {
                 media["Volume"] = volume;
 
-                out << config;
-
-                std::ofstream ofstrm(static_cast<std::string>(CONFIG_FILEPATH));
-                ofstrm << out.c_str();
+                cConfigStore::Get().MarkDirty();
             }
             else
                 SH_LOG_ERROR("Error! Cannot store volume values.");
@@ -396,7 +371,7 @@ namespace SampleHive {
 
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto media = config["Media"])
                 volume = media["Volume"].as<int>();
@@ -415,14 +390,12 @@ namespace SampleHive {
 
     void cSerializer::SerializeFontSettings(wxFont& font)
     {
-        YAML::Emitter out;
-
         std::string font_face = font.GetFaceName().ToStdString();
         int font_size = font.GetPointSize();
 
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             auto display = config["Display"];
 
@@ -431,10 +404,7 @@ namespace SampleHive {
                 fontSetting["Family"] = font_face;
                 fontSetting["Size"] = font_size;
 
-                out << config;
-
-                std::ofstream ofstrm(static_cast<std::string>(CONFIG_FILEPATH));
-                ofstrm << out.c_str();
+                cConfigStore::Get().MarkDirty();
             }
             else
             {
@@ -456,7 +426,7 @@ namespace SampleHive {
 
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             auto display = config["Display"];
 
@@ -483,13 +453,11 @@ namespace SampleHive {
 
     void cSerializer::SerializeWaveformColour(wxColour& colour)
     {
-        YAML::Emitter out;
-
         std::string colour_string = colour.GetAsString(wxC2S_HTML_SYNTAX).ToStdString();
 
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             auto display = config["Display"];
 
@@ -497,10 +465,7 @@ namespace SampleHive {
             {
                 waveform["Colour"] = colour_string;
 
-                out << config;
-
-                std::ofstream ofstrm(static_cast<std::string>(CONFIG_FILEPATH));
-                ofstrm << out.c_str();
+                cConfigStore::Get().MarkDirty();
             }
             else
             {
@@ -519,7 +484,7 @@ namespace SampleHive {
 
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             auto display = config["Display"];
 
@@ -542,11 +507,9 @@ namespace SampleHive {
 
     void cSerializer::SerializeShowSplash(bool value)
     {
-        YAML::Emitter out;
-
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             auto display = config["Display"];
 
@@ -554,10 +517,7 @@ namespace SampleHive {
             {
                 splash["ShowSplashOnStartup"] = value;
 
-                out << config;
-
-                std::ofstream ofstrm(static_cast<std::string>(CONFIG_FILEPATH));
-                ofstrm << out.c_str();
+                cConfigStore::Get().MarkDirty();
             }
             else
             {
@@ -576,7 +536,7 @@ namespace SampleHive {
 
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             auto display = config["Display"];
 
@@ -599,21 +559,16 @@ namespace SampleHive {
 
     void cSerializer::SerializeAutoImport(bool autoImport, const std::string& importDir)
     {
-        YAML::Emitter out;
-
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto autoImportInfo = config["Collection"])
             {
                 autoImportInfo["AutoImport"] = autoImport;
                 autoImportInfo["Directory"] = importDir;
 
-                out << config;
-
-                std::ofstream ofstrm(static_cast<std::string>(CONFIG_FILEPATH));
-                ofstrm << out.c_str();
+                cConfigStore::Get().MarkDirty();
             }
             else
             {
@@ -633,7 +588,7 @@ namespace SampleHive {
 
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto autoImportInfo = config["Collection"])
             {
@@ -655,20 +610,15 @@ namespace SampleHive {
 
     void cSerializer::SerializeFollowSymLink(bool followSymLinks)
     {
-        YAML::Emitter out;
-
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto followSymLinks = config["Collection"])
             {
                 followSymLinks["FollowSymLink"] = followSymLinks;
 
-                out << config;
-
-                std::ofstream ofstrm(static_cast<std::string>(CONFIG_FILEPATH));
-                ofstrm << out.c_str();
+                cConfigStore::Get().MarkDirty();
             }
             else
             {
@@ -687,7 +637,7 @@ namespace SampleHive {
 
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto followSymLinks = config["Collection"])
             {
@@ -708,20 +658,15 @@ namespace SampleHive {
 
     void cSerializer::SerializeRecursiveImport(bool recursiveImport)
     {
-        YAML::Emitter out;
-
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto recursive = config["Collection"])
             {
                 recursive["RecursiveImport"] = recursiveImport;
 
-                out << config;
-
-                std::ofstream ofstrm(static_cast<std::string>(CONFIG_FILEPATH));
-                ofstrm << out.c_str();
+                cConfigStore::Get().MarkDirty();
             }
             else
             {
@@ -740,7 +685,7 @@ namespace SampleHive {
 
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto recursive = config["Collection"])
             {
@@ -761,20 +706,15 @@ namespace SampleHive {
 
     void cSerializer::SerializeShowFileExtension(bool showExtension)
     {
-        YAML::Emitter out;
-
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto fileExtensionInfo = config["Collection"])
             {
                 fileExtensionInfo["ShowFileExtension"] = showExtension;
 
-                out << config;
-
-                std::ofstream ofstrm(static_cast<std::string>(CONFIG_FILEPATH));
-                ofstrm << out.c_str();
+                cConfigStore::Get().MarkDirty();
             }
             else
             {
@@ -793,7 +733,7 @@ namespace SampleHive {
 
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto fileExtensionInfo = config["Collection"])
             {
@@ -814,20 +754,15 @@ namespace SampleHive {
 
     void cSerializer::SerializeDoubleClickToPlay(bool enableDoubleClick)
     {
-        YAML::Emitter out;
-
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto doubleClickValue = config["Collection"])
             {
                 doubleClickValue["DoubleClickToPlay"] = enableDoubleClick;
 
-                out << config;
-
-                std::ofstream ofstrm(static_cast<std::string>(CONFIG_FILEPATH));
-                ofstrm << out.c_str();
+                cConfigStore::Get().MarkDirty();
             }
             else
             {
@@ -846,7 +781,7 @@ namespace SampleHive {
 
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto doubleClickValue = config["Collection"])
             {
@@ -867,20 +802,15 @@ namespace SampleHive {
 
     void cSerializer::SerializeDemoMode(bool showDemoMode)
     {
-        YAML::Emitter out;
-
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto general = config["General"])
             {
                 general["DemoMode"] = showDemoMode;
 
-                out << config;
-
-                std::ofstream ofstrm(static_cast<std::string>(CONFIG_FILEPATH));
-                ofstrm << out.c_str();
+                cConfigStore::Get().MarkDirty();
             }
             else
             {
@@ -899,7 +829,7 @@ namespace SampleHive {
 
         try
         {
-            YAML::Node config = YAML::LoadFile(static_cast<std::string>(CONFIG_FILEPATH));
+            YAML::Node config = cConfigStore::Get().GetConfig();
 
             if (auto general = config["General"])
             {
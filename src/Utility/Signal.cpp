@@ -76,12 +76,14 @@ namespace SampleHive {
             window.HandleWindowEvent(event);
     }
 
-    void cSignal::SendCallFunctionPlay(const wxString& selection, bool checkAutoplay, wxWindow& window, bool isDialog)
+    void cSignal::SendCallFunctionPlay(const wxString& selection, const wxString& path, bool checkAutoplay,
+                                       wxWindow& window, bool isDialog)
     {
         SampleHive::cCallFunctionEvent event(SampleHive::SH_EVT_CALL_FUNC_PLAY, window.GetId());
         event.SetEventObject(&window);
 
         event.SetSelection(selection);
+        event.SetPath(path);
         event.SetAutoplayValue(checkAutoplay);
 
         if (isDialog)
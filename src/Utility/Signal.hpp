@@ -36,7 +36,8 @@ namespace SampleHive {
             static void SendPushStatusBarStatus(const wxString& msg, int section, wxWindow& window, bool isDialog = false);
             static void SendSetStatusBarStatus(const wxString& msg, int section, wxWindow& window, bool isDialog = false);
             static void SendPopStatusBarStatus(int section, wxWindow& window, bool isDialog = false);
-            static void SendCallFunctionPlay(const wxString& selection, bool checkAutoplay, wxWindow& window, bool isDialog = false);
+            static void SendCallFunctionPlay(const wxString& selection, const wxString& path, bool checkAutoplay,
+                                             wxWindow& window, bool isDialog = false);
             static void SendTimerStopStatus(wxWindow& window, bool isDialog = false);
             static void SendLoopPoints(std::pair<double, double> loopPoint, wxWindow& window, bool isDialog = false);
             static void SendClearLoopPointsStatus(wxWindow& window, bool isDialog = false);
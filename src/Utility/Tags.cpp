@@ -86,7 +86,7 @@ namespace SampleHive {
             m_bValid = false;
         }
 
-        return { title, artist, album, genre, comment, channels, length, sample_rate, bitrate };
+        return { title, artist, album, genre, comment, channels, length, sample_rate, bitrate, m_bValid };
     }
 
     void cTags::SetTitle(std::string title)
@@ -28,19 +28,23 @@ namespace SampleHive {
 
     class cTags
     {
-        struct AudioInfo
-        {
-            wxString title;
-            wxString artist;
-            wxString album;
-            wxString genre;
-            wxString comment;
+        public:
+            struct AudioInfo
+            {
+                wxString title;
+                wxString artist;
+                wxString album;
+                wxString genre;
+                wxString comment;
+
+                int channels;
+                int length;
+                int sample_rate;
+                int bitrate;
 
-            int channels;
-            int length;
-            int sample_rate;
-            int bitrate;
-        };
+                // False when TagLib could not read the file
+                bool valid;
+            };
 
         public:
             cTags(const std::string& filepath);
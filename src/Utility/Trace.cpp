@@ -0,0 +1,122 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Utility/Trace.hpp"
+#include "Utility/Log.hpp"
+
+#include <fstream>
+
+#include <unistd.h>
+
+namespace SampleHive {
+
+    cTracer::cTracer()
+        : m_bEnabled(false), m_Epoch(std::chrono::steady_clock::now())
+    {
+    }
+
+    cTracer::~cTracer()
+    {
+        Stop();
+    }
+
+    void cTracer::Start(const std::string& filepath)
+    {
+        m_Filepath = filepath;
+        m_Epoch = std::chrono::steady_clock::now();
+        m_bEnabled.store(true);
+
+        SH_LOG_INFO("Tracing enabled, writing to {} on exit", m_Filepath);
+    }
+
+    void cTracer::Stop()
+    {
+        if (!m_bEnabled.exchange(false))
+            return;
+
+        std::ofstream out(m_Filepath, std::ios::out | std::ios::trunc);
+
+        if (!out)
+        {
+            SH_LOG_ERROR("Error! Cannot write trace to {}", m_Filepath);
+            return;
+        }
+
+        const int pid = static_cast<int>(getpid());
+        size_t count = 0;
+
+        out << "{\"traceEvents\":[";
+
+        std::lock_guard<std::mutex> buffers_lock(m_BuffersMutex);
+
+        for (const auto& buffer : m_Buffers)
+        {
+            std::lock_guard<std::mutex> lock(buffer->Mutex);
+
+            for (const auto& span : buffer->Spans)
+            {
+                out << (count++ ? ",\n" : "\n")
+                    << "{\"name\":\"" << span.Name << "\",\"cat\":\"SampleHive\",\"ph\":\"X\""
+                    << ",\"ts\":" << span.Begin << ",\"dur\":" << span.Duration
+                    << ",\"pid\":" << pid << ",\"tid\":" << buffer->ThreadId << '}';
+            }
+
+            buffer->Spans.clear();
+        }
+
+        out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+        SH_LOG_INFO("Wrote {} trace spans to {}", count, m_Filepath);
+    }
+
+    void cTracer::AddSpan(const char* name, std::chrono::steady_clock::time_point begin,
+                          std::chrono::steady_clock::time_point end)
+    {
+        using std::chrono::duration_cast;
+        using std::chrono::microseconds;
+
+        ThreadBuffer& buffer = GetThreadBuffer();
+
+        std::lock_guard<std::mutex> lock(buffer.Mutex);
+        buffer.Spans.push_back({ name,
+                                 duration_cast<microseconds>(begin - m_Epoch).count(),
+                                 duration_cast<microseconds>(end - begin).count() });
+    }
+
+    cTracer::ThreadBuffer& cTracer::GetThreadBuffer()
+    {
+        thread_local ThreadBuffer* s_pBuffer = nullptr;
+
+        if (!s_pBuffer)
+        {
+            auto buffer = std::make_shared<ThreadBuffer>();
+            buffer->Spans.reserve(1024);
+
+            std::lock_guard<std::mutex> lock(m_BuffersMutex);
+            buffer->ThreadId = static_cast<uint32_t>(m_Buffers.size()) + 1;
+            m_Buffers.push_back(buffer);
+
+            s_pBuffer = buffer.get();
+        }
+
+        return *s_pBuffer;
+    }
+
+}
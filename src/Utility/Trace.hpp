@@ -0,0 +1,130 @@
+/* SampleHive
+ * Copyright (C) 2021  Apoorv Singh
+ * A simple, modern audio sample browser/manager for GNU/Linux.
+ *
+ * This file is a part of SampleHive
+ *
+ * SampleHive is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * SampleHive is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace SampleHive {
+
+    // Records named spans per thread and writes them out as Chrome Trace
+    // Event JSON, open the file in chrome://tracing or ui.perfetto.dev.
+    // While disabled a span costs one relaxed atomic load.
+    class cTracer
+    {
+        private:
+            cTracer();
+
+        public:
+            ~cTracer();
+
+        public:
+            cTracer(const cTracer&) = delete;
+            cTracer& operator=(const cTracer&) = delete;
+
+        public:
+            static cTracer& Get()
+            {
+                static cTracer s_Tracer;
+                return s_Tracer;
+            }
+
+        public:
+            // -------------------------------------------------------------------
+            // Spans are kept in memory until Stop() writes them to this file
+            void Start(const std::string& filepath);
+            void Stop();
+
+            inline bool IsEnabled() const { return m_bEnabled.load(std::memory_order_relaxed); }
+
+            // -------------------------------------------------------------------
+            // Name must outlive the tracer, in practice a string literal
+            void AddSpan(const char* name, std::chrono::steady_clock::time_point begin,
+                         std::chrono::steady_clock::time_point end);
+
+        private:
+            // -------------------------------------------------------------------
+            struct Span
+            {
+                const char* Name;
+                int64_t Begin;
+                int64_t Duration;
+            };
+
+            // Only its own thread appends, the lock is there for Stop()
+            struct ThreadBuffer
+            {
+                std::mutex Mutex;
+                std::vector<Span> Spans;
+                uint32_t ThreadId;
+            };
+
+            ThreadBuffer& GetThreadBuffer();
+
+        private:
+            // -------------------------------------------------------------------
+            std::atomic<bool> m_bEnabled;
+
+            std::string m_Filepath;
+            std::chrono::steady_clock::time_point m_Epoch;
+
+            // Buffers outlive their threads so short lived workers still show up
+            std::mutex m_BuffersMutex;
+            std::vector<std::shared_ptr<ThreadBuffer>> m_Buffers;
+    };
+
+    // Adds a span for the lifetime of the enclosing scope
+    class cTraceScope
+    {
+        public:
+            explicit cTraceScope(const char* name)
+                : m_Name(cTracer::Get().IsEnabled() ? name : nullptr)
+            {
+                if (m_Name)
+                    m_Begin = std::chrono::steady_clock::now();
+            }
+
+            ~cTraceScope()
+            {
+                if (m_Name)
+                    cTracer::Get().AddSpan(m_Name, m_Begin, std::chrono::steady_clock::now());
+            }
+
+        public:
+            cTraceScope(const cTraceScope&) = delete;
+            cTraceScope& operator=(const cTraceScope&) = delete;
+
+        private:
+            const char* m_Name;
+            std::chrono::steady_clock::time_point m_Begin;
+    };
+
+    #define SH_TRACE_CONCAT_IMPL(a, b) a##b
+    #define SH_TRACE_CONCAT(a, b) SH_TRACE_CONCAT_IMPL(a, b)
+
+    #define SH_TRACE_SCOPE(name) ::SampleHive::cTraceScope SH_TRACE_CONCAT(sh_trace_scope_, __LINE__)(name)
+
+}
@@ -22,7 +22,9 @@
 #include "wx/string.h"
 #include "wx/window.h"
 
-#include <unordered_map>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace SampleHive {
 
@@ -30,11 +32,12 @@ namespace SampleHive {
     {
         private:
             cUtils() = default;
+            ~cUtils();
 
         public:
             // -------------------------------------------------------------------
             cUtils(const cUtils&) = delete;
-            cUtils& operator=(const cUtils) = delete;
+            cUtils& operator=(const cUtils&) = delete;
 
         public:
             // -------------------------------------------------------------------
@@ -46,17 +49,6 @@ namespace SampleHive {
 
         public:
             // -------------------------------------------------------------------
-            struct FileInfo
-            {
-                wxString Path;
-                std::string Extension;
-                std::string Filename;
-            };
-
-            // -------------------------------------------------------------------
-            cUtils::FileInfo GetFilenamePathAndExtension(const wxString& selected,
-                                                         bool checkExtension = true,
-                                                         bool doGetFilename = true);
             void AddSamples(wxArrayString& files, wxWindow* parent);
             void OnAutoImportDir(const wxString& pathToDirectory, wxWindow* parent);
             wxString CalculateAndGetISOStandardTime(wxLongLong length);
@@ -64,13 +56,12 @@ namespace SampleHive {
 
             float GetBPM(const std::string& path);
 
-        private:
-            // -------------------------------------------------------------------
-            std::string GetSamplePath(const wxString& name);
+            // Held while aubio objects are created or destroyed
+            std::mutex& GetAubioMutex() { return m_AubioMutex; }
 
         private:
             // -------------------------------------------------------------------
-            std::unordered_map<std::string, std::string> m_PathCache;
+            std::mutex m_AubioMutex;
     };
 
 }